@@ -1,5 +1,10 @@
+// Airplane Takeoff Scene
+// Compilation: g++ -o airplane airplane.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/airplane.so airplane.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
@@ -21,80 +26,79 @@ struct Cloud {
     int size;
 };
 
-int main() {
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class AirplaneScene : public Scene {
+private:
     // Colors
-    Color sky_blue(100, 180, 255);
-    Color sky_horizon(180, 220, 255);
-    Color runway_gray(80, 80, 80);
-    Color runway_lines(220, 220, 220);
-    Color plane_white(240, 240, 240);
-    Color plane_dark(150, 150, 150);
-    Color plane_red(220, 50, 50);
-    Color plane_blue(50, 100, 200);
-    Color cloud_white(255, 255, 255);
-    Color sun_yellow(255, 220, 100);
-    Color grass_green(80, 150, 60);
+    Color sky_blue = Color(100, 180, 255);
+    Color sky_horizon = Color(180, 220, 255);
+    Color runway_gray = Color(80, 80, 80);
+    Color runway_lines = Color(220, 220, 220);
+    Color plane_white = Color(240, 240, 240);
+    Color plane_dark = Color(150, 150, 150);
+    Color plane_red = Color(220, 50, 50);
+    Color plane_blue = Color(50, 100, 200);
+    Color cloud_white = Color(255, 255, 255);
+    Color sun_yellow = Color(255, 220, 100);
+    Color grass_green = Color(80, 150, 60);
     
     // Plane state
-    float plane_x = 5.0f;
-    float plane_y = 24.0f;
-    float plane_angle = 0.0f;  // 0 = level, positive = nose up
-    FlightPhase phase = TAXIING;
+    float plane_x;
+    float plane_y;
+    float plane_angle;  // 0 = level, positive = nose up
+    FlightPhase phase;
     
     // Clouds
     Cloud clouds[4];
-    clouds[0] = {10, 8, 3};
-    clouds[1] = {24, 12, 2};
-    clouds[2] = {5, 15, 3};
-    clouds[3] = {20, 6, 2};
     
-    int frame_count = 0;
-    int phase_timer = 0;
+    int frame_count;
+    int phase_timer;
     
-    // Display continuously
-    while (true) {
-        // Draw gradient sky
-        for (int y = 0; y < 32; ++y) {
-            float t = y / 32.0f;
-            int r = (int)(sky_blue.r + (sky_horizon.r - sky_blue.r) * t);
-            int g = (int)(sky_blue.g + (sky_horizon.g - sky_blue.g) * t);
-            int b = (int)(sky_blue.b + (sky_horizon.b - sky_blue.b) * t);
-            
-            for (int x = 0; x < 32; ++x) {
-                canvas->SetPixel(x, y, r, g, b);
+    // Sky and airfield never change; draw them once and copy them per frame
+    CachedLayer sky;
+    CachedLayer airfield;
+    
+public:
+    AirplaneScene() : plane_x(5.0f), plane_y(24.0f), plane_angle(0.0f), phase(TAXIING),
+                    frame_count(0), phase_timer(0) {}
+    
+    void Init(int w, int h) {
+        // Clouds
+        clouds[0] = {10, 8, 3};
+        clouds[1] = {24, 12, 2};
+        clouds[2] = {5, 15, 3};
+        clouds[3] = {20, 6, 2};
+    }
+    
+    void Render(Canvas *canvas) {
+        if (sky.needsRedraw(32, 32)) {
+            // Draw gradient sky
+            for (int y = 0; y < 32; ++y) {
+                float t = y / 32.0f;
+                int r = (int)(sky_blue.r + (sky_horizon.r - sky_blue.r) * t);
+                int g = (int)(sky_blue.g + (sky_horizon.g - sky_blue.g) * t);
+                int b = (int)(sky_blue.b + (sky_horizon.b - sky_blue.b) * t);
+                
+                for (int x = 0; x < 32; ++x) {
+                    sky.SetPixel(x, y, r, g, b);
+                }
             }
-        }
-        
-        // Draw sun
-        int sun_x = 26;
-        int sun_y = 5;
-        for (int dy = -2; dy <= 2; ++dy) {
-            for (int dx = -2; dx <= 2; ++dx) {
-                if (dx*dx + dy*dy <= 4) {
-                    int px = sun_x + dx;
-                    int py = sun_y + dy;
-                    if (px >= 0 && px < 32 && py >= 0 && py < 32) {
-                        canvas->SetPixel(px, py, sun_yellow.r, sun_yellow.g, sun_yellow.b);
+            
+            // Draw sun
+            int sun_x = 26;
+            int sun_y = 5;
+            for (int dy = -2; dy <= 2; ++dy) {
+                for (int dx = -2; dx <= 2; ++dx) {
+                    if (dx*dx + dy*dy <= 4) {
+                        int px = sun_x + dx;
+                        int py = sun_y + dy;
+                        if (px >= 0 && px < 32 && py >= 0 && py < 32) {
+                            sky.SetPixel(px, py, sun_yellow.r, sun_yellow.g, sun_yellow.b);
+                        }
                     }
                 }
             }
         }
+        sky.blit(canvas);
         
         // Update plane based on phase
         phase_timer++;
@@ -183,25 +187,28 @@ int main() {
         
         // Draw runway when plane is low
         if (plane_y > 20.0f) {
-            // Grass
-            for (int y = 26; y < 32; ++y) {
-                for (int x = 0; x < 32; ++x) {
-                    canvas->SetPixel(x, y, grass_green.r, grass_green.g, grass_green.b);
+            if (airfield.needsRedraw(32, 32)) {
+                // Grass
+                for (int y = 26; y < 32; ++y) {
+                    for (int x = 0; x < 32; ++x) {
+                        airfield.SetPixel(x, y, grass_green.r, grass_green.g, grass_green.b);
+                    }
                 }
-            }
-            
-            // Runway
-            for (int y = 24; y < 26; ++y) {
-                for (int x = 0; x < 32; ++x) {
-                    canvas->SetPixel(x, y, runway_gray.r, runway_gray.g, runway_gray.b);
+                
+                // Runway
+                for (int y = 24; y < 26; ++y) {
+                    for (int x = 0; x < 32; ++x) {
+                        airfield.SetPixel(x, y, runway_gray.r, runway_gray.g, runway_gray.b);
+                    }
+                }
+                
+                // Center line
+                for (int x = 0; x < 32; x += 4) {
+                    airfield.SetPixel(x, 24, runway_lines.r, runway_lines.g, runway_lines.b);
+                    airfield.SetPixel(x + 1, 24, runway_lines.r, runway_lines.g, runway_lines.b);
                 }
             }
-            
-            // Center line
-            for (int x = 0; x < 32; x += 4) {
-                canvas->SetPixel(x, 24, runway_lines.r, runway_lines.g, runway_lines.b);
-                canvas->SetPixel(x + 1, 24, runway_lines.r, runway_lines.g, runway_lines.b);
-            }
+            airfield.blit(canvas);
         }
         
         // Draw clouds (move slowly)
@@ -345,10 +352,7 @@ int main() {
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(AirplaneScene)
@@ -1,22 +1,19 @@
 // April Showers Scene
-// Compilation: g++ -o aprilshowers aprilshowers.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o aprilshowers aprilshowers.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/aprilshowers.so aprilshowers.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Raindrop {
     float x;
     float y;
@@ -54,10 +51,9 @@ struct Umbrella {
     float bob_phase;
 };
 
-class AprilShowersScene {
+class AprilShowersScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Raindrop> raindrops;
     std::vector<Cloud> clouds;
@@ -66,6 +62,7 @@ private:
     std::vector<Umbrella> umbrellas;
     float time_counter;
     int thunder_cooldown;
+    SceneRandom rng;
     
     // Colors
     Color sky_dark = Color(40, 50, 70);
@@ -89,32 +86,33 @@ private:
     Color umbrella_green = Color(40, 120, 40);
     
 public:
-    AprilShowersScene(RGBMatrix *m) : matrix(m), time_counter(0), thunder_cooldown(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    AprilShowersScene() : canvas(NULL), width(0), height(0), time_counter(0), thunder_cooldown(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "aprilshowers");
         
         // Create rain
         for (int i = 0; i < 40; i++) {
             Raindrop r;
-            r.x = rand() % width;
-            r.y = rand() % height;
-            r.speed = 1.0 + (float)rand() / RAND_MAX * 1.5;
-            r.length = 1 + rand() % 3;
-            r.brightness = 80 + rand() % 60;
+            r.x = rng.below(width);
+            r.y = rng.below(height);
+            r.speed = 1.0 + rng.uniform() * 1.5;
+            r.length = 1 + rng.below(3);
+            r.brightness = 80 + rng.below(60);
             raindrops.push_back(r);
         }
         
         // Create clouds
         for (int i = 0; i < 4; i++) {
             Cloud c;
-            c.x = rand() % width;
-            c.y = 2 + rand() % 6;
-            c.size = 4 + rand() % 4;
-            c.speed = 0.05 + (float)rand() / RAND_MAX * 0.1;
-            c.darkness = 50 + rand() % 30;
+            c.x = rng.below(width);
+            c.y = 2 + rng.below(6);
+            c.size = 4 + rng.below(4);
+            c.speed = 0.05 + rng.uniform() * 0.1;
+            c.darkness = 50 + rng.below(30);
             clouds.push_back(c);
         }
         
@@ -122,10 +120,10 @@ public:
         int ground_y = height - 4;
         for (int i = 0; i < 3; i++) {
             Puddle p;
-            p.x = 5 + (i * width / 3) + (rand() % 5);
+            p.x = 5 + (i * width / 3) + rng.below(5);
             p.y = ground_y;
-            p.size = 3 + rand() % 3;
-            p.ripple_phase = rand() % 20;
+            p.size = 3 + rng.below(3);
+            p.ripple_phase = rng.below(20);
             puddles.push_back(p);
         }
         
@@ -135,8 +133,8 @@ public:
                 Umbrella u;
                 u.x = 8 + i * (width - 16);
                 u.y = height - 8;
-                u.color_type = rand() % 4;
-                u.bob_phase = (float)rand() / RAND_MAX * 2 * M_PI;
+                u.color_type = rng.below(4);
+                u.bob_phase = rng.uniform() * 2 * M_PI;
                 umbrellas.push_back(u);
             }
         }
@@ -197,7 +195,7 @@ public:
             cloud.x += cloud.speed;
             if (cloud.x > width + cloud.size) {
                 cloud.x = -cloud.size;
-                cloud.y = 2 + rand() % 6;
+                cloud.y = 2 + rng.below(6);
             }
         }
     }
@@ -232,7 +230,7 @@ public:
                 
                 // Reset raindrop
                 drop.y = -drop.length;
-                drop.x = rand() % width;
+                drop.x = rng.below(width);
             }
         }
     }
@@ -325,14 +323,14 @@ public:
     void updateLightning() {
         // Random lightning
         thunder_cooldown--;
-        if (thunder_cooldown <= 0 && rand() % 200 == 0) {
+        if (thunder_cooldown <= 0 && rng.below(200) == 0) {
             Lightning l;
-            l.x = 5 + rand() % (width - 10);
-            l.segments = 3 + rand() % 5;
+            l.x = 5 + rng.below(width - 10);
+            l.segments = 3 + rng.below(5);
             l.life = 3;
-            l.brightness = 200 + rand() % 55;
+            l.brightness = 200 + rng.below(55);
             lightning.push_back(l);
-            thunder_cooldown = 100 + rand() % 200;
+            thunder_cooldown = 100 + rng.below(200);
         }
         
         // Draw and update lightning
@@ -343,7 +341,7 @@ public:
                 
                 // Draw jagged lightning bolt
                 for (int seg = 0; seg < it->segments; seg++) {
-                    int offset = (rand() % 3) - 1;
+                    int offset = rng.below(3) - 1;
                     lx += offset;
                     ly += 3;
                     
@@ -380,7 +378,7 @@ public:
         // Small spring plants/flowers trying to grow despite the rain
         int ground_y = height * 0.7;
         for (int x = 3; x < width; x += 8) {
-            int bud_x = x + (rand() % 3);
+            int bud_x = x + rng.below(3);
             int bud_y = ground_y;
             
             if (bud_x < width && bud_y < height) {
@@ -398,7 +396,8 @@ public:
         }
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -410,47 +409,8 @@ public:
         drawRain();
         updateLightning();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    AprilShowersScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(AprilShowersScene)
@@ -1,22 +1,20 @@
 // Arcade Game Scene - Space Invaders Style
-// Compilation: g++ -o arcade arcade.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o arcade arcade.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/arcade.so arcade.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Invader {
     int x;
     int y;
@@ -25,20 +23,6 @@ struct Invader {
     int animation_frame;
 };
 
-struct Bullet {
-    float x;
-    float y;
-    float vy;
-    bool is_player; // true = player bullet, false = enemy bullet
-};
-
-struct Explosion {
-    int x;
-    int y;
-    int life;
-    int max_life;
-};
-
 struct Star {
     int x;
     int y;
@@ -53,14 +37,13 @@ struct Player {
     int direction; // -1 left, 0 stop, 1 right
 };
 
-class ArcadeScene {
+class ArcadeScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Invader> invaders;
-    std::vector<Bullet> bullets;
-    std::vector<Explosion> explosions;
+    ParticlePool bullets;     // kind: 1 = player bullet, 0 = enemy bullet
+    ParticlePool explosions;
     std::vector<Star> stars;
     Player player;
     float time_counter;
@@ -68,6 +51,7 @@ private:
     int invader_drop_counter;
     int score;
     int frame_counter;
+    SceneRandom rng;
     
     // Colors
     Color space_black = Color(5, 5, 15);
@@ -82,13 +66,15 @@ private:
     Color star_white = Color(200, 200, 220);
     
 public:
-    ArcadeScene(RGBMatrix *m) : matrix(m), time_counter(0), invader_direction(1), 
-                                 invader_drop_counter(0), score(0), frame_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    ArcadeScene() : canvas(NULL), width(0), height(0), bullets(64), explosions(32),
+                    time_counter(0), invader_direction(1),
+                    invader_drop_counter(0), score(0), frame_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "arcade");
         
         // Create invader formation
         int start_x = 8;
@@ -114,10 +100,10 @@ public:
         // Create starfield
         for (int i = 0; i < 30; i++) {
             Star s;
-            s.x = rand() % width;
-            s.y = rand() % height;
-            s.brightness = 100 + rand() % 155;
-            s.twinkle_phase = (float)rand() / RAND_MAX * 2 * M_PI;
+            s.x = rng.below(width);
+            s.y = rng.below(height);
+            s.brightness = 100 + rng.below(155);
+            s.twinkle_phase = rng.uniform() * 2 * M_PI;
             stars.push_back(s);
         }
     }
@@ -276,7 +262,7 @@ public:
         }
         
         // Invaders shoot randomly
-        if (frame_counter % 60 == 0 && rand() % 3 == 0) {
+        if (frame_counter % 60 == 0 && rng.below(3) == 0) {
             // Pick a random alive invader
             std::vector<int> alive_indices;
             for (size_t i = 0; i < invaders.size(); i++) {
@@ -286,13 +272,9 @@ public:
             }
             
             if (!alive_indices.empty()) {
-                int idx = alive_indices[rand() % alive_indices.size()];
-                Bullet b;
-                b.x = invaders[idx].x + 1;
-                b.y = invaders[idx].y + 3;
-                b.vy = 0.5;
-                b.is_player = false;
-                bullets.push_back(b);
+                int idx = alive_indices[rng.below(alive_indices.size())];
+                // Bullets never age; they fly until they hit or leave
+                bullets.spawn(invaders[idx].x + 1, invaders[idx].y + 3, 0, 0.5, 1, bullet_red);
             }
         }
     }
@@ -300,7 +282,7 @@ public:
     void updatePlayer() {
         // Auto-move player
         if (frame_counter % 40 == 0) {
-            player.direction = (rand() % 3) - 1; // -1, 0, or 1
+            player.direction = rng.below(3) - 1; // -1, 0, or 1
         }
         
         player.x += player.direction;
@@ -313,38 +295,31 @@ public:
         
         // Player shoots periodically
         if (frame_counter % 45 == 0) {
-            Bullet b;
-            b.x = player.x;
-            b.y = player.y - 2;
-            b.vy = -1.0;
-            b.is_player = true;
-            bullets.push_back(b);
+            int b = bullets.spawn(player.x, player.y - 2, 0, -1.0, 1, bullet_yellow);
+            if (b >= 0) bullets.kind[b] = 1;
         }
     }
     
     void updateBullets() {
-        for (auto it = bullets.begin(); it != bullets.end();) {
-            it->y += it->vy;
+        bullets.integrate(1);
+        for (int i = 0; i < bullets.count();) {
+            bool is_player = bullets.kind[i];
             
             // Draw bullet
-            int bx = (int)it->x;
-            int by = (int)it->y;
+            int bx = (int)bullets.x[i];
+            int by = (int)bullets.y[i];
             
             if (by >= 0 && by < height && bx >= 0 && bx < width) {
-                if (it->is_player) {
-                    canvas->SetPixel(bx, by, bullet_yellow.r, bullet_yellow.g, bullet_yellow.b);
-                    if (by - 1 >= 0) {
-                        canvas->SetPixel(bx, by - 1, bullet_yellow.r * 0.7, bullet_yellow.g * 0.7, bullet_yellow.b * 0.7);
-                    }
-                } else {
-                    canvas->SetPixel(bx, by, bullet_red.r, bullet_red.g, bullet_red.b);
+                canvas->SetPixel(bx, by, bullets.r[i], bullets.g[i], bullets.b[i]);
+                if (is_player && by - 1 >= 0) {
+                    canvas->SetPixel(bx, by - 1, bullets.r[i] * 0.7, bullets.g[i] * 0.7, bullets.b[i] * 0.7);
                 }
             }
             
             // Check collisions
             bool hit = false;
             
-            if (it->is_player) {
+            if (is_player) {
                 // Check player bullet vs invaders
                 for (auto& inv : invaders) {
                     if (inv.alive && bx >= inv.x && bx <= inv.x + 3 && by >= inv.y && by <= inv.y + 2) {
@@ -353,60 +328,40 @@ public:
                         score += 10;
                         
                         // Create explosion
-                        Explosion ex;
-                        ex.x = inv.x;
-                        ex.y = inv.y;
-                        ex.life = 0;
-                        ex.max_life = 10;
-                        explosions.push_back(ex);
+                        explosions.spawn(inv.x, inv.y, 0, 0, 10, explosion_yellow);
                         break;
                     }
                 }
             }
             
             // Remove if off screen or hit
-            if (it->y < -2 || it->y > height + 2 || hit) {
-                it = bullets.erase(it);
+            if (bullets.y[i] < -2 || bullets.y[i] > height + 2 || hit) {
+                bullets.kill(i);
             } else {
-                ++it;
+                ++i;
             }
         }
     }
     
     void updateExplosions() {
-        for (auto it = explosions.begin(); it != explosions.end();) {
-            it->life++;
+        explosions.age(1);
+        for (int i = 0; i < explosions.count(); i++) {
+            int life = explosions.life[i];
+            float fade = explosions.fade(i);
             
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                
-                // Expanding explosion
-                int radius = 1 + it->life / 3;
-                for (int dy = -radius; dy <= radius; dy++) {
-                    for (int dx = -radius; dx <= radius; dx++) {
-                        if (dx*dx + dy*dy <= radius*radius) {
-                            int px = it->x + dx;
-                            int py = it->y + dy;
-                            if (px >= 0 && px < width && py >= 0 && py < height) {
-                                if (it->life < it->max_life / 2) {
-                                    canvas->SetPixel(px, py, 
-                                                   explosion_yellow.r * fade,
-                                                   explosion_yellow.g * fade,
-                                                   explosion_yellow.b * fade);
-                                } else {
-                                    canvas->SetPixel(px, py,
-                                                   explosion_orange.r * fade,
-                                                   explosion_orange.g * fade,
-                                                   explosion_orange.b * fade);
-                                }
-                            }
+            // Expanding explosion, yellow at first and orange as it fades
+            Color color = (life < explosions.max_life[i] / 2) ? explosion_yellow : explosion_orange;
+            int radius = 1 + life / 3;
+            for (int dy = -radius; dy <= radius; dy++) {
+                for (int dx = -radius; dx <= radius; dx++) {
+                    if (dx*dx + dy*dy <= radius*radius) {
+                        int px = explosions.x[i] + dx;
+                        int py = explosions.y[i] + dy;
+                        if (px >= 0 && px < width && py >= 0 && py < height) {
+                            canvas->SetPixel(px, py, color.r * fade, color.g * fade, color.b * fade);
                         }
                     }
                 }
-                
-                ++it;
-            } else {
-                it = explosions.erase(it);
             }
         }
     }
@@ -419,7 +374,8 @@ public:
         }
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawBackground();
@@ -429,47 +385,8 @@ public:
         updateExplosions();
         drawScore();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    ArcadeScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(ArcadeScene)
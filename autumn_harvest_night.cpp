@@ -1,32 +1,28 @@
 // Autumn Harvest Night Scene (Animated)
-// Compilation: g++ -o autumn_harvest_night autumn_harvest_night.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -lrgbmatrix -lpthread -lm
+// Compilation: g++ -o autumn_harvest_night autumn_harvest_night.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -L. -lrgbscene -lrgbmatrix -lpthread -lm
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/autumn_harvest_night.so autumn_harvest_night.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Firefly {
     int x;
     int y;
     bool active;
 };
 
-class AutumnHarvestNight {
+class AutumnHarvestNight : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     int frame_count;
 
@@ -38,17 +34,19 @@ private:
     Color moon_white = Color(255, 240, 200);   // Soft white moon
     Color text_orange = Color(255, 100, 0);    // Orange for "Harvest 2025" text
     std::vector<Firefly> fireflies;
+    SceneRandom rng;
 
 public:
-    AutumnHarvestNight(RGBMatrix *m) : matrix(m), frame_count(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    AutumnHarvestNight() : canvas(NULL), width(0), height(0), frame_count(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
 
         // Initialize fireflies
-        srand(time(NULL));
+        rng.seed(Seed(), "autumn_harvest_night");
         for (int i = 0; i < 10; i++) {
-            fireflies.push_back({rand() % (width - 2) + 1, rand() % (height / 2) + 1, true});
+            fireflies.push_back({rng.below(width - 2) + 1, rng.below(height / 2) + 1, true});
         }
     }
 
@@ -111,15 +109,15 @@ public:
     void drawFireflies() {
         // Animated fireflies with random blinking
         for (auto& fly : fireflies) {
-            if (fly.active && rand() % 10 < 8) { // 80% chance to show
+            if (fly.active && rng.below(10) < 8) { // 80% chance to show
                 canvas->SetPixel(fly.x, fly.y, firefly_yellow.r, firefly_yellow.g, firefly_yellow.b);
             }
             // Small random movement
             if (frame_count % 20 == 0) {
-                fly.x += (rand() % 3) - 1;
-                fly.y += (rand() % 3) - 1;
-                if (fly.x < 1 || fly.x >= width - 1) fly.x = rand() % (width - 2) + 1;
-                if (fly.y < 1 || fly.y >= height / 2) fly.y = rand() % (height / 2) + 1;
+                fly.x += rng.below(3) - 1;
+                fly.y += rng.below(3) - 1;
+                if (fly.x < 1 || fly.x >= width - 1) fly.x = rng.below(width - 2) + 1;
+                if (fly.y < 1 || fly.y >= height / 2) fly.y = rng.below(height / 2) + 1;
             }
         }
     }
@@ -205,7 +203,10 @@ public:
         canvas->SetPixel(text_x + 31, text_y + 2, text_orange.r, text_orange.g, text_orange.b);
     }
 
-    void draw() {
+    float DefaultFps() const { return 10.0f; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -215,42 +216,7 @@ public:
         drawFireflies();
         drawText();
         
-        frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-    }
+        frame_count++;    }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    AutumnHarvestNight scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.draw();
-        usleep(100000); // ~10 fps for smooth animation
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(AutumnHarvestNight)
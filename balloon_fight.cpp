@@ -1,17 +1,17 @@
+// Balloon Fight Scene
+// Compilation: g++ -o balloon_fight balloon_fight.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/balloon_fight.so balloon_fight.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Enemy {
     float x;
     float y;
@@ -20,72 +20,60 @@ struct Enemy {
     bool active;
 };
 
-int main() {
-    srand(time(NULL));
-    
-    // Set up signal handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class BalloonFightScene : public Scene {
+private:
     // Colors
-    Color bg_black(0, 0, 0);
-    Color star_white(255, 255, 255);
-    Color balloon_green(100, 255, 100);
-    Color balloon_shadow(50, 150, 50);
-    Color player_red(255, 80, 80);
-    Color player_blue(80, 120, 255);
-    Color player_skin(255, 200, 150);
-    Color enemy_white(255, 255, 255);
-    Color enemy_orange(255, 150, 80);
-    Color water_blue(80, 160, 255);
-    Color water_light(120, 200, 255);
+    Color bg_black = Color(0, 0, 0);
+    Color star_white = Color(255, 255, 255);
+    Color balloon_green = Color(100, 255, 100);
+    Color balloon_shadow = Color(50, 150, 50);
+    Color player_red = Color(255, 80, 80);
+    Color player_blue = Color(80, 120, 255);
+    Color player_skin = Color(255, 200, 150);
+    Color enemy_white = Color(255, 255, 255);
+    Color enemy_orange = Color(255, 150, 80);
+    Color water_blue = Color(80, 160, 255);
+    Color water_light = Color(120, 200, 255);
     
     // Player position
-    float player_x = 16.0f;
-    float player_y = 20.0f;
-    float player_vy = 0.0f;
-    bool flapping = false;
-    int flap_timer = 0;
+    float player_x;
+    float player_y;
+    float player_vy;
+    bool flapping;
+    int flap_timer;
     
     // Enemies
-    const int num_enemies = 4;
+    static const int num_enemies = 4;
     Enemy enemies[num_enemies];
-    for (int i = 0; i < num_enemies; ++i) {
-        enemies[i].x = rand() % 26 + 3;
-        enemies[i].y = rand() % 12 + 4;
-        enemies[i].vx = (rand() % 2 == 0 ? 1 : -1) * 0.15f;
-        enemies[i].vy = 0.05f;
-        enemies[i].active = true;
-    }
     
     // Stars (background)
     int star_x[20];
     int star_y[20];
-    for (int i = 0; i < 20; ++i) {
-        star_x[i] = rand() % 32;
-        star_y[i] = rand() % 26;
-    }
     
-    int frame_count = 0;
+    int frame_count;
+    SceneRandom rng;
+    
+public:
+    BalloonFightScene() : player_x(16.0f), player_y(20.0f), player_vy(0.0f), flapping(false),
+                        flap_timer(0), frame_count(0) {}
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "balloon_fight");
     
-    // Display continuously
-    while (!interrupt_received) {
+        for (int i = 0; i < num_enemies; ++i) {
+            enemies[i].x = rng.below(26) + 3;
+            enemies[i].y = rng.below(12) + 4;
+            enemies[i].vx = (rng.below(2) == 0 ? 1 : -1) * 0.15f;
+            enemies[i].vy = 0.05f;
+            enemies[i].active = true;
+        }
+        for (int i = 0; i < 20; ++i) {
+            star_x[i] = rng.below(32);
+            star_y[i] = rng.below(26);
+        }
+    }
+    
+    void Render(Canvas *canvas) {
         // Clear with black background
         canvas->Fill(bg_black.r, bg_black.g, bg_black.b);
         
@@ -215,13 +203,7 @@ int main() {
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    // Clean up on exit
-    canvas->Clear();
-    canvas = matrix->SwapOnVSync(canvas);
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(BalloonFightScene)
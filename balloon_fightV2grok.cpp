@@ -1,30 +1,18 @@
+// Balloon Fight Scene (V2)
+// Compilation: g++ -o balloon_fightV2grok balloon_fightV2grok.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/balloon_fightV2grok.so balloon_fightV2grok.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-RGBMatrix* global_matrix = nullptr;
-FrameCanvas* global_canvas = nullptr;
-
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-    if (global_canvas) {
-        global_canvas->Clear();
-        global_canvas = global_matrix->SwapOnVSync(global_canvas);
-    }
-    if (global_matrix) {
-        delete global_matrix;
-        global_matrix = nullptr;
-    }
-    exit(0); // Ensure clean exit
-}
-
 struct Enemy {
     float x;
     float y;
@@ -34,7 +22,7 @@ struct Enemy {
     Color balloon_color;
 };
 
-void drawBalloon(FrameCanvas* canvas, int x, int y, const Color& main_color, const Color& shadow_color, bool inflate) {
+void drawBalloon(Canvas* canvas, int x, int y, const Color& main_color, const Color& shadow_color, bool inflate) {
     canvas->SetPixel(x - 1, y - (inflate ? 4 : 3), main_color.r, main_color.g, main_color.b);
     canvas->SetPixel(x - 1, y - (inflate ? 5 : 4), main_color.r, main_color.g, main_color.b);
     canvas->SetPixel(x + 1, y - (inflate ? 4 : 3), main_color.r, main_color.g, main_color.b);
@@ -44,7 +32,7 @@ void drawBalloon(FrameCanvas* canvas, int x, int y, const Color& main_color, con
     canvas->SetPixel(x, y - (inflate ? 2 : 1), 255, 255, 255); // String
 }
 
-void drawPlayer(FrameCanvas* canvas, float x, float y, float vy, bool flapping) {
+void drawPlayer(Canvas* canvas, float x, float y, float vy, bool flapping) {
     int px = (int)x;
     int py = (int)y;
     bool inflate = vy < 0; // Balloon inflates when moving up
@@ -75,7 +63,7 @@ void drawPlayer(FrameCanvas* canvas, float x, float y, float vy, bool flapping)
     }
 }
 
-void drawEnemy(FrameCanvas* canvas, float x, float y, const Color& balloon_color) {
+void drawEnemy(Canvas* canvas, SceneRandom& rng, float x, float y, const Color& balloon_color) {
     int ex = (int)x;
     int ey = (int)y;
 
@@ -87,7 +75,7 @@ void drawEnemy(FrameCanvas* canvas, float x, float y, const Color& balloon_color
     canvas->SetPixel(ex, ey + 1, 255, 150, 80);
 
     // Arms (simple flapping)
-    if ((rand() % 10) < 5) {
+    if (rng.below(10) < 5) {
         canvas->SetPixel(ex - 1, ey, 255, 150, 80);
         canvas->SetPixel(ex + 1, ey, 255, 150, 80);
     }
@@ -97,75 +85,78 @@ bool checkCollision(float x1, float y1, float x2, float y2) {
     return (abs(x1 - x2) < 2 && abs(y1 - y2) < 3);
 }
 
-int main() {
-    srand(time(NULL));
-
-    // Set up signal handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    global_matrix = matrix;
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    global_canvas = canvas;
-
+class BalloonFightV2Scene : public Scene {
+private:
     // Colors
-    Color bg_black(0, 0, 0);
-    Color star_white(255, 255, 255);
-    Color water_blue(80, 160, 255);
-    Color water_light(120, 200, 255);
-    Color cloud_white(200, 200, 200);
+    Color bg_black = Color(0, 0, 0);
+    Color star_white = Color(255, 255, 255);
+    Color water_blue = Color(80, 160, 255);
+    Color water_light = Color(120, 200, 255);
+    Color cloud_white = Color(200, 200, 200);
 
     // Player
-    float player_x = 16.0f;
-    float player_y = 20.0f;
-    float player_vy = 0.0f;
-    bool flapping = false;
-    int flap_timer = 0;
-    int lives = 3;
-    int score = 0;
+    float player_x;
+    float player_y;
+    float player_vy;
+    bool flapping;
+    int flap_timer;
+    int lives;
+    int score;
 
     // Enemies
-    const int num_enemies = 4;
+    static const int num_enemies = 4;
     Enemy enemies[num_enemies];
-    Color enemy_colors[] = {Color(255, 255, 255), Color(255, 150, 80), Color(150, 200, 150), Color(200, 150, 255)};
-    for (int i = 0; i < num_enemies; ++i) {
-        enemies[i].x = rand() % 26 + 3;
-        enemies[i].y = rand() % 12 + 4;
-        enemies[i].vx = (rand() % 2 == 0 ? 1 : -1) * 0.15f;
-        enemies[i].vy = 0.05f + (rand() % 10) / 100.0f;
-        enemies[i].active = true;
-        enemies[i].balloon_color = enemy_colors[rand() % 4];
-    }
+    Color enemy_colors[4] = {Color(255, 255, 255), Color(255, 150, 80), Color(150, 200, 150), Color(200, 150, 255)};
 
     // Stars
     int star_x[20];
     int star_y[20];
-    for (int i = 0; i < 20; ++i) {
-        star_x[i] = rand() % 32;
-        star_y[i] = rand() % 26;
-    }
 
     // Clouds
     int cloud_x[3] = {5, 15, 25};
     int cloud_y[3] = {2, 4, 3};
 
-    int frame_count = 0;
+    int frame_count;
+    bool game_over;
+    SceneRandom rng;
+
+public:
+    BalloonFightV2Scene() : frame_count(0) {}
+
+    void Init(int w, int h) {
+        rng.seed(Seed(), "balloon_fightV2grok");
+
+        for (int i = 0; i < 20; ++i) {
+            star_x[i] = rng.below(32);
+            star_y[i] = rng.below(26);
+        }
+        newGame();
+    }
+
+    // Fresh player and enemies; a new game starts once the lives run out
+    void newGame() {
+        player_x = 16.0f;
+        player_y = 20.0f;
+        player_vy = 0.0f;
+        flapping = false;
+        flap_timer = 0;
+        lives = 3;
+        score = 0;
+
+        for (int i = 0; i < num_enemies; ++i) {
+            enemies[i].x = rng.below(26) + 3;
+            enemies[i].y = rng.below(12) + 4;
+            enemies[i].vx = (rng.below(2) == 0 ? 1 : -1) * 0.15f;
+            enemies[i].vy = 0.05f + rng.below(10) / 100.0f;
+            enemies[i].active = true;
+            enemies[i].balloon_color = enemy_colors[rng.below(4)];
+        }
+        game_over = false;
+    }
+
+    void Render(Canvas *canvas) {
+        if (game_over) newGame();
 
-    while (!interrupt_received) {
         canvas->Fill(bg_black.r, bg_black.g, bg_black.b);
 
         // Draw twinkling stars
@@ -210,13 +201,13 @@ int main() {
                 if (enemies[i].x < 2 || enemies[i].x > 29) enemies[i].vx *= -1;
                 if (enemies[i].y < 4 || enemies[i].y > 20) enemies[i].vy *= -0.8f; // Dampened bounce
 
-                drawEnemy(canvas, enemies[i].x, enemies[i].y, enemies[i].balloon_color);
+                drawEnemy(canvas, rng, enemies[i].x, enemies[i].y, enemies[i].balloon_color);
 
                 // Collision with player
                 if (checkCollision(player_x, player_y, enemies[i].x, enemies[i].y)) {
                     lives--;
                     enemies[i].active = false;
-                    if (lives <= 0) interrupt_received = true; // Game over
+                    if (lives <= 0) game_over = true;
                 }
             }
         }
@@ -251,20 +242,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000); // ~20 fps
-    }
-
-    // Final cleanup (redundant with signal handler but ensures safety)
-    if (global_canvas) {
-        global_canvas->Clear();
-        global_canvas = matrix->SwapOnVSync(global_canvas);
-    }
-    if (global_matrix) {
-        delete global_matrix;
-        global_matrix = nullptr;
     }
+};
 
-    std::cout << "Game Over! Score: " << score << ", Lives Left: " << lives << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(BalloonFightV2Scene)
@@ -1,20 +1,17 @@
+// Birthday Cake Scene
+// Compilation: g++ -o birthday birthday.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/birthday.so birthday.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 struct Confetti {
     float x;
     float y;
@@ -24,43 +21,23 @@ struct Confetti {
     bool active;
 };
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class BirthdayCakeScene : public Scene {
+private:
     // Colors
-    Color bg_purple(30, 10, 50);         // Purple party background
-    Color cake_pink(255, 150, 200);      // Pink cake layer
-    Color cake_blue(100, 200, 255);      // Blue cake layer
-    Color cake_yellow(255, 220, 100);    // Yellow cake layer
-    Color frosting(255, 255, 255);       // White frosting
-    Color candle_red(255, 0, 0);         // Red candle
-    Color candle_yellow(255, 200, 0);    // Yellow candle
-    Color candle_blue(0, 150, 255);      // Blue candle
-    Color flame_yellow(255, 255, 0);     // Yellow flame
-    Color flame_orange(255, 150, 0);     // Orange flame
-    Color table(139, 90, 43);            // Brown table
+    Color bg_purple = Color(30, 10, 50);         // Purple party background
+    Color cake_pink = Color(255, 150, 200);      // Pink cake layer
+    Color cake_blue = Color(100, 200, 255);      // Blue cake layer
+    Color cake_yellow = Color(255, 220, 100);    // Yellow cake layer
+    Color frosting = Color(255, 255, 255);       // White frosting
+    Color candle_red = Color(255, 0, 0);         // Red candle
+    Color candle_yellow = Color(255, 200, 0);    // Yellow candle
+    Color candle_blue = Color(0, 150, 255);      // Blue candle
+    Color flame_yellow = Color(255, 255, 0);     // Yellow flame
+    Color flame_orange = Color(255, 150, 0);     // Orange flame
+    Color table = Color(139, 90, 43);            // Brown table
 
     // Confetti colors
-    Color confetti_colors[] = {
+    Color confetti_colors[7] = {
         Color(255, 0, 0),      // Red
         Color(255, 150, 0),    // Orange
         Color(255, 255, 0),    // Yellow
@@ -70,22 +47,30 @@ int main() {
         Color(255, 0, 200)     // Pink
     };
 
-    // Initialize confetti
-    const int num_confetti = 30;
+    static const int num_confetti = 30;
     Confetti confetti[num_confetti];
-    for (int i = 0; i < num_confetti; ++i) {
-        confetti[i].x = rand() % 32;
-        confetti[i].y = -(rand() % 32);
-        confetti[i].speed = 0.2f + (rand() % 10) / 20.0f;
-        confetti[i].rotation = rand() % 360;
-        confetti[i].color = confetti_colors[rand() % 7];
-        confetti[i].active = true;
-    }
 
-    int frame_count = 0;
+    int frame_count;
+    SceneRandom rng;
+
+public:
+    BirthdayCakeScene() : frame_count(0) {}
 
-    // Display until interrupted
-    while (running) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "birthday");
+
+        // Initialize confetti
+        for (int i = 0; i < num_confetti; ++i) {
+            confetti[i].x = rng.below(32);
+            confetti[i].y = -(rng.below(32));
+            confetti[i].speed = 0.2f + rng.below(10) / 20.0f;
+            confetti[i].rotation = rng.below(360);
+            confetti[i].color = confetti_colors[rng.below(7)];
+            confetti[i].active = true;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with party background
         canvas->Fill(bg_purple.r, bg_purple.g, bg_purple.b);
 
@@ -178,9 +163,9 @@ int main() {
                 // Reset if it goes off screen
                 if (confetti[i].y >= 26) {  // Stop at table
                     confetti[i].y = 0;
-                    confetti[i].x = rand() % 32;
-                    confetti[i].speed = 0.2f + (rand() % 10) / 20.0f;
-                    confetti[i].color = confetti_colors[rand() % 7];
+                    confetti[i].x = rng.below(32);
+                    confetti[i].speed = 0.2f + rng.below(10) / 20.0f;
+                    confetti[i].color = confetti_colors[rng.below(7)];
                 }
 
                 // Draw confetti piece (1-2 pixels depending on rotation)
@@ -205,12 +190,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(BirthdayCakeScene)
@@ -1,22 +1,20 @@
 // Birthday Celebration Scene - 32x32 Optimized
-// Compilation: g++ -o birthday32 birthday32.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o birthday32 birthday32.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/birthday32.so birthday32.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Balloon {
     float x;
     float y;
@@ -51,25 +49,17 @@ struct Present {
     int ribbon_color;
 };
 
-struct Sparkle {
-    int x;
-    int y;
-    int life;
-    int max_life;
-    int brightness;
-};
-
-class BirthdayScene {
+class BirthdayScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Balloon> balloons;
     std::vector<Confetti> confetti;
     std::vector<Candle> candles;
     std::vector<Present> presents;
-    std::vector<Sparkle> sparkles;
+    ParticlePool sparkles;
     float time_counter;
+    SceneRandom rng;
     
     // Birthday colors
     Color balloon_red = Color(200, 20, 20);
@@ -96,21 +86,22 @@ private:
     Color party_bg = Color(40, 30, 60);
     
 public:
-    BirthdayScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    BirthdayScene() : canvas(NULL), width(0), height(0), sparkles(256), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "birthday32");
         
         // Create balloons
         for (int i = 0; i < 6; i++) {
             Balloon b;
             b.x = 3 + i * 5;
-            b.y = 3 + (rand() % 5);
-            b.speed = 0.05 + (float)rand() / RAND_MAX * 0.05;
-            b.bob_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            b.color_type = rand() % 6;
+            b.y = 3 + rng.below(5);
+            b.speed = 0.05 + rng.uniform() * 0.05;
+            b.bob_phase = rng.uniform() * 2 * M_PI;
+            b.color_type = rng.below(6);
             b.has_string = true;
             balloons.push_back(b);
         }
@@ -118,14 +109,14 @@ public:
         // Create confetti
         for (int i = 0; i < 25; i++) {
             Confetti c;
-            c.x = rand() % width;
-            c.y = -(rand() % 20);
-            c.vx = ((float)rand() / RAND_MAX - 0.5) * 0.3;
-            c.vy = 0.2 + (float)rand() / RAND_MAX * 0.3;
-            c.color_r = 100 + rand() % 155;
-            c.color_g = 100 + rand() % 155;
-            c.color_b = 100 + rand() % 155;
-            c.rotation = (float)rand() / RAND_MAX * 2 * M_PI;
+            c.x = rng.below(width);
+            c.y = -(rng.below(20));
+            c.vx = (rng.uniform() - 0.5) * 0.3;
+            c.vy = 0.2 + rng.uniform() * 0.3;
+            c.color_r = 100 + rng.below(155);
+            c.color_g = 100 + rng.below(155);
+            c.color_b = 100 + rng.below(155);
+            c.rotation = rng.uniform() * 2 * M_PI;
             confetti.push_back(c);
         }
         
@@ -135,8 +126,8 @@ public:
             Candle can;
             can.x = cake_center - 2 + i * 2;
             can.y = height - 10;
-            can.flicker_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            can.flame_brightness = 200 + rand() % 55;
+            can.flicker_phase = rng.uniform() * 2 * M_PI;
+            can.flame_brightness = 200 + rng.below(55);
             candles.push_back(can);
         }
         
@@ -258,8 +249,8 @@ public:
             // Reset at top
             if (balloon.y < -5) {
                 balloon.y = height + 2;
-                balloon.x = rand() % width;
-                balloon.color_type = rand() % 6;
+                balloon.x = rng.below(width);
+                balloon.color_type = rng.below(6);
             }
         }
     }
@@ -316,7 +307,7 @@ public:
             
             // Flame (flickering)
             float flicker = sin(candle.flicker_phase) * 0.3 + 0.7;
-            int flame_y = candle.y - 1 - (rand() % 2);
+            int flame_y = candle.y - 1 - rng.below(2);
             
             if (flame_y >= 0 && flame_y < height && candle.x >= 0 && candle.x < width) {
                 canvas->SetPixel(candle.x, flame_y, 
@@ -404,48 +395,34 @@ public:
             // Reset at bottom
             if (conf.y > height) {
                 conf.y = -2;
-                conf.x = rand() % width;
-                conf.color_r = 100 + rand() % 155;
-                conf.color_g = 100 + rand() % 155;
-                conf.color_b = 100 + rand() % 155;
+                conf.x = rng.below(width);
+                conf.color_r = 100 + rng.below(155);
+                conf.color_g = 100 + rng.below(155);
+                conf.color_b = 100 + rng.below(155);
             }
         }
     }
     
     void addSparkles() {
         // Add sparkles around candles
-        if (rand() % 5 < 2) {
+        if (rng.below(5) < 2) {
             for (auto& candle : candles) {
-                Sparkle s;
-                s.x = candle.x + (rand() % 5 - 2);
-                s.y = candle.y - 2 - rand() % 3;
-                s.life = 0;
-                s.max_life = 8 + rand() % 8;
-                s.brightness = 180 + rand() % 75;
-                sparkles.push_back(s);
+                int x = candle.x + (rng.below(5) - 2);
+                int y = candle.y - 2 - rng.below(3);
+                int max_life = 8 + rng.below(8);
+                int brightness = 180 + rng.below(75);
+                sparkles.spawn(x, y, 0, 0, max_life,
+                               Color(brightness, brightness * 0.9, brightness * 0.7));
             }
         }
         
         // Update sparkles
-        for (auto it = sparkles.begin(); it != sparkles.end();) {
-            it->life++;
-            
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                int brightness = it->brightness * fade;
-                
-                if (it->x >= 0 && it->x < width && it->y >= 0 && it->y < height) {
-                    canvas->SetPixel(it->x, it->y, brightness, brightness * 0.9, brightness * 0.7);
-                }
-                
-                ++it;
-            } else {
-                it = sparkles.erase(it);
-            }
-        }
+        sparkles.age(1);
+        sparkles.draw(canvas);
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawBackground();
@@ -456,47 +433,8 @@ public:
         updateBalloons();
         addSparkles();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Optimized for 32x32
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    BirthdayScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(BirthdayScene)
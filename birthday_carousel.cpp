@@ -1,22 +1,22 @@
+// Birthday Carousel Scene
+// Compilation: g++ -o birthday_carousel birthday_carousel.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/birthday_carousel.so birthday_carousel.cpp -lrgbmatrix -std=c++11
+
 // Birthday Cake Scene (Animated)
-// Compilation: g++ -o birthday_cake birthday_cake.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -lrgbmatrix -lpthread -lm
+// Compilation: g++ -o birthday_cake birthday_cake.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -L. -lrgbscene -lrgbmatrix -lpthread -lm
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true; // Set flag to exit loop
-}
-
 struct Sprinkle {
     float x;
     float y;
@@ -43,7 +43,7 @@ void DrawCakeTier(Canvas *canvas, int cx, int cy, int width, int height, Color b
     }
 }
 
-void DrawCandle(Canvas *canvas, int cx, int cy, Color flame_color) {
+void DrawCandle(Canvas *canvas, SceneRandom &rng, int cx, int cy, Color flame_color) {
     // Draw candle stick
     for (int y = cy; y < cy + 4; y++) {
         if (cx >= 0 && cx < 32 && y >= 0 && y < 32) {
@@ -51,7 +51,7 @@ void DrawCandle(Canvas *canvas, int cx, int cy, Color flame_color) {
         }
     }
     // Flickering flame
-    if (rand() % 10 < 8) { // 80% chance to show flame
+    if (rng.below(10) < 8) { // 80% chance to show flame
         for (int x = cx - 1; x <= cx + 1; x++) {
             for (int y = cy - 1; y < cy; y++) {
                 if ((x - cx) * (x - cx) + (y - (cy - 0.5)) * (y - (cy - 0.5)) <= 1) {
@@ -64,27 +64,8 @@ void DrawCandle(Canvas *canvas, int cx, int cy, Color flame_color) {
     }
 }
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, InterruptHandler);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class BirthdayCarouselScene : public Scene {
+private:
     // Colors
     Color sky_night = Color(10, 20, 40);       // Deep night sky
     Color cake_base = Color(150, 75, 0);       // Warm brown cake base
@@ -98,28 +79,36 @@ int main() {
     Color sparkle = Color(255, 255, 255);      // White sparkle
 
     // Initialize falling sprinkles
-    const int num_sprinkles = 15;
+    static const int num_sprinkles = 15;
     Sprinkle sprinkles[num_sprinkles];
-    for (int i = 0; i < num_sprinkles; ++i) {
-        sprinkles[i].x = rand() % 32;
-        sprinkles[i].y = -(rand() % 32);
-        sprinkles[i].speed = 0.5f + (rand() % 10) / 20.0f;
-        sprinkles[i].sway = 0.2f;
-        sprinkles[i].sway_offset = rand() % 360;
-        sprinkles[i].active = true;
-    }
 
     // Sparkle positions (will twinkle around cake)
-    int sparkle_positions[][2] = {
+    int sparkle_positions[9][2] = {
         {8, 8}, {24, 8}, {16, 16}, {10, 12}, {22, 12},
         {6, 18}, {26, 18}, {14, 22}, {18, 22}
     };
-    int num_sparkles = 9;
+    int num_sparkles;
+
+    int frame_count;
+    SceneRandom rng;
 
-    int frame_count = 0;
+public:
+    BirthdayCarouselScene() : num_sparkles(9), frame_count(0) {}
 
-    // Display until interrupted
-    while (!interrupt_received) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "birthday_carousel");
+
+        for (int i = 0; i < num_sprinkles; ++i) {
+            sprinkles[i].x = rng.below(32);
+            sprinkles[i].y = -(rng.below(32));
+            sprinkles[i].speed = 0.5f + rng.below(10) / 20.0f;
+            sprinkles[i].sway = 0.2f;
+            sprinkles[i].sway_offset = rng.below(360);
+            sprinkles[i].active = true;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with night sky
         canvas->Fill(sky_night.r, sky_night.g, sky_night.b);
 
@@ -146,7 +135,7 @@ int main() {
         // Animated icing drips
         int drip_y = base_y - 1;
         for (int x = base_x - width1 / 2 + 1; x < base_x + width1 / 2 - 1; x++) {
-            if (frame_count % 20 < 10 && rand() % 5 == 0) {
+            if (frame_count % 20 < 10 && rng.below(5) == 0) {
                 if (x >= 0 && x < 32 && drip_y >= 0 && drip_y < 32) {
                     canvas->SetPixel(x, drip_y, tier1_frosting.r, tier1_frosting.g, tier1_frosting.b);
                 }
@@ -154,7 +143,7 @@ int main() {
         }
         drip_y = mid_y - 1;
         for (int x = base_x - width2 / 2 + 1; x < base_x + width2 / 2 - 1; x++) {
-            if (frame_count % 15 < 7 && rand() % 4 == 0) {
+            if (frame_count % 15 < 7 && rng.below(4) == 0) {
                 if (x >= 0 && x < 32 && drip_y >= 0 && drip_y < 32) {
                     canvas->SetPixel(x, drip_y, tier2_frosting.r, tier2_frosting.g, tier2_frosting.b);
                 }
@@ -162,7 +151,7 @@ int main() {
         }
         drip_y = top_y - 1;
         for (int x = base_x - width3 / 2 + 1; x < base_x + width3 / 2 - 1; x++) {
-            if (frame_count % 10 < 5 && rand() % 3 == 0) {
+            if (frame_count % 10 < 5 && rng.below(3) == 0) {
                 if (x >= 0 && x < 32 && drip_y >= 0 && drip_y < 32) {
                     canvas->SetPixel(x, drip_y, tier3_frosting.r, tier3_frosting.g, tier3_frosting.b);
                 }
@@ -173,9 +162,9 @@ int main() {
         int candle_x_center = base_x;
         int candle_y = top_y - height3;
         int spacing = 2; // Space between candles
-        DrawCandle(canvas, candle_x_center - spacing, candle_y, flame_color); // Left candle
-        DrawCandle(canvas, candle_x_center, candle_y, flame_color);           // Center candle
-        DrawCandle(canvas, candle_x_center + spacing, candle_y, flame_color); // Right candle
+        DrawCandle(canvas, rng, candle_x_center - spacing, candle_y, flame_color); // Left candle
+        DrawCandle(canvas, rng, candle_x_center, candle_y, flame_color);           // Center candle
+        DrawCandle(canvas, rng, candle_x_center + spacing, candle_y, flame_color); // Right candle
 
         // Draw twinkling sparkles around cake
         for (int i = 0; i < num_sparkles; ++i) {
@@ -199,9 +188,9 @@ int main() {
                 // Reset if it goes off screen
                 if (sprinkles[i].y >= 32) {
                     sprinkles[i].y = -2; // Start just above top
-                    sprinkles[i].x = rand() % 32;
-                    sprinkles[i].speed = 0.5f + (rand() % 10) / 20.0f;
-                    sprinkles[i].sway_offset = rand() % 360;
+                    sprinkles[i].x = rng.below(32);
+                    sprinkles[i].speed = 0.5f + rng.below(10) / 20.0f;
+                    sprinkles[i].sway_offset = rng.below(360);
                 }
 
                 // Draw sprinkle (1x1 or 1x2 shape)
@@ -212,7 +201,7 @@ int main() {
                     Color* colors[] = {&sprinkle_red, &sprinkle_green, &sprinkle_blue};
                     Color color = *colors[i % 3];
                     canvas->SetPixel(sprinkle_x, sprinkle_y, color.r, color.g, color.b);
-                    if (sprinkle_y + 1 < 32 && rand() % 2 == 0) {
+                    if (sprinkle_y + 1 < 32 && rng.below(2) == 0) {
                         canvas->SetPixel(sprinkle_x, sprinkle_y + 1, color.r, color.g, color.b);
                     }
                 }
@@ -220,12 +209,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup and graceful exit
-    matrix->Clear();
-    delete matrix;
-    return 0;
-}
+RGB_SCENE_MAIN(BirthdayCarouselScene)
@@ -3,8 +3,10 @@
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "fontfile.h"
+#include "textcache.h"
 #include <getopt.h>
-#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -16,17 +18,12 @@
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-  interrupt_received = true;
-}
-
 static int usage(const char *progname) {
   fprintf(stderr, "usage: %s [options]\n", progname);
   fprintf(stderr, "Displays day of week (e.g., Mon), time (HH:MM), and date (MM/DD) vertically.\n");
   fprintf(stderr, "Options:\n");
   fprintf(stderr,
-          "\t-f <font-file>    : Use given BDF font file (e.g., 5x8.bdf).\n"
+          "\t-f <font-file>    : Use given BDF or compiled font file (e.g., 5x8.bdf, see fontc).\n"
           "\t-w <day-format>   : Day of week format (default: %%a)\n"
           "\t-t <time-format>  : Time format (default: %%H:%%M)\n"
           "\t-d <date-format>  : Date format (default: %%m/%%d)\n"
@@ -49,7 +46,7 @@ static bool FullSaturation(const Color &c) {
   return (c.r == 0 || c.r == 255) && (c.g == 0 || c.g == 255) && (c.b == 0 || c.b == 255);
 }
 
-void DrawGradientBackground(FrameCanvas *canvas, const Color &start_color, const Color &end_color, int rows) {
+void DrawGradientBackground(Canvas *canvas, const Color &start_color, const Color &end_color, int rows) {
   for (int y = 0; y < rows; ++y) {
     float t = (float)y / (rows - 1);
     uint8_t r = start_color.r + t * (end_color.r - start_color.r);
@@ -62,18 +59,13 @@ void DrawGradientBackground(FrameCanvas *canvas, const Color &start_color, const
 }
 
 int main(int argc, char *argv[]) {
-  RGBMatrix::Options matrix_options;
-  matrix_options.rows = 32;
-  matrix_options.cols = 32;
-  matrix_options.chain_length = 1;
-  matrix_options.parallel = 1;
-  matrix_options.hardware_mapping = "adafruit-hat";
-  rgb_matrix::RuntimeOptions runtime_opt;
-  runtime_opt.gpio_slowdown = 2;
-
-  if (!rgb_matrix::ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
+  SceneRuntime runtime;
+  // One frame per wall-clock second, each drawn as that second begins
+  if (!runtime.Start(&argc, &argv, 32, 1.0f)) {
     return usage(argv[0]);
   }
+  runtime.alignToWallClock(true);
+  RGBMatrix *matrix = runtime.matrix();
 
   std::string day_format = "%a";
   std::string time_format = "%H:%M";
@@ -126,20 +118,17 @@ int main(int argc, char *argv[]) {
     return usage(argv[0]);
   }
 
+  // Compiled fonts (see fontc) are mapped instead of parsed
   rgb_matrix::Font font;
-  if (!font.LoadFont(bdf_font_file)) {
+  FontFile compiled_font;
+  const bool compiled = FontFile::IsFontFile(bdf_font_file);
+  if (compiled ? !compiled_font.open(bdf_font_file) : !font.LoadFont(bdf_font_file)) {
     fprintf(stderr, "Couldn't load font '%s'\n", bdf_font_file);
     free((void*)bdf_font_file);
     return 1;
   }
 
-  RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-  if (matrix == NULL) {
-    free((void*)bdf_font_file);
-    return 1;
-  }
-
-  const bool all_extreme_colors = (matrix_options.brightness == 100) &&
+  const bool all_extreme_colors = (matrix->brightness() == 100) &&
                                   FullSaturation(text_color) &&
                                   FullSaturation(bg_start_color) &&
                                   FullSaturation(bg_end_color);
@@ -147,24 +136,42 @@ int main(int argc, char *argv[]) {
     matrix->SetPWMBits(1);
   }
 
+  TextCache text = compiled ? TextCache(compiled_font, letter_spacing)
+                            : TextCache(font, letter_spacing);
+
   FrameCanvas *offscreen = matrix->CreateFrameCanvas();
+  const int width = offscreen->width();
+  const int height = offscreen->height();
   char day_buffer[256];
   char time_buffer[256];
   char date_buffer[256];
-  struct timespec next_time;
-  next_time.tv_sec = time(NULL);
-  next_time.tv_nsec = 0;
+  const char *texts[3] = { day_buffer, time_buffer, date_buffer };
+  struct timespec now;
   struct tm tm;
   int frame_count = 0;
 
-  signal(SIGTERM, InterruptHandler);
-  signal(SIGINT, InterruptHandler);
-
-  while (!interrupt_received) {
-    localtime_r(&next_time.tv_sec, &tm);
-
-    // Draw gradient background
-    DrawGradientBackground(offscreen, bg_start_color, bg_end_color, matrix->height());
+  // The gradient and each text line live in their own layer. A frame only
+  // recomposites what changed since the buffer being drawn into was last
+  // shown: the time line when the colon blinks or a digit changes, the
+  // pulsing seconds pixel, and the day and date lines once a day.
+  CachedLayer background;
+  CachedLayer lines[3];
+  std::string shown[3];
+  DamageTracker damage;
+  std::vector<DamageTracker::Rect> dirty;
+
+  // Pulsing seconds indicator
+  const int sec_x = x_orig + text.characterWidth('0') * 6 + letter_spacing * 5;
+  const int sec_y = y_orig + text.height() + line_spacing + text.baseline();
+
+  while (runtime.running()) {
+    clock_gettime(CLOCK_REALTIME, &now);
+    localtime_r(&now.tv_sec, &tm);
+
+    if (background.needsRedraw(width, height)) {
+      DrawGradientBackground(&background, bg_start_color, bg_end_color, height);
+      damage.markAll();
+    }
 
     // Blinking colon for time
     std::string current_time_format = time_format;
@@ -181,39 +188,35 @@ int main(int argc, char *argv[]) {
     strftime(time_buffer, sizeof(time_buffer), current_time_format.c_str(), &tm);
     strftime(date_buffer, sizeof(date_buffer), date_format.c_str(), &tm);
 
-    // Draw day of week
-    int y = y_orig;
-    rgb_matrix::DrawText(offscreen, font, x_orig, y + font.baseline(),
-                         text_color, NULL, day_buffer, letter_spacing);
-
-    // Draw time
-    y += font.height() + line_spacing;
-    rgb_matrix::DrawText(offscreen, font, x_orig, y + font.baseline(),
-                         text_color, NULL, time_buffer, letter_spacing);
+    // Day of week, time and date, each redrawn only when its text changed
+    for (int i = 0; i < 3; i++) {
+      const int y = y_orig + i * (text.height() + line_spacing);
+      if (lines[i].needsRedraw(width, height) || shown[i] != texts[i]) {
+        lines[i].Clear();
+        text.draw(&lines[i], x_orig, y + text.baseline(), text_color, texts[i]);
+        shown[i] = texts[i];
+        damage.mark(0, y, width, text.height());
+      }
+    }
+    damage.mark(sec_x, sec_y, 1, 1);
 
-    // Draw date
-    y += font.height() + line_spacing;
-    rgb_matrix::DrawText(offscreen, font, x_orig, y + font.baseline(),
-                         text_color, NULL, date_buffer, letter_spacing);
+    damage.take(offscreen, &dirty);
+    for (size_t i = 0; i < dirty.size(); i++) {
+      const DamageTracker::Rect &r = dirty[i];
+      background.blit(offscreen, r.x, r.y, r.w, r.h);
+      for (int j = 0; j < 3; j++) lines[j].blit(offscreen, r.x, r.y, r.w, r.h);
+    }
 
-    // Pulsing seconds indicator
-    int sec_x = x_orig + font.CharacterWidth('0') * 6 + letter_spacing * 5;
-    int sec_y = y_orig + font.height() + line_spacing + font.baseline();
     float pulse = 0.5f + 0.5f * sin(frame_count * 0.2f);
     Color pulse_color(text_color.r * pulse, text_color.g * pulse, text_color.b * pulse);
     offscreen->SetPixel(sec_x, sec_y, pulse_color.r, pulse_color.g, pulse_color.b);
 
-    // Update display
-    offscreen = matrix->SwapOnVSync(offscreen);
+    // Update display; returns once the next second has begun
+    offscreen = runtime.Present(offscreen);
     frame_count++;
-
-    // Sleep for ~1 second
-    next_time.tv_sec += 1;
-    clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &next_time, NULL);
   }
 
   free((void*)bdf_font_file);
-  delete matrix;
   std::cout << std::endl;
   return 0;
 }
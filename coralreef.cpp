@@ -1,22 +1,19 @@
 // Coral Reef Scene - Underwater Beauty
-// Compilation: g++ -o coralreef coralreef.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o coralreef coralreef.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/coralreef.so coralreef.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Fish {
     float x;
     float y;
@@ -24,7 +21,7 @@ struct Fish {
     int direction; // 1 = right, -1 = left
     int color_type;
     int size;
-    int tail_frame;
+    float tail_frame;
     float swim_wave;
 };
 
@@ -67,10 +64,9 @@ struct WaterParticle {
     int brightness;
 };
 
-class CoralReefScene {
+class CoralReefScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Fish> fish;
     std::vector<Bubble> bubbles;
@@ -78,7 +74,11 @@ private:
     std::vector<Starfish> starfish;
     std::vector<Jellyfish> jellyfish;
     std::vector<WaterParticle> particles;
+    CachedLayer sand;   // Sparkle is re-rolled a few times a second, not every frame
+    float sand_age;
     float time_counter;
+    SceneRandom rng;
+    std::vector<uint32_t> sand_noise;  // One row of random numbers
     
     // Water colors
     Color water_deep = Color(0, 40, 80);
@@ -110,34 +110,35 @@ private:
     Color starfish_red = Color(180, 40, 40);
     
 public:
-    CoralReefScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    CoralReefScene() : canvas(NULL), width(0), height(0), sand_age(0), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "coralreef");
         
         // Create fish
         for (int i = 0; i < 6; i++) {
             Fish f;
-            f.x = rand() % width;
-            f.y = 5 + rand() % (int)(height * 0.5);
-            f.speed = 0.2 + (float)rand() / RAND_MAX * 0.3;
-            f.direction = (rand() % 2) * 2 - 1;
-            f.color_type = rand() % 5;
-            f.size = 2 + rand() % 2;
+            f.x = rng.below(width);
+            f.y = 5 + rng.below((int)(height * 0.5));
+            f.speed = 0.2 + rng.uniform() * 0.3;
+            f.direction = rng.below(2) * 2 - 1;
+            f.color_type = rng.below(5);
+            f.size = 2 + rng.below(2);
             f.tail_frame = 0;
-            f.swim_wave = (float)rand() / RAND_MAX * 2 * M_PI;
+            f.swim_wave = rng.uniform() * 2 * M_PI;
             fish.push_back(f);
         }
         
         // Create bubbles
         for (int i = 0; i < 15; i++) {
             Bubble b;
-            b.x = rand() % width;
-            b.y = height - 10 + rand() % 10;
-            b.speed = 0.1 + (float)rand() / RAND_MAX * 0.2;
-            b.drift = ((float)rand() / RAND_MAX - 0.5) * 0.1;
+            b.x = rng.below(width);
+            b.y = height - 10 + rng.below(10);
+            b.speed = 0.1 + rng.uniform() * 0.2;
+            b.drift = (rng.uniform() - 0.5) * 0.1;
             b.size = 1;
             bubbles.push_back(b);
         }
@@ -146,43 +147,43 @@ public:
         int num_corals = width / 6;
         for (int i = 0; i < num_corals; i++) {
             Coral c;
-            c.x = 3 + i * (width / num_corals) + (rand() % 3);
+            c.x = 3 + i * (width / num_corals) + rng.below(3);
             c.y = height - 3;
-            c.height = 4 + rand() % 6;
-            c.type = rand() % 3;
-            c.color_type = rand() % 5;
-            c.sway_phase = (float)rand() / RAND_MAX * 2 * M_PI;
+            c.height = 4 + rng.below(6);
+            c.type = rng.below(3);
+            c.color_type = rng.below(5);
+            c.sway_phase = rng.uniform() * 2 * M_PI;
             corals.push_back(c);
         }
         
         // Create starfish
         for (int i = 0; i < 2; i++) {
             Starfish s;
-            s.x = 5 + rand() % (width - 10);
+            s.x = 5 + rng.below(width - 10);
             s.y = height - 2;
-            s.color_type = rand() % 2;
+            s.color_type = rng.below(2);
             starfish.push_back(s);
         }
         
         // Create jellyfish
         for (int i = 0; i < 2; i++) {
             Jellyfish j;
-            j.x = rand() % width;
-            j.y = 5 + rand() % 10;
-            j.pulse_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            j.tentacle_length = 3 + rand() % 3;
-            j.color_type = rand() % 2;
+            j.x = rng.below(width);
+            j.y = 5 + rng.below(10);
+            j.pulse_phase = rng.uniform() * 2 * M_PI;
+            j.tentacle_length = 3 + rng.below(3);
+            j.color_type = rng.below(2);
             jellyfish.push_back(j);
         }
         
         // Create water particles
         for (int i = 0; i < 20; i++) {
             WaterParticle p;
-            p.x = rand() % width;
-            p.y = rand() % height;
-            p.vx = ((float)rand() / RAND_MAX - 0.5) * 0.05;
-            p.vy = ((float)rand() / RAND_MAX - 0.5) * 0.05;
-            p.brightness = 100 + rand() % 100;
+            p.x = rng.below(width);
+            p.y = rng.below(height);
+            p.vx = (rng.uniform() - 0.5) * 0.05;
+            p.vy = (rng.uniform() - 0.5) * 0.05;
+            p.brightness = 100 + rng.below(100);
             particles.push_back(p);
         }
     }
@@ -210,10 +211,14 @@ public:
     void drawSand() {
         int sand_start = height - 3;
         
-        // Sandy bottom
+        // Sandy bottom, a light grain on every third diagonal and on 20% of
+        // the rest; the random numbers come a row at a time
+        const uint32_t sparkle = 0x33333333u; // 20% of the 32-bit range
+        sand_noise.resize(width);
         for (int y = sand_start; y < height; y++) {
+            rng.fill(&sand_noise[0], width);
             for (int x = 0; x < width; x++) {
-                if ((x + y) % 3 == 0 || (rand() % 10 < 2)) {
+                if ((x + y) % 3 == 0 || sand_noise[x] < sparkle) {
                     canvas->SetPixel(x, y, sand_light.r, sand_light.g, sand_light.b);
                 } else {
                     canvas->SetPixel(x, y, sand_dark.r, sand_dark.g, sand_dark.b);
@@ -357,16 +362,19 @@ public:
         }
     }
     
-    void updateFish() {
+    void drawFish() {
         for (auto& f : fish) {
             // Swimming wave motion
-            f.swim_wave += 0.1;
             int wave_y = sin(f.swim_wave) * 2;
-            
-            drawFish((int)f.x, (int)f.y + wave_y, f.direction, f.color_type, f.size, f.tail_frame);
-            
-            f.x += f.speed * f.direction;
-            f.tail_frame++;
+            drawFish((int)f.x, (int)f.y + wave_y, f.direction, f.color_type, f.size, (int)f.tail_frame);
+        }
+    }
+    
+    void updateFish(float steps) {
+        for (auto& f : fish) {
+            f.swim_wave += 0.1 * steps;
+            f.x += f.speed * f.direction * steps;
+            f.tail_frame += steps;
             
             // Turn around at edges
             if (f.x < -5) {
@@ -388,17 +396,21 @@ public:
         }
     }
     
-    void updateBubbles() {
+    void drawBubbles() {
         for (auto& bubble : bubbles) {
             drawBubble((int)bubble.x, (int)bubble.y, bubble.size);
-            
-            bubble.y -= bubble.speed;
-            bubble.x += sin(time_counter * 3 + bubble.y) * bubble.drift;
+        }
+    }
+    
+    void updateBubbles(float steps) {
+        for (auto& bubble : bubbles) {
+            bubble.y -= bubble.speed * steps;
+            bubble.x += sin(time_counter * 3 + bubble.y) * bubble.drift * steps;
             
             // Reset at top
             if (bubble.y < 0) {
                 bubble.y = height - 3;
-                bubble.x = rand() % width;
+                bubble.x = rng.below(width);
             }
         }
     }
@@ -461,14 +473,19 @@ public:
         }
     }
     
-    void updateJellyfish() {
+    void drawJellyfish() {
         for (auto& jelly : jellyfish) {
-            jelly.pulse_phase += 0.05;
             drawJellyfish(jelly.x, jelly.y, jelly.pulse_phase, jelly.tentacle_length, jelly.color_type);
+        }
+    }
+    
+    void updateJellyfish(float steps) {
+        for (auto& jelly : jellyfish) {
+            jelly.pulse_phase += 0.05 * steps;
             
             // Slow drift
-            jelly.y += sin(jelly.pulse_phase) * 0.05;
-            jelly.x += cos(jelly.pulse_phase * 0.5) * 0.1;
+            jelly.y += sin(jelly.pulse_phase) * 0.05 * steps;
+            jelly.x += cos(jelly.pulse_phase * 0.5) * 0.1 * steps;
             
             // Keep in bounds
             if (jelly.x < 0) jelly.x = width - 1;
@@ -478,17 +495,21 @@ public:
         }
     }
     
-    void updateWaterParticles() {
+    void drawWaterParticles() {
         for (auto& p : particles) {
-            if (rand() % 100 < 3) {
+            if (rng.below(100) < 3) {
                 canvas->SetPixel((int)p.x, (int)p.y, 
                                water_light.r * p.brightness / 255,
                                water_light.g * p.brightness / 255,
                                water_light.b * p.brightness / 255);
             }
-            
-            p.x += p.vx;
-            p.y += p.vy;
+        }
+    }
+    
+    void updateWaterParticles(float steps) {
+        for (auto& p : particles) {
+            p.x += p.vx * steps;
+            p.y += p.vy * steps;
             
             if (p.x < 0) p.x = width - 1;
             if (p.x >= width) p.x = 0;
@@ -497,59 +518,42 @@ public:
         }
     }
     
-    void update() {
+    void Update(float dt) {
+        // Speeds above are per-frame steps tuned at 20 fps
+        const float steps = dt * 20.0f;
+        
+        updateWaterParticles(steps);
+        updateBubbles(steps);
+        updateJellyfish(steps);
+        updateFish(steps);
+        
+        sand_age += dt;
+        if (sand_age >= 0.25f) {
+            sand_age = 0;
+            sand.invalidate();
+        }
+        
+        time_counter += dt;
+    }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawWater();
-        drawSand();
-        updateWaterParticles();
+        if (sand.needsRedraw(width, height)) {
+            canvas = &sand;
+            drawSand();
+            canvas = c;
+        }
+        sand.blit(canvas);
+        drawWaterParticles();
         drawCorals();
         drawStarfish();
-        updateBubbles();
-        updateJellyfish();
-        updateFish();
-        
-        canvas = matrix->SwapOnVSync(canvas);
-        
-        time_counter += 0.05;
+        drawBubbles();
+        drawJellyfish();
+        drawFish();
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    CoralReefScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(CoralReefScene)
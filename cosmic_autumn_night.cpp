@@ -1,25 +1,20 @@
 // Cosmic Autumn Night Scene (Static)
-// Compilation: g++ -o cosmic_autumn_night cosmic_autumn_night.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -lrgbmatrix -lpthread -lm
+// Compilation: g++ -o cosmic_autumn_night cosmic_autumn_night.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -L. -lrgbscene -lrgbmatrix -lpthread -lm
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/cosmic_autumn_night.so cosmic_autumn_night.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
-class CosmicAutumnNight {
+class CosmicAutumnNight : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
 
     // Colors
@@ -33,10 +28,11 @@ private:
     Color text_silver = Color(192, 192, 192);     // Silver for "xAI Night" text
 
 public:
-    CosmicAutumnNight(RGBMatrix *m) : matrix(m) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    CosmicAutumnNight() : canvas(NULL), width(0), height(0) {}
+
+    void Init(int w, int h) {
+        width = w;
+        height = h;
     }
 
     void drawSky() {
@@ -153,7 +149,10 @@ public:
         canvas->SetPixel(text_x + 14, text_y + 1, text_silver.r, text_silver.g, text_silver.b);
     }
 
-    void draw() {
+    float DefaultFps() const { return 1.0f; }
+
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -161,42 +160,7 @@ public:
         drawStars();
         drawHotAirBalloon();
         drawText();
-        
-        canvas = matrix->SwapOnVSync(canvas);
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    CosmicAutumnNight scene(matrix);
-    scene.draw();
-    
-    while (!interrupt_received) {
-        usleep(1000000); // Hold display
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(CosmicAutumnNight)
@@ -1,21 +1,18 @@
+// Diwali Scene
+// Compilation: g++ -o diwali diwali.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/diwali.so diwali.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 struct Diya {
     int x;
     int y;
@@ -33,63 +30,54 @@ struct Sparkle {
     bool active;
 };
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class DiwaliScene : public Scene {
+private:
     // Colors for Diwali
-    Color bg_night(5, 5, 20);              // Deep night blue
-    Color diya_clay(180, 100, 60);         // Clay lamp color
-    Color flame_yellow(255, 220, 100);     // Yellow flame
-    Color flame_orange(255, 150, 50);      // Orange flame
-    Color flame_red(255, 80, 40);          // Red flame base
-    Color flame_white(255, 255, 230);      // White flame tip
-    Color rangoli_red(255, 50, 80);        // Rangoli colors
-    Color rangoli_orange(255, 150, 50);
-    Color rangoli_yellow(255, 220, 100);
-    Color rangoli_green(100, 255, 150);
-    Color rangoli_blue(100, 150, 255);
-    Color rangoli_pink(255, 150, 200);
-    Color rangoli_purple(200, 100, 255);
+    Color bg_night = Color(5, 5, 20);              // Deep night blue
+    Color diya_clay = Color(180, 100, 60);         // Clay lamp color
+    Color flame_yellow = Color(255, 220, 100);     // Yellow flame
+    Color flame_orange = Color(255, 150, 50);      // Orange flame
+    Color flame_red = Color(255, 80, 40);          // Red flame base
+    Color flame_white = Color(255, 255, 230);      // White flame tip
+    Color rangoli_red = Color(255, 50, 80);        // Rangoli colors
+    Color rangoli_orange = Color(255, 150, 50);
+    Color rangoli_yellow = Color(255, 220, 100);
+    Color rangoli_green = Color(100, 255, 150);
+    Color rangoli_blue = Color(100, 150, 255);
+    Color rangoli_pink = Color(255, 150, 200);
+    Color rangoli_purple = Color(200, 100, 255);
 
     // Diya lamps (oil lamps) positions
     Diya diyas[5];
-    diyas[0] = {6, 26, 0};
-    diyas[1] = {13, 28, 10};
-    diyas[2] = {16, 25, 5};
-    diyas[3] = {20, 28, 15};
-    diyas[4] = {26, 26, 8};
 
     // Sparkles/fireworks particles
-    const int num_sparkles = 30;
+    static const int num_sparkles = 30;
     Sparkle sparkles[num_sparkles];
-    for (int i = 0; i < num_sparkles; ++i) {
-        sparkles[i].active = false;
-    }
 
-    int frame_count = 0;
-    int firework_timer = 0;
+    int frame_count;
+    int firework_timer;
+    SceneRandom rng;
+
+public:
+    DiwaliScene() : frame_count(0), firework_timer(0) {}
 
-    // Display until interrupted
-    while (running) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "diwali");
+
+        // Diya lamps (oil lamps) positions
+        diyas[0] = {6, 26, 0};
+        diyas[1] = {13, 28, 10};
+        diyas[2] = {16, 25, 5};
+        diyas[3] = {20, 28, 15};
+        diyas[4] = {26, 26, 8};
+
+        // Sparkles/fireworks particles
+        for (int i = 0; i < num_sparkles; ++i) {
+            sparkles[i].active = false;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear with night sky
         canvas->Fill(bg_night.r, bg_night.g, bg_night.b);
 
@@ -183,18 +171,18 @@ int main() {
             for (int i = 0; i < num_sparkles; ++i) {
                 if (!sparkles[i].active) {
                     // Launch from random top position
-                    sparkles[i].x = 8 + rand() % 16;
-                    sparkles[i].y = 3 + rand() % 8;
+                    sparkles[i].x = 8 + rng.below(16);
+                    sparkles[i].y = 3 + rng.below(8);
 
                     // Explode outward
-                    float angle = (rand() % 360) * M_PI / 180.0f;
-                    float speed = 0.3f + (rand() % 10) / 20.0f;
+                    float angle = rng.below(360) * M_PI / 180.0f;
+                    float speed = 0.3f + rng.below(10) / 20.0f;
                     sparkles[i].vx = cos(angle) * speed;
                     sparkles[i].vy = sin(angle) * speed;
 
                     sparkles[i].lifetime = 0;
-                    sparkles[i].max_lifetime = 20 + rand() % 20;
-                    sparkles[i].color = ring_colors[rand() % 7];
+                    sparkles[i].max_lifetime = 20 + rng.below(20);
+                    sparkles[i].color = ring_colors[rng.below(7)];
                     sparkles[i].active = true;
 
                     if (i % 3 == 0) break; // Only launch a few at a time
@@ -237,12 +225,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(DiwaliScene)
@@ -1,36 +1,26 @@
 // Chinese Dragon Scene - Lunar New Year
-// Compilation: g++ -o dragon dragon.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o dragon dragon.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/dragon_red.so dragon_red.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct DragonSegment {
     float x;
     float y;
     float angle;
 };
 
-struct Firework {
-    float x;
-    float y;
-    int life;
-    int max_life;
-    int color_type;
-};
-
 struct Lantern {
     int x;
     int y;
@@ -45,27 +35,19 @@ struct Cloud {
     int size;
 };
 
-struct Sparkle {
-    int x;
-    int y;
-    int life;
-    int max_life;
-    int brightness;
-};
-
-class ChineseDragonScene {
+class ChineseDragonScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<DragonSegment> dragon;
-    std::vector<Firework> fireworks;
+    ParticlePool fireworks;  // Bursts; position and colour of each ring
     std::vector<Lantern> lanterns;
     std::vector<Cloud> clouds;
-    std::vector<Sparkle> sparkles;
+    ParticlePool sparkles;
     float time_counter;
     int dragon_length;
     float dragon_speed;
+    SceneRandom rng;
     
     // Traditional Chinese colors
     Color dragon_red = Color(200, 20, 20);
@@ -91,12 +73,14 @@ private:
     Color pearl_blue = Color(180, 200, 250);
     
 public:
-    ChineseDragonScene(RGBMatrix *m) : matrix(m), time_counter(0), dragon_length(20), dragon_speed(0.15) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    ChineseDragonScene() : canvas(NULL), width(0), height(0), fireworks(16), sparkles(256),
+                           time_counter(0), dragon_length(20), dragon_speed(0.15) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "dragon_red");
         
         // Initialize dragon segments
         for (int i = 0; i < dragon_length; i++) {
@@ -112,7 +96,7 @@ public:
             Lantern l;
             l.x = 5 + i * (width / 3);
             l.y = 3;
-            l.sway_phase = (float)rand() / RAND_MAX * 2 * M_PI;
+            l.sway_phase = rng.uniform() * 2 * M_PI;
             l.color_type = i % 2;
             lanterns.push_back(l);
         }
@@ -120,10 +104,10 @@ public:
         // Create clouds
         for (int i = 0; i < 3; i++) {
             Cloud c;
-            c.x = rand() % width;
-            c.y = 2 + rand() % 6;
-            c.speed = 0.05 + (float)rand() / RAND_MAX * 0.1;
-            c.size = 3 + rand() % 3;
+            c.x = rng.below(width);
+            c.y = 2 + rng.below(6);
+            c.speed = 0.05 + rng.uniform() * 0.1;
+            c.size = 3 + rng.below(3);
             clouds.push_back(c);
         }
     }
@@ -169,7 +153,7 @@ public:
             cloud.x += cloud.speed;
             if (cloud.x > width) {
                 cloud.x = -cloud.size;
-                cloud.y = 2 + rand() % 6;
+                cloud.y = 2 + rng.below(6);
             }
         }
     }
@@ -356,77 +340,52 @@ public:
     
     void updateFireworks() {
         // Randomly create fireworks
-        if (rand() % 80 == 0) {
-            Firework fw;
-            fw.x = 5 + rand() % (width - 10);
-            fw.y = 3 + rand() % (int)(height * 0.3);
-            fw.life = 0;
-            fw.max_life = 15 + rand() % 10;
-            fw.color_type = rand() % 4;
-            fireworks.push_back(fw);
+        if (rng.below(80) == 0) {
+            float x = 5 + rng.below(width - 10);
+            float y = 3 + rng.below((int)(height * 0.3));
+            int max_life = 15 + rng.below(10);
+            fireworks.spawn(x, y, 0, 0, max_life, getFireworkColor(rng.below(4)));
         }
         
         // Update fireworks
-        for (auto it = fireworks.begin(); it != fireworks.end();) {
-            it->life++;
+        fireworks.age(1);
+        for (int i = 0; i < fireworks.count(); i++) {
+            float fade = fireworks.fade(i);
             
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                Color fw_color = getFireworkColor(it->color_type);
+            // Expanding circle
+            int radius = 1 + (int)fireworks.life[i] / 3;
+            for (int angle = 0; angle < 360; angle += 30) {
+                float rad = angle * M_PI / 180.0;
+                int px = fireworks.x[i] + cos(rad) * radius;
+                int py = fireworks.y[i] + sin(rad) * radius;
                 
-                // Expanding circle
-                int radius = 1 + it->life / 3;
-                for (int angle = 0; angle < 360; angle += 30) {
-                    float rad = angle * M_PI / 180.0;
-                    int px = it->x + cos(rad) * radius;
-                    int py = it->y + sin(rad) * radius;
-                    
-                    if (px >= 0 && px < width && py >= 0 && py < height) {
-                        canvas->SetPixel(px, py, fw_color.r * fade, fw_color.g * fade, fw_color.b * fade);
-                    }
+                if (px >= 0 && px < width && py >= 0 && py < height) {
+                    canvas->SetPixel(px, py, fireworks.r[i] * fade, fireworks.g[i] * fade, fireworks.b[i] * fade);
                 }
-                
-                ++it;
-            } else {
-                it = fireworks.erase(it);
             }
         }
     }
     
     void addSparkles() {
         // Sparkles around dragon
-        if (rand() % 5 < 2) {
+        if (rng.below(5) < 2) {
             for (size_t i = 0; i < dragon.size(); i += 3) {
-                Sparkle s;
-                s.x = dragon[i].x + (rand() % 5 - 2);
-                s.y = dragon[i].y + (rand() % 5 - 2);
-                s.life = 0;
-                s.max_life = 8 + rand() % 8;
-                s.brightness = 180 + rand() % 75;
-                sparkles.push_back(s);
+                int x = dragon[i].x + (rng.below(5) - 2);
+                int y = dragon[i].y + (rng.below(5) - 2);
+                int max_life = 8 + rng.below(8);
+                int brightness = 180 + rng.below(75);
+                sparkles.spawn(x, y, 0, 0, max_life,
+                               Color(brightness, brightness * 0.9, brightness * 0.7));
             }
         }
         
         // Update sparkles
-        for (auto it = sparkles.begin(); it != sparkles.end();) {
-            it->life++;
-            
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                int brightness = it->brightness * fade;
-                
-                if (it->x >= 0 && it->x < width && it->y >= 0 && it->y < height) {
-                    canvas->SetPixel(it->x, it->y, brightness, brightness * 0.9, brightness * 0.7);
-                }
-                
-                ++it;
-            } else {
-                it = sparkles.erase(it);
-            }
-        }
+        sparkles.age(1);
+        sparkles.draw(canvas);
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -436,47 +395,8 @@ public:
         updateDragon();
         addSparkles();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    ChineseDragonScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(ChineseDragonScene)
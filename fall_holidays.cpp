@@ -1,5 +1,11 @@
+// Fall Holidays
+// Compilation: g++ -o fall_holidays fall_holidays.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/fall_holidays.so fall_holidays.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
@@ -7,7 +13,7 @@
 #include <cmath>
 using namespace rgb_matrix;
 
-enum Scene {
+enum Stage {
     HALLOWEEN,
     THANKSGIVING,
     WINTER
@@ -334,53 +340,48 @@ void drawWinterScene(Canvas *canvas, Particle particles[], int num_particles, in
     }
 }
 
-int main() {
-    srand(time(NULL));
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
-    // Initialize particles (used for snow/leaves)
-    const int num_particles = 20;
+class FallHolidaysScene : public Scene {
+private:
+    // Particles (used for snow/leaves)
+    static const int num_particles = 20;
     Particle particles[num_particles];
-    for (int i = 0; i < num_particles; ++i) {
-        particles[i].x = rand() % 32;
-        particles[i].y = -(rand() % 32);
-        particles[i].speed = 0.1f + (rand() % 10) / 20.0f;
-        particles[i].type = rand() % 3;
-        particles[i].active = true;
-    }
     
-    // Initialize ghosts for Halloween
+    // Ghosts for Halloween
     Ghost ghosts[2];
-    ghosts[0].x = 6;
-    ghosts[0].y = 10;
-    ghosts[0].float_offset = 0;
-    ghosts[0].phase = 0;
     
-    ghosts[1].x = 20;
-    ghosts[1].y = 8;
-    ghosts[1].float_offset = 50;
-    ghosts[1].phase = 50;
+    Stage current_scene;
+    int frame_count;
+    int scene_duration;  // ~20 seconds per scene at 20fps
+    SceneRandom rng;
+    
+public:
+    FallHolidaysScene() : current_scene(HALLOWEEN), frame_count(0), scene_duration(400) {}
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "fall_holidays");
+    
+        // Initialize particles (used for snow/leaves)
+        for (int i = 0; i < num_particles; ++i) {
+            particles[i].x = rng.below(32);
+            particles[i].y = -rng.below(32);
+            particles[i].speed = 0.1f + rng.below(10) / 20.0f;
+            particles[i].type = rng.below(3);
+            particles[i].active = true;
+        }
     
-    Scene current_scene = HALLOWEEN;
-    int frame_count = 0;
-    int scene_duration = 400;  // ~20 seconds per scene at 20fps
+        // Initialize ghosts for Halloween
+        ghosts[0].x = 6;
+        ghosts[0].y = 10;
+        ghosts[0].float_offset = 0;
+        ghosts[0].phase = 0;
+    
+        ghosts[1].x = 20;
+        ghosts[1].y = 8;
+        ghosts[1].float_offset = 50;
+        ghosts[1].phase = 50;
+    }
     
-    while (true) {
+    void Render(Canvas *canvas) {
         // Update particles
         for (int i = 0; i < num_particles; ++i) {
             if (particles[i].active) {
@@ -389,9 +390,9 @@ int main() {
                 int max_y = (current_scene == THANKSGIVING) ? 24 : 27;
                 if (particles[i].y >= max_y) {
                     particles[i].y = 0;
-                    particles[i].x = rand() % 32;
-                    particles[i].speed = 0.1f + (rand() % 10) / 20.0f;
-                    particles[i].type = rand() % 3;
+                    particles[i].x = rng.below(32);
+                    particles[i].speed = 0.1f + rng.below(10) / 20.0f;
+                    particles[i].type = rng.below(3);
                 }
             }
         }
@@ -417,10 +418,7 @@ int main() {
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(FallHolidaysScene)
@@ -1,22 +1,20 @@
 // First Snowfall Scene
-// Compilation: g++ -o firstsnow firstsnow.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o firstsnow firstsnow.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/firstsnow.so firstsnow.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Snowflake {
     float x;
     float y;
@@ -48,26 +46,18 @@ struct Child {
     int animation_frame;
 };
 
-struct Sparkle {
-    int x;
-    int y;
-    int life;
-    int max_life;
-    int brightness;
-};
-
-class FirstSnowScene {
+class FirstSnowScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Snowflake> snowflakes;
     std::vector<GroundSnow> ground_snow;
     std::vector<Tree> trees;
-    std::vector<Sparkle> sparkles;
+    ParticlePool sparkles;
     Child child;
     float time_counter;
     int total_snowfall;
+    SceneRandom rng;
     
     // Colors
     Color sky_evening = Color(40, 50, 80);
@@ -85,25 +75,27 @@ private:
     Color child_skin = Color(160, 120, 100);
     
 public:
-    FirstSnowScene(RGBMatrix *m) : matrix(m), time_counter(0), total_snowfall(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    FirstSnowScene() : canvas(NULL), width(0), height(0), sparkles(128), time_counter(0),
+                       total_snowfall(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "firstsnow");
         
         // Create gentle snowfall
         for (int i = 0; i < 30; i++) {
             Snowflake s;
-            s.x = rand() % width;
-            s.y = -(rand() % height);
-            s.speed = 0.15 + (float)rand() / RAND_MAX * 0.25;
-            s.drift = ((float)rand() / RAND_MAX - 0.5) * 0.3;
-            s.drift_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            s.size = 1 + (rand() % 3 == 0 ? 1 : 0); // Mostly size 1, occasional size 2
-            s.brightness = 180 + rand() % 60;
-            s.rotation = (float)rand() / RAND_MAX * 2 * M_PI;
-            s.rot_speed = ((float)rand() / RAND_MAX - 0.5) * 0.05;
+            s.x = rng.below(width);
+            s.y = -(rng.below(height));
+            s.speed = 0.15 + rng.uniform() * 0.25;
+            s.drift = (rng.uniform() - 0.5) * 0.3;
+            s.drift_phase = rng.uniform() * 2 * M_PI;
+            s.size = 1 + (rng.below(3) == 0 ? 1 : 0); // Mostly size 1, occasional size 2
+            s.brightness = 180 + rng.below(60);
+            s.rotation = rng.uniform() * 2 * M_PI;
+            s.rot_speed = (rng.uniform() - 0.5) * 0.05;
             snowflakes.push_back(s);
         }
         
@@ -112,7 +104,7 @@ public:
             GroundSnow gs;
             gs.x = x;
             gs.height = 0;
-            gs.accumulation_rate = 0.002 + (float)rand() / RAND_MAX * 0.001;
+            gs.accumulation_rate = 0.002 + rng.uniform() * 0.001;
             ground_snow.push_back(gs);
         }
         
@@ -120,13 +112,13 @@ public:
         if (width >= 32) {
             Tree t1;
             t1.x = 5;
-            t1.height = 8 + rand() % 3;
+            t1.height = 8 + rng.below(3);
             t1.snow_amount = 0;
             trees.push_back(t1);
             
             Tree t2;
             t2.x = width - 7;
-            t2.height = 7 + rand() % 3;
+            t2.height = 7 + rng.below(3);
             t2.snow_amount = 0;
             trees.push_back(t2);
         }
@@ -182,7 +174,7 @@ public:
                     int b = snow_on_ground.b * depth_ratio;
                     
                     // Add sparkle effect on surface
-                    if (h == snow.height - 1 && rand() % 100 < 2) {
+                    if (h == snow.height - 1 && rng.below(100) < 2) {
                         canvas->SetPixel(snow.x, y, 240, 245, 250);
                     } else {
                         canvas->SetPixel(snow.x, y, r, g, b);
@@ -256,18 +248,15 @@ public:
                 
                 // Reset snowflake
                 flake.y = -2;
-                flake.x = rand() % width;
+                flake.x = rng.below(width);
                 total_snowfall++;
                 
                 // Add sparkle where it lands occasionally
-                if (rand() % 5 == 0) {
-                    Sparkle sp;
-                    sp.x = (int)flake.x;
-                    sp.y = height - 2;
-                    sp.life = 0;
-                    sp.max_life = 15 + rand() % 10;
-                    sp.brightness = 200 + rand() % 55;
-                    sparkles.push_back(sp);
+                if (rng.below(5) == 0) {
+                    int max_life = 15 + rng.below(10);
+                    int brightness = 200 + rng.below(55);
+                    sparkles.spawn((int)flake.x, height - 2, 0, 0, max_life,
+                                   Color(brightness, brightness, brightness));
                 }
             }
         }
@@ -363,24 +352,18 @@ public:
     }
     
     void updateSparkles() {
-        for (auto it = sparkles.begin(); it != sparkles.end();) {
-            it->life++;
+        sparkles.age(1);
+        for (int i = 0; i < sparkles.count(); i++) {
+            int x = sparkles.x[i];
+            int y = sparkles.y[i];
+            int b = sparkles.r[i] * sparkles.fade(i);
             
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                int b = it->brightness * fade;
-                
-                canvas->SetPixel(it->x, it->y, b, b, b);
-                
-                // Twinkle effect
-                if (it->life % 3 == 0) {
-                    if (it->x > 0) canvas->SetPixel(it->x - 1, it->y, b/2, b/2, b/2);
-                    if (it->x < width - 1) canvas->SetPixel(it->x + 1, it->y, b/2, b/2, b/2);
-                }
-                
-                ++it;
-            } else {
-                it = sparkles.erase(it);
+            canvas->SetPixel(x, y, b, b, b);
+            
+            // Twinkle effect
+            if ((int)sparkles.life[i] % 3 == 0) {
+                if (x > 0) canvas->SetPixel(x - 1, y, b/2, b/2, b/2);
+                if (x < width - 1) canvas->SetPixel(x + 1, y, b/2, b/2, b/2);
             }
         }
     }
@@ -399,7 +382,8 @@ public:
         }
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -411,47 +395,8 @@ public:
         updateSparkles();
         drawSnowText();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    FirstSnowScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(FirstSnowScene)
@@ -1,59 +1,51 @@
+// Floating Balloons Scene
+// Compilation: g++ -o floating floating.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/floating.so floating.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
 #include <unistd.h>
 #include <iostream>
-#include <chrono>
-#include <signal.h>
 using namespace rgb_matrix;
-using namespace std::chrono;
-
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
 
-int main() {
-    // Set up signal handler for graceful exit
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class FloatingScene : public Scene {
+private:
     // Colors
-    Color sky(0, 0, 255);
-    Color ground(0, 128, 0);
-    Color cloud(255, 255, 255);
-    Color balloon(255, 0, 0);
-    Color string_color(255, 255, 255);
+    Color sky = Color(0, 0, 255);
+    Color ground = Color(0, 128, 0);
+    Color cloud = Color(255, 255, 255);
+    Color balloon = Color(255, 0, 0);
+    Color string_color = Color(255, 255, 255);
     
     // Initial balloon positions
-    int balloon_start_x[] = {5, 20, 27};
-    int balloon_start_y[] = {18, 16, 20};
-    float balloon_y[] = {18.0f, 16.0f, 20.0f};
-    steady_clock::time_point last_disappeared[3];
-    for (int i = 0; i < 3; ++i) {
-        last_disappeared[i] = steady_clock::now();
+    int balloon_start_x[3];
+    int balloon_start_y[3];
+    float balloon_y[3];
+    float last_disappeared[3];  // Scene time each balloon last floated away
+    bool balloon_visible[3];
+    float elapsed;              // Seconds since start
+    
+    float balloon_speed;  // pixels per frame (adjust for faster/slower)
+    
+public:
+    FloatingScene() : elapsed(0), balloon_speed(0.05f) {
+        const int start_x[] = {5, 20, 27};
+        const int start_y[] = {18, 16, 20};
+        for (int i = 0; i < 3; ++i) {
+            balloon_start_x[i] = start_x[i];
+            balloon_start_y[i] = start_y[i];
+            balloon_y[i] = start_y[i];
+            last_disappeared[i] = 0;
+            balloon_visible[i] = true;
+        }
     }
-    bool balloon_visible[] = {true, true, true};
     
-    float balloon_speed = 0.05f;  // pixels per frame (adjust for faster/slower)
+    void Update(float dt) {
+        elapsed += dt;
+    }
     
-    // Display continuously
-    while (!interrupt_received) {
+    void Render(Canvas *canvas) {
         // Clear canvas and redraw background
         canvas->Fill(sky.r, sky.g, sky.b);
         
@@ -69,11 +61,8 @@ int main() {
         
         // Update and draw balloons
         for (int i = 0; i < 3; ++i) {
-            auto now = steady_clock::now();
-            auto time_since_disappear = duration_cast<seconds>(now - last_disappeared[i]).count();
-            
             // Check if balloon should reappear
-            if (!balloon_visible[i] && time_since_disappear >= 10) {
+            if (!balloon_visible[i] && elapsed - last_disappeared[i] >= 10.0f) {
                 balloon_visible[i] = true;
                 balloon_y[i] = balloon_start_y[i];
             }
@@ -85,7 +74,7 @@ int main() {
                 // Check if balloon has gone off screen (above top with string)
                 if (balloon_y[i] + 8 < 0) {  // balloon radius + string length
                     balloon_visible[i] = false;
-                    last_disappeared[i] = steady_clock::now();
+                    last_disappeared[i] = elapsed;
                 }
                 
                 // Draw balloon and string if still on screen
@@ -103,16 +92,7 @@ int main() {
                 }
             }
         }
-        
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    // Clean up on exit - clear the display
-    canvas->Clear();
-    canvas = matrix->SwapOnVSync(canvas);
-    delete matrix;
-    
-    std::cout << "\nDisplay cleared. Exiting gracefully.\n";
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(FloatingScene)
@@ -0,0 +1,58 @@
+// Font Compiler - converts a BDF font into a compiled font file
+// Compilation: g++ -o fontc fontc.cpp -lrgbmatrix -std=c++11
+//
+// The BDF file is loaded with the matrix library's own Font::LoadFont() and
+// every glyph it lists is drawn once through Font::DrawGlyph(), so a
+// compiled font renders exactly like the BDF one. The result is the file
+// format in fontfile.h, which the text scenes map at startup instead of
+// parsing BDF (their -f option takes either).
+//
+// Usage: fontc <font.bdf> <font.rgbf>
+
+#include "led-matrix.h"
+#include "graphics.h"
+#include "fontfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <font.bdf> <font.rgbf>\n", argv[0]);
+        return 1;
+    }
+
+    rgb_matrix::Font font;
+    if (!font.LoadFont(argv[1])) {
+        fprintf(stderr, "Couldn't load font '%s'\n", argv[1]);
+        return 1;
+    }
+
+    // Font has no way to list its glyphs, so the code points come from the
+    // BDF file's ENCODING lines
+    FILE *bdf = fopen(argv[1], "r");
+    if (!bdf) {
+        fprintf(stderr, "Couldn't read '%s'\n", argv[1]);
+        return 1;
+    }
+    FontFileWriter writer;
+    std::vector<GlyphSpan> spans;
+    char line[1024];
+    while (fgets(line, sizeof(line), bdf)) {
+        long codepoint;
+        if (sscanf(line, "ENCODING %ld", &codepoint) != 1 || codepoint < 0) continue;
+        if (font.CharacterWidth(codepoint) < 0) continue;
+        const int advance = RasterizeGlyph(font, codepoint, &spans);
+        writer.addGlyph(codepoint, advance, spans);
+    }
+    fclose(bdf);
+
+    if (!writer.write(argv[2], font.height(), font.baseline())) {
+        fprintf(stderr, "Couldn't write '%s'\n", argv[2]);
+        return 1;
+    }
+    printf("%s: %zu glyphs, height %d, baseline %d\n",
+           argv[2], writer.glyphCount(), font.height(), font.baseline());
+    return 0;
+}
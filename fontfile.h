@@ -0,0 +1,341 @@
+// Precompiled bitmap fonts
+//
+// Font::LoadFont() parses a text BDF file on every start. fontc converts a
+// BDF font once into one of these files, which a FontFile maps and uses in
+// place: no parsing, no allocation, and drawing a glyph walks ready-made
+// runs of set pixels instead of a bitmap.
+//
+//   fontc fonts/5x8.bdf fonts/5x8.rgbf
+//
+//   FontFile font;
+//   if (!font.open("fonts/5x8.rgbf")) ...
+//   font.DrawText(canvas, x, y + font.baseline(), color, "12:34");
+//
+// Layout: a FontFileHeader, then header.glyph_count FontFileGlyphs sorted
+// by code point, then header.span_count GlyphSpans. A glyph's spans are
+// header.spans[first_span, first_span + span_count), with coordinates
+// relative to the pen position on the baseline. Integers are stored
+// little-endian, as on the Pi.
+//
+// Header only, so plugins and the compiler share one definition.
+
+#ifndef FONTFILE_H
+#define FONTFILE_H
+
+#include "led-matrix.h"
+#include "graphics.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+#define FONT_FILE_MAGIC "RGBFONT1"
+
+// Set pixels [x, x + length) of one row of a glyph or string
+struct GlyphSpan {
+    int16_t x;
+    int16_t y;
+    int16_t length;
+
+    bool operator<(const GlyphSpan &other) const {
+        return y != other.y ? y < other.y : x < other.x;
+    }
+};
+
+struct FontFileHeader {
+    char magic[8];
+    int16_t height;
+    int16_t baseline;
+    uint32_t glyph_count;
+    uint32_t span_count;
+};
+
+struct FontFileGlyph {
+    uint32_t codepoint;
+    int16_t advance;
+    uint16_t span_count;
+    uint32_t first_span;
+};
+
+// Sorts spans into row order and joins the ones that touch
+inline void MergeGlyphSpans(std::vector<GlyphSpan> *spans) {
+    std::sort(spans->begin(), spans->end());
+    size_t out = 0;
+    for (size_t i = 0; i < spans->size(); i++) {
+        const GlyphSpan &s = (*spans)[i];
+        if (out > 0) {
+            GlyphSpan &last = (*spans)[out - 1];
+            if (last.y == s.y && s.x <= last.x + last.length) {
+                last.length = std::max(last.x + last.length, s.x + s.length) - last.x;
+                continue;
+            }
+        }
+        (*spans)[out++] = s;
+    }
+    spans->resize(out);
+}
+
+// Canvas that records the pixels drawn into it as spans, around an origin
+// far from every edge so no glyph gets clipped
+class GlyphRecorder : public rgb_matrix::Canvas {
+public:
+    static const int origin = 1024;
+    std::vector<GlyphSpan> *pixels;
+
+    explicit GlyphRecorder(std::vector<GlyphSpan> *out) : pixels(out) {}
+
+    int width() const { return 2 * origin; }
+    int height() const { return 2 * origin; }
+    void SetPixel(int x, int y, uint8_t, uint8_t, uint8_t) {
+        const GlyphSpan pixel = { (int16_t)(x - origin), (int16_t)(y - origin), 1 };
+        pixels->push_back(pixel);
+    }
+    void Clear() {}
+    void Fill(uint8_t, uint8_t, uint8_t) {}
+};
+
+// Draws one glyph of a BDF font and returns its set pixels as spans
+// relative to the pen position, plus its advance. The font's own
+// DrawGlyph() does the work, so the result matches DrawText() exactly.
+inline int RasterizeGlyph(const rgb_matrix::Font &font, uint32_t codepoint,
+                          std::vector<GlyphSpan> *spans) {
+    spans->clear();
+    GlyphRecorder recorder(spans);
+    const int advance = font.DrawGlyph(&recorder, GlyphRecorder::origin, GlyphRecorder::origin,
+                                       rgb_matrix::Color(255, 255, 255), NULL, codepoint);
+    MergeGlyphSpans(spans);
+    return advance;
+}
+
+// Clips and draws spans with their origin at (x, y)
+inline void DrawGlyphSpans(rgb_matrix::Canvas *canvas, int x, int y, const rgb_matrix::Color &color,
+                           const GlyphSpan *spans, size_t count) {
+    const int canvas_w = canvas->width();
+    const int canvas_h = canvas->height();
+    for (size_t i = 0; i < count; i++) {
+        const GlyphSpan &s = spans[i];
+        const int py = y + s.y;
+        if (py < 0 || py >= canvas_h) continue;
+        const int begin = std::max(x + s.x, 0);
+        const int end = std::min(x + s.x + s.length, canvas_w);
+        for (int px = begin; px < end; px++) {
+            canvas->SetPixel(px, py, color.r, color.g, color.b);
+        }
+    }
+}
+
+// Next code point of a UTF-8 string, decoded the way DrawText() does
+inline uint32_t NextTextCodepoint(const char **text) {
+    const uint8_t *p = (const uint8_t *)*text;
+    uint32_t cp;
+    int length;
+    if (p[0] < 0x80) {
+        cp = p[0];
+        length = 1;
+    } else if ((p[0] & 0xE0) == 0xC0 && p[1]) {
+        cp = ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        length = 2;
+    } else if ((p[0] & 0xF0) == 0xE0 && p[1] && p[2]) {
+        cp = ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        length = 3;
+    } else if ((p[0] & 0xF8) == 0xF0 && p[1] && p[2] && p[3]) {
+        cp = ((p[0] & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        length = 4;
+    } else {
+        cp = 0xFFFD;
+        length = 1;
+    }
+    *text += length;
+    return cp;
+}
+
+class FontFileWriter {
+private:
+    std::vector<FontFileGlyph> glyphs;
+    std::vector<GlyphSpan> spans;
+    size_t written_glyphs;
+
+public:
+    FontFileWriter() : written_glyphs(0) {}
+
+    // Glyphs may be added in any order; a code point added twice keeps the
+    // first.
+    void addGlyph(uint32_t codepoint, int advance, const std::vector<GlyphSpan> &glyph_spans) {
+        FontFileGlyph glyph;
+        glyph.codepoint = codepoint;
+        glyph.advance = advance;
+        glyph.span_count = glyph_spans.size();
+        glyph.first_span = spans.size();
+        glyphs.push_back(glyph);
+        spans.insert(spans.end(), glyph_spans.begin(), glyph_spans.end());
+    }
+
+    bool write(const char *path, int height, int baseline) {
+        std::stable_sort(glyphs.begin(), glyphs.end(),
+                         [](const FontFileGlyph &a, const FontFileGlyph &b) {
+                             return a.codepoint < b.codepoint;
+                         });
+        // Keep the first glyph of each code point, and only its spans
+        std::vector<FontFileGlyph> unique;
+        std::vector<GlyphSpan> unique_spans;
+        for (size_t i = 0; i < glyphs.size(); i++) {
+            if (!unique.empty() && unique.back().codepoint == glyphs[i].codepoint) continue;
+            FontFileGlyph glyph = glyphs[i];
+            glyph.first_span = unique_spans.size();
+            unique_spans.insert(unique_spans.end(), spans.begin() + glyphs[i].first_span,
+                                spans.begin() + glyphs[i].first_span + glyphs[i].span_count);
+            unique.push_back(glyph);
+        }
+
+        FontFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, FONT_FILE_MAGIC, sizeof(header.magic));
+        header.height = height;
+        header.baseline = baseline;
+        header.glyph_count = unique.size();
+        header.span_count = unique_spans.size();
+
+        FILE *file = fopen(path, "wb");
+        if (!file) return false;
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  (unique.empty() ||
+                   fwrite(&unique[0], sizeof(FontFileGlyph), unique.size(), file) == unique.size()) &&
+                  (unique_spans.empty() ||
+                   fwrite(&unique_spans[0], sizeof(GlyphSpan), unique_spans.size(), file) ==
+                       unique_spans.size());
+        ok = (fclose(file) == 0) && ok;
+        written_glyphs = unique.size();
+        return ok;
+    }
+
+    // Glyphs in the file after write(), duplicates dropped
+    size_t glyphCount() const { return written_glyphs; }
+};
+
+class FontFile {
+private:
+    void *map;
+    size_t length;
+    const FontFileHeader *header;
+    const FontFileGlyph *glyphs;
+    const GlyphSpan *spans;
+
+    const FontFileGlyph *find(uint32_t codepoint) const {
+        size_t lo = 0, hi = header->glyph_count;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (glyphs[mid].codepoint < codepoint) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo < header->glyph_count && glyphs[lo].codepoint == codepoint) return &glyphs[lo];
+        return NULL;
+    }
+
+    // The glyph for `codepoint`, or the replacement character's, as
+    // Font::DrawGlyph() falls back
+    const FontFileGlyph *glyph(uint32_t codepoint) const {
+        const FontFileGlyph *g = find(codepoint);
+        return g ? g : find(0xFFFD);
+    }
+
+public:
+    FontFile() : map(MAP_FAILED), length(0), header(NULL), glyphs(NULL), spans(NULL) {}
+
+    ~FontFile() {
+        if (map != MAP_FAILED) munmap(map, length);
+    }
+
+    FontFile(const FontFile &) = delete;
+    FontFile &operator=(const FontFile &) = delete;
+
+    // True if `path` starts with the font file magic, to tell compiled fonts
+    // from BDF ones
+    static bool IsFontFile(const char *path) {
+        char magic[8];
+        FILE *f = fopen(path, "rb");
+        if (!f) return false;
+        const bool match = fread(magic, sizeof(magic), 1, f) == 1 &&
+                           memcmp(magic, FONT_FILE_MAGIC, sizeof(magic)) == 0;
+        fclose(f);
+        return match;
+    }
+
+    bool open(const char *path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FontFileHeader)) {
+            close(fd);
+            return false;
+        }
+        length = info.st_size;
+        map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) return false;
+
+        header = (const FontFileHeader *)map;
+        const size_t glyph_bytes = (size_t)header->glyph_count * sizeof(FontFileGlyph);
+        const size_t span_bytes = (size_t)header->span_count * sizeof(GlyphSpan);
+        if (memcmp(header->magic, FONT_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+            length != sizeof(FontFileHeader) + glyph_bytes + span_bytes) {
+            return false;
+        }
+        glyphs = (const FontFileGlyph *)(header + 1);
+        spans = (const GlyphSpan *)(glyphs + header->glyph_count);
+        for (uint32_t i = 0; i < header->glyph_count; i++) {
+            if ((uint64_t)glyphs[i].first_span + glyphs[i].span_count > header->span_count) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int height() const { return header->height; }
+    int baseline() const { return header->baseline; }
+
+    // Advance of `codepoint`, -1 if the font has no glyph for it
+    int CharacterWidth(uint32_t codepoint) const {
+        const FontFileGlyph *g = find(codepoint);
+        return g ? g->advance : -1;
+    }
+
+    // Same contract as Font::DrawGlyph() without a background colour
+    int DrawGlyph(rgb_matrix::Canvas *canvas, int x, int y, const rgb_matrix::Color &color,
+                  uint32_t codepoint) const {
+        const FontFileGlyph *g = glyph(codepoint);
+        if (!g) return 0;
+        DrawGlyphSpans(canvas, x, y, color, spans + g->first_span, g->span_count);
+        return g->advance;
+    }
+
+    // Same contract as rgb_matrix::DrawText() without a background colour
+    int DrawText(rgb_matrix::Canvas *canvas, int x, int y, const rgb_matrix::Color &color,
+                 const char *text, int letter_spacing = 0) const {
+        const int start_x = x;
+        while (*text) {
+            x += DrawGlyph(canvas, x, y, color, NextTextCodepoint(&text));
+            x += letter_spacing;
+        }
+        return x - start_x;
+    }
+
+    // Width DrawText() would return for `text`
+    int TextWidth(const char *text, int letter_spacing = 0) const {
+        int width = 0;
+        while (*text) {
+            const FontFileGlyph *g = glyph(NextTextCodepoint(&text));
+            width += (g ? g->advance : 0) + letter_spacing;
+        }
+        return width;
+    }
+};
+
+#endif // FONTFILE_H
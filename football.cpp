@@ -1,19 +1,17 @@
+// American Football Scene
+// Compilation: g++ -o football football.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/football.so football.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
-#include <chrono>
-#include <signal.h>
 #include <vector>
 #include <cmath>
 
 using namespace rgb_matrix;
-using namespace std::chrono;
-
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
 
 // Football field element structure
 struct FootballElement {
@@ -34,7 +32,7 @@ struct GameState {
 };
 
 // Simple drawing functions
-void DrawRectangle(FrameCanvas *canvas, int x, int y, int width, int height, Color color) {
+void DrawRectangle(Canvas *canvas, int x, int y, int width, int height, Color color) {
     for (int i = x; i < x + width && i < 32; ++i) {
         for (int j = y; j < y + height && j < 32; ++j) {
             if (i >= 0 && j >= 0) {
@@ -44,7 +42,8 @@ void DrawRectangle(FrameCanvas *canvas, int x, int y, int width, int height, Col
     }
 }
 
-void DrawCircle(FrameCanvas *canvas, int x, int y, int radius, Color color) {
+// Filled circle; the library's DrawCircle() only draws the outline
+void DrawFilledCircle(Canvas *canvas, int x, int y, int radius, Color color) {
     for (int i = -radius; i <= radius; ++i) {
         for (int j = -radius; j <= radius; ++j) {
             if (i*i + j*j <= radius*radius) {
@@ -58,111 +57,84 @@ void DrawCircle(FrameCanvas *canvas, int x, int y, int radius, Color color) {
     }
 }
 
-void DrawLine(FrameCanvas *canvas, int x1, int y1, int x2, int y2, Color color) {
-    int dx = abs(x2 - x1);
-    int dy = abs(y2 - y1);
-    int sx = (x1 < x2) ? 1 : -1;
-    int sy = (y1 < y2) ? 1 : -1;
-    int err = dx - dy;
-    
-    while (true) {
-        canvas->SetPixel(x1, y1, color.r, color.g, color.b);
-        if (x1 == x2 && y1 == y2) break;
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x1 += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y1 += sy;
-        }
-    }
-}
-
-int main() {
-    // Set up signal handler for graceful exit
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class FootballScene : public Scene {
+private:
     // American football colors
-    Color field_green(0, 128, 0);
-    Color white(255, 255, 255);
-    Color yellow(255, 255, 0);
-    Color brown(139, 69, 19);
-    Color home_red(255, 0, 0);      // Home team (red)
-    Color away_blue(0, 0, 255);     // Away team (blue)
-    Color football_brown(160, 120, 80);
-    Color goalpost_yellow(255, 255, 0);
-    Color crowd_dark(30, 30, 100);
+    Color field_green = Color(0, 128, 0);
+    Color white = Color(255, 255, 255);
+    Color yellow = Color(255, 255, 0);
+    Color brown = Color(139, 69, 19);
+    Color home_red = Color(255, 0, 0);      // Home team (red)
+    Color away_blue = Color(0, 0, 255);     // Away team (blue)
+    Color football_brown = Color(160, 120, 80);
+    Color goalpost_yellow = Color(255, 255, 0);
+    Color crowd_dark = Color(30, 30, 100);
 
     // Game state
     GameState game;
     
     // Football position and movement
     FootballElement football;
-    football.x = 16.0f;
-    football.y = 16.0f;
-    football.dx = 0.0f;
-    football.dy = 0.0f;
-    football.active = false;
-    football.color = football_brown;
 
     // Players
     std::vector<FootballElement> players;
-    
-    // Initialize offensive team (7 players)
-    for (int i = 0; i < 7; ++i) {
-        FootballElement player;
-        player.x = 10.0f + (i % 3) * 3.0f;
-        player.y = 8.0f + (i / 3) * 8.0f;
-        player.dx = 0.0f;
-        player.dy = 0.0f;
-        player.active = true;
-        player.color = game.home_has_ball ? home_red : away_blue;
-        players.push_back(player);
-    }
-    
-    // Initialize defensive team (7 players)
-    for (int i = 0; i < 7; ++i) {
-        FootballElement player;
-        player.x = 20.0f + (i % 3) * 3.0f;
-        player.y = 8.0f + (i / 3) * 8.0f;
-        player.dx = 0.0f;
-        player.dy = 0.0f;
-        player.active = true;
-        player.color = game.home_has_ball ? away_blue : home_red;
-        players.push_back(player);
-    }
 
     // Game cycle variables
     enum GamePhase { PRE_SNAP, PLAY_IN_PROGRESS, SCORE, TURNOVER };
-    GamePhase current_phase = PRE_SNAP;
-    int play_clock = 0;
-    int max_play_clock = 100;
-    auto last_phase_change = steady_clock::now();
+    GamePhase current_phase;
+    int play_clock;
+    int max_play_clock;
+    float elapsed;
+    float last_phase_change;  // Value of elapsed when current_phase was entered
     
     // Celebration particles
     std::vector<FootballElement> celebration;
-
-    // Main display loop
-    while (!interrupt_received) {
+    SceneRandom rng;
+    
+public:
+    FootballScene() : current_phase(PRE_SNAP), play_clock(0), max_play_clock(100),
+                      elapsed(0.0f), last_phase_change(0.0f) {
+        football.x = 16.0f;
+        football.y = 16.0f;
+        football.dx = 0.0f;
+        football.dy = 0.0f;
+        football.active = false;
+        football.color = football_brown;
+    }
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "football");
+    
+        // Initialize offensive team (7 players)
+        for (int i = 0; i < 7; ++i) {
+            FootballElement player;
+            player.x = 10.0f + (i % 3) * 3.0f;
+            player.y = 8.0f + (i / 3) * 8.0f;
+            player.dx = 0.0f;
+            player.dy = 0.0f;
+            player.active = true;
+            player.color = game.home_has_ball ? home_red : away_blue;
+            players.push_back(player);
+        }
+    
+        // Initialize defensive team (7 players)
+        for (int i = 0; i < 7; ++i) {
+            FootballElement player;
+            player.x = 20.0f + (i % 3) * 3.0f;
+            player.y = 8.0f + (i / 3) * 8.0f;
+            player.dx = 0.0f;
+            player.dy = 0.0f;
+            player.active = true;
+            player.color = game.home_has_ball ? away_blue : home_red;
+            players.push_back(player);
+        }
+    }
+    
+    void Update(float dt) {
+        elapsed += dt;
+    }
+    
+    void Render(Canvas *canvas) {
         canvas->Fill(0, 0, 0);  // Clear canvas
 
         // Draw football field
@@ -206,7 +178,7 @@ int main() {
 
         // Game logic based on current phase
         switch (current_phase) {
-            case PRE_SNAP:
+            case PRE_SNAP: {
                 // Position players for snap
                 if (!football.active) {
                     // Position quarterback (offensive team's center player)
@@ -218,17 +190,17 @@ int main() {
                 }
                 
                 // Start play after a delay
-                auto now = steady_clock::now();
-                if (duration_cast<milliseconds>(now - last_phase_change).count() > 2000) {
+                if (elapsed - last_phase_change > 2.0f) {
                     current_phase = PLAY_IN_PROGRESS;
                     play_clock = max_play_clock;
-                    last_phase_change = now;
+                    last_phase_change = elapsed;
                     
                     // Set initial football movement
                     football.dx = 1.0f;
-                    football.dy = (rand() % 3 - 1) * 0.5f;
+                    football.dy = (rng.below(3) - 1) * 0.5f;
                 }
                 break;
+            }
                 
             case PLAY_IN_PROGRESS:
                 // Update football position
@@ -248,8 +220,8 @@ int main() {
                     if (i < 7) {
                         player.dx = 0.3f;
                         // Try to get open for pass
-                        if (rand() % 100 < 10) {
-                            player.dy = (rand() % 3 - 1) * 0.4f;
+                        if (rng.below(100) < 10) {
+                            player.dy = (rng.below(3) - 1) * 0.4f;
                         }
                     } 
                     // Defensive players try to tackle
@@ -282,15 +254,15 @@ int main() {
                 if (football.x <= 2) { // Touchdown for away team
                     game.score_away += 7;
                     current_phase = SCORE;
-                    last_phase_change = steady_clock::now();
+                    last_phase_change = elapsed;
                     
                     // Celebration for away team
                     for (int i = 0; i < 15; ++i) {
                         FootballElement particle;
                         particle.x = football.x;
                         particle.y = football.y;
-                        particle.dx = (rand() % 10 - 5) * 0.1f;
-                        particle.dy = (rand() % 10 - 5) * 0.1f;
+                        particle.dx = (rng.below(10) - 5) * 0.1f;
+                        particle.dy = (rng.below(10) - 5) * 0.1f;
                         particle.active = true;
                         particle.color = away_blue;
                         celebration.push_back(particle);
@@ -298,15 +270,15 @@ int main() {
                 } else if (football.x >= 30) { // Touchdown for home team
                     game.score_home += 7;
                     current_phase = SCORE;
-                    last_phase_change = steady_clock::now();
+                    last_phase_change = elapsed;
                     
                     // Celebration for home team
                     for (int i = 0; i < 15; ++i) {
                         FootballElement particle;
                         particle.x = football.x;
                         particle.y = football.y;
-                        particle.dx = (rand() % 10 - 5) * 0.1f;
-                        particle.dy = (rand() % 10 - 5) * 0.1f;
+                        particle.dx = (rng.below(10) - 5) * 0.1f;
+                        particle.dy = (rng.below(10) - 5) * 0.1f;
                         particle.active = true;
                         particle.color = home_red;
                         celebration.push_back(particle);
@@ -316,16 +288,16 @@ int main() {
                 play_clock--;
                 if (play_clock <= 0) {
                     current_phase = TURNOVER;
-                    last_phase_change = steady_clock::now();
+                    last_phase_change = elapsed;
                     game.home_has_ball = !game.home_has_ball;
                 }
                 break;
                 
             case SCORE:
                 // Show score celebration
-                if (duration_cast<milliseconds>(steady_clock::now() - last_phase_change).count() > 3000) {
+                if (elapsed - last_phase_change > 3.0f) {
                     current_phase = PRE_SNAP;
-                    last_phase_change = steady_clock::now();
+                    last_phase_change = elapsed;
                     game.home_has_ball = !game.home_has_ball; // Switch possession after score
                     
                     // Reset football position
@@ -362,9 +334,9 @@ int main() {
                 
             case TURNOVER:
                 // Show turnover state briefly
-                if (duration_cast<milliseconds>(steady_clock::now() - last_phase_change).count() > 1500) {
+                if (elapsed - last_phase_change > 1.5f) {
                     current_phase = PRE_SNAP;
-                    last_phase_change = steady_clock::now();
+                    last_phase_change = elapsed;
                     
                     // Reset positions for new possession
                     football.x = 16.0f;
@@ -378,7 +350,7 @@ int main() {
         // Draw players
         for (size_t i = 0; i < players.size(); ++i) {
             const FootballElement& player = players[i];
-            DrawCircle(canvas, (int)player.x, (int)player.y, 1, player.color);
+            DrawFilledCircle(canvas, (int)player.x, (int)player.y, 1, player.color);
         }
 
         // Draw football
@@ -399,7 +371,7 @@ int main() {
             particle.y += particle.dy;
             
             if (particle.x >= 0 && particle.x < 32 && particle.y >= 0 && particle.y < 32) {
-                canvas->SetPixel((int)particle.x, (int)partball.y, 
+                canvas->SetPixel((int)particle.x, (int)particle.y, 
                                particle.color.r, particle.color.g, particle.color.b);
                 ++i;
             } else {
@@ -409,15 +381,7 @@ int main() {
         }
 
         // Swap canvas and control frame rate
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Clean up on exit
-    canvas->Clear();
-    canvas = matrix->SwapOnVSync(canvas);
-    delete matrix;
-
-    std::cout << "\nFootball display cleared. Exiting gracefully.\n";
-    return 0;
-}
+RGB_SCENE_MAIN(FootballScene)
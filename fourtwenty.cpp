@@ -1,22 +1,20 @@
 // 4/20 Scene - Chill Vibes
-// Compilation: g++ -o fourtwenty fourtwenty.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o fourtwenty fourtwenty.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/fourtwenty.so fourtwenty.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "hsv.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct RainbowWave {
     float phase;
     float speed;
@@ -56,10 +54,9 @@ struct ColorPulse {
     float speed;
 };
 
-class FourTwentyScene {
+class FourTwentyScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<RainbowWave> waves;
     std::vector<FloatingLeaf> leaves;
@@ -68,6 +65,15 @@ private:
     ColorPulse pulse;
     float time_counter;
     
+    // Background rows for HSVRowToRGB(). Hue and brightness only depend on
+    // x + y, so they are computed once per diagonal and row y reads them
+    // starting at index y.
+    std::vector<uint16_t> diagonal_hue;
+    std::vector<uint8_t> diagonal_value;
+    std::vector<uint8_t> row_saturation;
+    std::vector<uint8_t> row_rgb;
+    SceneRandom rng;
+    
     // Chill color palette
     Color leaf_green = Color(60, 160, 60);
     Color leaf_dark = Color(40, 100, 40);
@@ -75,43 +81,48 @@ private:
     Color smoke_light = Color(140, 140, 160);
     
 public:
-    FourTwentyScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    FourTwentyScene() : canvas(NULL), width(0), height(0), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
+        diagonal_hue.resize(w + h - 1);
+        diagonal_value.resize(w + h - 1);
+        row_saturation.assign(w, UnitToByte(0.6f));
+        row_rgb.resize(w * 3);
         
-        srand(time(NULL));
+        rng.seed(Seed(), "fourtwenty");
         
         // Rainbow waves
         for (int i = 0; i < 3; i++) {
             RainbowWave w;
-            w.phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            w.speed = 0.3 + (float)rand() / RAND_MAX * 0.3;
-            w.amplitude = 3 + rand() % 3;
+            w.phase = rng.uniform() * 2 * M_PI;
+            w.speed = 0.3 + rng.uniform() * 0.3;
+            w.amplitude = 3 + rng.below(3);
             waves.push_back(w);
         }
         
         // Floating leaves
         for (int i = 0; i < 5; i++) {
             FloatingLeaf l;
-            l.x = rand() % width;
-            l.y = rand() % height;
-            l.vx = ((float)rand() / RAND_MAX - 0.5) * 0.1;
-            l.vy = ((float)rand() / RAND_MAX - 0.5) * 0.1;
-            l.rotation = (float)rand() / RAND_MAX * 2 * M_PI;
-            l.rot_speed = ((float)rand() / RAND_MAX - 0.5) * 0.05;
-            l.color_phase = rand() % 360;
+            l.x = rng.below(width);
+            l.y = rng.below(height);
+            l.vx = (rng.uniform() - 0.5) * 0.1;
+            l.vy = (rng.uniform() - 0.5) * 0.1;
+            l.rotation = rng.uniform() * 2 * M_PI;
+            l.rot_speed = (rng.uniform() - 0.5) * 0.05;
+            l.color_phase = rng.below(360);
             leaves.push_back(l);
         }
         
         // Psychedelic circles
         for (int i = 0; i < 2; i++) {
             PsychedelicCircle c;
-            c.x = rand() % width;
-            c.y = rand() % height;
+            c.x = rng.below(width);
+            c.y = rng.below(height);
             c.radius = 0;
-            c.growth_speed = 0.1 + (float)rand() / RAND_MAX * 0.1;
-            c.hue_offset = rand() % 360;
+            c.growth_speed = 0.1 + rng.uniform() * 0.1;
+            c.hue_offset = rng.below(360);
             circles.push_back(c);
         }
         
@@ -120,51 +131,29 @@ public:
         pulse.speed = 0.5;
         
         // Smoke wisps
-        for (int i = 0; i < 8; i++) {
-            SmokeWisp s;
-            s.x = width / 2 + ((float)rand() / RAND_MAX - 0.5) * 4;
-            s.y = height - 3;
-            s.vx = ((float)rand() / RAND_MAX - 0.5) * 0.1;
-            s.vy = -0.1 - (float)rand() / RAND_MAX * 0.1;
-            s.age = rand() % 50;
-            s.max_age = 80 + rand() % 40;
-            s.swirl = (float)rand() / RAND_MAX * 2 * M_PI;
-            smoke.push_back(s);
+        smoke.resize(8);
+        for (auto& wisp : smoke) {
+            spawnSmoke(wisp);
+            wisp.age = rng.below(50);
         }
     }
     
-    void HSVtoRGB(float h, float s, float v, int &r, int &g, int &b) {
-        // h: 0-360, s: 0-1, v: 0-1
-        float c = v * s;
-        float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
-        float m = v - c;
-        
-        float r1, g1, b1;
-        if (h < 60) { r1 = c; g1 = x; b1 = 0; }
-        else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
-        else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
-        else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
-        else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
-        else { r1 = c; g1 = 0; b1 = x; }
-        
-        r = (r1 + m) * 255;
-        g = (g1 + m) * 255;
-        b = (b1 + m) * 255;
-    }
-    
     void drawPsychedelicBackground() {
         pulse.phase += pulse.speed * 0.05;
         
-        // Trippy rainbow gradient background
+        // Trippy rainbow gradient background: flowing rainbow along the
+        // diagonals
+        for (int d = 0; d < width + height - 1; d++) {
+            float wave = sin((d * 0.2 + time_counter * 2) * M_PI / 10) * 0.3 + 0.7;
+            diagonal_hue[d] = WrapHue(d * 10 + time_counter * 30);
+            diagonal_value[d] = UnitToByte(wave * 0.3);
+        }
+        
         for (int y = 0; y < height; y++) {
+            HSVRowToRGB(&diagonal_hue[y], &row_saturation[0], &diagonal_value[y],
+                        &row_rgb[0], width);
             for (int x = 0; x < width; x++) {
-                // Create flowing rainbow pattern
-                float hue = fmod((x * 10 + y * 10 + time_counter * 30), 360);
-                float wave = sin((x * 0.2 + y * 0.2 + time_counter * 2) * M_PI / 10) * 0.3 + 0.7;
-                
-                int r, g, b;
-                HSVtoRGB(hue, 0.6, wave * 0.3, r, g, b);
-                canvas->SetPixel(x, y, r, g, b);
+                canvas->SetPixel(x, y, row_rgb[x * 3], row_rgb[x * 3 + 1], row_rgb[x * 3 + 2]);
             }
         }
     }
@@ -264,15 +253,26 @@ public:
             // Reset when too big
             if (circle.radius > width / 2 + 5) {
                 circle.radius = 0;
-                circle.x = rand() % width;
-                circle.y = rand() % height;
-                circle.hue_offset = rand() % 360;
+                circle.x = rng.below(width);
+                circle.y = rng.below(height);
+                circle.hue_offset = rng.below(360);
             }
         }
     }
     
+    // Starts a wisp rising from the bottom centre
+    void spawnSmoke(SmokeWisp& wisp) {
+        wisp.x = width / 2 + (rng.uniform() - 0.5) * 4;
+        wisp.y = height - 3;
+        wisp.vx = (rng.uniform() - 0.5) * 0.1;
+        wisp.vy = -0.1 - rng.uniform() * 0.1;
+        wisp.age = 0;
+        wisp.max_age = 80 + rng.below(40);
+        wisp.swirl = rng.uniform() * 2 * M_PI;
+    }
+    
     void updateSmoke() {
-        for (auto it = smoke.begin(); it != smoke.end();) {
+        for (auto it = smoke.begin(); it != smoke.end(); ++it) {
             it->age++;
             
             if (it->age < it->max_age) {
@@ -304,21 +304,9 @@ public:
                 // Move smoke
                 it->x += it->vx;
                 it->y += it->vy;
-                
-                ++it;
             } else {
-                // Remove old smoke and create new
-                SmokeWisp new_smoke;
-                new_smoke.x = width / 2 + ((float)rand() / RAND_MAX - 0.5) * 4;
-                new_smoke.y = height - 3;
-                new_smoke.vx = ((float)rand() / RAND_MAX - 0.5) * 0.1;
-                new_smoke.vy = -0.1 - (float)rand() / RAND_MAX * 0.1;
-                new_smoke.age = 0;
-                new_smoke.max_age = 80 + rand() % 40;
-                new_smoke.swirl = (float)rand() / RAND_MAX * 2 * M_PI;
-                
-                it = smoke.erase(it);
-                smoke.push_back(new_smoke);
+                // Old smoke starts over as a new wisp
+                spawnSmoke(*it);
             }
         }
     }
@@ -375,7 +363,8 @@ public:
         }
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawPsychedelicBackground();
@@ -385,47 +374,8 @@ public:
         updateLeaves();
         draw420Text();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    FourTwentyScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(FourTwentyScene)
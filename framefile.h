@@ -0,0 +1,188 @@
+// Baked animation files
+//
+// A scene run with --bake=<file> renders its frames offline into one of
+// these files (see RunScene() in rgbscene.cpp) and frameplayer plays it
+// back: the player maps the file and only decodes, so a long-running
+// animation costs next to no CPU.
+//
+// Layout: a FrameFileHeader, then every frame delta run-length encoded
+// against the one before it (the first against black). There is no entropy
+// coding on top, so a frame that changes everywhere costs about its raw
+// size. A frame is a sequence of runs, each introduced by one byte n:
+//   n < 128    the next n + 1 pixels are unchanged
+//   n >= 128   the next n - 127 pixels follow as RGB triples
+// Runs never cross the end of a frame. Integers are stored little-endian,
+// as on the Pi.
+//
+// Header only, so the player and the runtime share one definition.
+
+#ifndef FRAMEFILE_H
+#define FRAMEFILE_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#define FRAME_FILE_MAGIC "RGBFRAM1"
+
+struct FrameFileHeader {
+    char magic[8];
+    uint16_t width;
+    uint16_t height;
+    float fps;
+    uint32_t frame_count;
+};
+
+class FrameFileWriter {
+private:
+    FILE *file;
+    FrameFileHeader header;
+    std::vector<uint8_t> previous;
+    std::vector<uint8_t> encoded;
+    std::vector<long> offsets;      // File offset of every frame written
+
+    // Appends a run of `count` (1..128) unchanged or literal pixels
+    void addRun(bool literal, const uint8_t *pixels, int count) {
+        encoded.push_back(literal ? 127 + count : count - 1);
+        if (literal) encoded.insert(encoded.end(), pixels, pixels + count * 3);
+    }
+
+public:
+    FrameFileWriter() : file(NULL) {}
+    ~FrameFileWriter() { if (file) fclose(file); }
+
+    bool open(const char *path, int width, int height, float fps) {
+        file = fopen(path, "wb");
+        if (!file) return false;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, FRAME_FILE_MAGIC, sizeof(header.magic));
+        header.width = width;
+        header.height = height;
+        header.fps = fps;
+        previous.assign(width * height * 3, 0);
+        offsets.clear();
+        // Rewritten with the final frame count by close()
+        return fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    // `rgb` is one packed, row-major frame of width x height pixels.
+    bool addFrame(const uint8_t *rgb) {
+        const int pixels = header.width * header.height;
+        encoded.clear();
+        int i = 0;
+        while (i < pixels) {
+            const bool literal = memcmp(rgb + i * 3, &previous[i * 3], 3) != 0;
+            int run = 1;
+            while (i + run < pixels && run < 128 &&
+                   (memcmp(rgb + (i + run) * 3, &previous[(i + run) * 3], 3) != 0) == literal) {
+                run++;
+            }
+            addRun(literal, rgb + i * 3, run);
+            i += run;
+        }
+        memcpy(&previous[0], rgb, previous.size());
+        offsets.push_back(ftell(file));
+        header.frame_count++;
+        return fwrite(&encoded[0], 1, encoded.size(), file) == encoded.size();
+    }
+
+    // Drops every frame from `frames` on. Only close() may follow.
+    bool truncate(uint32_t frames) {
+        if (frames >= header.frame_count) return true;
+        header.frame_count = frames;
+        return fflush(file) == 0 && ftruncate(fileno(file), offsets[frames]) == 0;
+    }
+
+    bool close() {
+        bool ok = fseek(file, 0, SEEK_SET) == 0 &&
+                  fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = (fclose(file) == 0) && ok;
+        file = NULL;
+        return ok;
+    }
+
+    uint32_t frameCount() const { return header.frame_count; }
+};
+
+class FrameFileReader {
+private:
+    void *map;
+    size_t length;
+    FrameFileHeader header;
+    const uint8_t *data;      // First frame
+    const uint8_t *end;
+    const uint8_t *cursor;    // Next frame to decode
+    uint32_t next_frame;
+    std::vector<uint8_t> pixels;
+
+public:
+    FrameFileReader() : map(MAP_FAILED), length(0), data(NULL), end(NULL), cursor(NULL),
+                        next_frame(0) {}
+
+    ~FrameFileReader() {
+        if (map != MAP_FAILED) munmap(map, length);
+    }
+
+    bool open(const char *path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FrameFileHeader)) {
+            close(fd);
+            return false;
+        }
+        length = info.st_size;
+        map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) return false;
+        madvise(map, length, MADV_SEQUENTIAL);
+
+        memcpy(&header, map, sizeof(header));
+        if (memcmp(header.magic, FRAME_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.width == 0 || header.height == 0 || header.frame_count == 0) {
+            return false;
+        }
+        data = cursor = (const uint8_t *)map + sizeof(header);
+        end = (const uint8_t *)map + length;
+        pixels.assign(header.width * header.height * 3, 0);
+        return true;
+    }
+
+    int width() const { return header.width; }
+    int height() const { return header.height; }
+    float fps() const { return header.fps; }
+    uint32_t frameCount() const { return header.frame_count; }
+
+    // Decodes the next frame, starting over after the last one, and returns
+    // its packed RGB pixels; NULL if the file is corrupt.
+    const uint8_t *nextFrame() {
+        if (next_frame == header.frame_count) {
+            next_frame = 0;
+            cursor = data;
+            memset(&pixels[0], 0, pixels.size());
+        }
+        const int total = header.width * header.height;
+        int i = 0;
+        while (i < total) {
+            if (cursor >= end) return NULL;
+            const int op = *cursor++;
+            const int count = (op < 128) ? op + 1 : op - 127;
+            if (i + count > total) return NULL;
+            if (op >= 128) {
+                if (end - cursor < count * 3) return NULL;
+                memcpy(&pixels[i * 3], cursor, count * 3);
+                cursor += count * 3;
+            }
+            i += count;
+        }
+        next_frame++;
+        return &pixels[0];
+    }
+};
+
+#endif // FRAMEFILE_H
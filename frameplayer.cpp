@@ -0,0 +1,56 @@
+// Frame Player - plays an animation baked by a scene's --bake mode
+// Compilation: g++ -o frameplayer frameplayer.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+//
+// The file is mapped and decoded frame by frame, so playback only costs
+// copying pixels into the FrameCanvas. It loops until interrupted and runs
+// at the frame rate the file was baked with unless --fps says otherwise.
+//
+// Usage: frameplayer <file> [--fps=<n>] [matrix flags]
+
+#include "led-matrix.h"
+#include "rgbscene.h"
+#include "framefile.h"
+#include <stdio.h>
+#include <algorithm>
+
+using namespace rgb_matrix;
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argv[1][0] == '-') {
+        fprintf(stderr, "usage: %s <file> [--fps=<n>] [matrix flags]\n", argv[0]);
+        return 1;
+    }
+
+    FrameFileReader frames;
+    if (!frames.open(argv[1])) {
+        fprintf(stderr, "%s is not a readable frame file\n", argv[1]);
+        return 1;
+    }
+    if (frames.height() != 32) {
+        fprintf(stderr, "%s is %d rows high, the panel has 32\n", argv[1], frames.height());
+        return 1;
+    }
+
+    SceneRuntime runtime;
+    if (!runtime.Start(&argc, &argv, frames.width(), frames.fps())) {
+        return 1;
+    }
+    FrameCanvas *canvas = runtime.matrix()->CreateFrameCanvas();
+    const int width = std::min(frames.width(), canvas->width());
+
+    while (runtime.running()) {
+        const uint8_t *rgb = frames.nextFrame();
+        if (!rgb) {
+            fprintf(stderr, "%s is corrupt\n", argv[1]);
+            return 1;
+        }
+        for (int y = 0; y < frames.height(); y++) {
+            const uint8_t *row = rgb + y * frames.width() * 3;
+            for (int x = 0; x < width; x++) {
+                canvas->SetPixel(x, y, row[x * 3], row[x * 3 + 1], row[x * 3 + 2]);
+            }
+        }
+        canvas = runtime.Present(canvas);
+    }
+    return 0;
+}
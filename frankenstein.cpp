@@ -1,64 +1,46 @@
+// Frankenstein Scene
+// Compilation: g++ -o frankenstein frankenstein.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/frankenstein.so frankenstein.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
-#include <signal.h>
 #include <cstdlib>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C and SIGTERM
-static void InterruptHandler(int signo) {
-    running = false;
-}
+class FrankensteinScene : public Scene {
+private:
+    // Colors
+    Color bg_dark = Color(15, 10, 20);           // Dark lab background
+    Color skin_green = Color(140, 160, 120);     // Greenish pale skin
+    Color skin_shadow = Color(100, 120, 90);     // Shadow areas
+    Color skin_highlight = Color(160, 180, 140); // Lighter skin for highlights
+    Color hair_black = Color(20, 20, 25);        // Black hair
+    Color hair_gray = Color(50, 50, 60);         // Gray for hair texture
+    Color bolt_metal = Color(180, 180, 190);     // Metal bolts
+    Color bolt_dark = Color(120, 120, 130);      // Bolt shadows
+    Color bolt_highlight = Color(220, 220, 230); // Bolt highlights
+    Color scar_red = Color(160, 80, 80);         // Reddish scars
+    Color scar_bright = Color(180, 100, 100);    // Brighter scar for pulsing
+    Color teeth_yellow = Color(230, 220, 180);   // Yellowish teeth
+    Color pupil_black = Color(10, 10, 15);       // Eye pupils
+    Color eye_white = Color(240, 240, 230);      // Eye whites
+    Color lightning_flash = Color(220, 220, 255); // Lightning effect
 
-int main() {
-    // Seed random number generator
-    srand(time(NULL));
+    int frame_count;
+    SceneRandom rng;
 
-    // Set up signal handlers
-    signal(SIGINT, InterruptHandler);
-    signal(SIGTERM, InterruptHandler);
+public:
+    FrankensteinScene() : frame_count(0) {}
 
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
+    void Init(int w, int h) {
+        rng.seed(Seed(), "frankenstein");
     }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
-    // Colors
-    Color bg_dark(15, 10, 20);           // Dark lab background
-    Color skin_green(140, 160, 120);     // Greenish pale skin
-    Color skin_shadow(100, 120, 90);     // Shadow areas
-    Color skin_highlight(160, 180, 140); // Lighter skin for highlights
-    Color hair_black(20, 20, 25);        // Black hair
-    Color hair_gray(50, 50, 60);         // Gray for hair texture
-    Color bolt_metal(180, 180, 190);     // Metal bolts
-    Color bolt_dark(120, 120, 130);      // Bolt shadows
-    Color bolt_highlight(220, 220, 230); // Bolt highlights
-    Color scar_red(160, 80, 80);         // Reddish scars
-    Color scar_bright(180, 100, 100);    // Brighter scar for pulsing
-    Color teeth_yellow(230, 220, 180);   // Yellowish teeth
-    Color pupil_black(10, 10, 15);       // Eye pupils
-    Color eye_white(240, 240, 230);      // Eye whites
-    Color lightning_flash(220, 220, 255); // Lightning effect
-
-    int frame_count = 0;
 
-    // Display until interrupted
-    while (running) {
+    void Render(Canvas *canvas) {
         // Dark background
         canvas->Fill(bg_dark.r, bg_dark.g, bg_dark.b);
 
@@ -66,20 +48,20 @@ int main() {
         bool lightning = (frame_count % 120) < 3;
         if (lightning) {
             for (int i = 0; i < 15; ++i) {
-                int lx = rand() % 32;
-                int ly = rand() % 10;
+                int lx = rng.below(32);
+                int ly = rng.below(10);
                 canvas->SetPixel(lx, ly, lightning_flash.r, lightning_flash.g, lightning_flash.b);
             }
         }
 
         // Electric sparks from head bolts
         int bolt_positions[][2] = {{8, 10}, {8, 11}, {23, 10}, {23, 11}};
-        if (rand() % 100 < 5) { // 5% chance per frame for sparks
+        if (rng.below(100) < 5) { // 5% chance per frame for sparks
             for (int i = 0; i < 4; ++i) {
                 int bx = bolt_positions[i][0];
                 int by = bolt_positions[i][1];
-                int spark_length = 1 + rand() % 3; // 1-3 pixels
-                int direction = rand() % 4; // 0: up, 1: down, 2: left, 3: right
+                int spark_length = 1 + rng.below(3); // 1-3 pixels
+                int direction = rng.below(4); // 0: up, 1: down, 2: left, 3: right
 
                 for (int j = 1; j <= spark_length; ++j) {
                     int sx, sy;
@@ -249,8 +231,8 @@ int main() {
         }
         // Hair texture (random gray patches)
         for (int i = 0; i < 6; ++i) {
-            int hx = 8 + rand() % 16;
-            int hy = 6 + rand() % 4;
+            int hx = 8 + rng.below(16);
+            int hy = 6 + rng.below(4);
             canvas->SetPixel(hx, hy, hair_gray.r, hair_gray.g, hair_gray.b);
         }
         // Hair extends down sides
@@ -289,12 +271,7 @@ int main() {
         canvas->SetPixel(23, 9, bolt_highlight.r, bolt_highlight.g, bolt_highlight.b); // Highlight
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(FrankensteinScene)
@@ -1,85 +1,68 @@
+// Frankenstein Scenes
+// Compilation: g++ -o frankenstein_scenes frankenstein_scenes.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/frankenstein_scenes.so frankenstein_scenes.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
-#include <signal.h>
 #include <cstdlib>
 #include <ctime>
 #include <cmath> // Added for sin and M_PI
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C and SIGTERM
-static void InterruptHandler(int signo) {
-    running = false;
-}
-
-int main() {
-    // Seed random number generator
-    srand(time(NULL));
-
-    // Set up signal handlers
-    signal(SIGINT, InterruptHandler);
-    signal(SIGTERM, InterruptHandler);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
+struct RainDrop {
+    int x;
+    float y;
+    float speed;
+};
 
+class FrankensteinScenes : public Scene {
+private:
     // Colors
-    Color bg_dark(15, 10, 20);           // Dark lab background
-    Color bg_storm(10, 10, 30);          // Stormy night background
-    Color rain_blue(50, 50, 100);        // Rain drops
-    Color cloud_gray(80, 80, 100);       // Clouds
-    Color skin_green(140, 160, 120);     // Greenish pale skin
-    Color skin_shadow(100, 120, 90);     // Shadow areas
-    Color skin_highlight(160, 180, 140); // Lighter skin for highlights
-    Color hair_black(20, 20, 25);        // Black hair
-    Color hair_gray(50, 50, 60);         // Gray for hair texture
-    Color bolt_metal(180, 180, 190);     // Metal bolts
-    Color bolt_dark(120, 120, 130);      // Bolt shadows
-    Color bolt_highlight(220, 220, 230); // Bolt highlights
-    Color scar_red(160, 80, 80);         // Reddish scars
-    Color scar_bright(180, 100, 100);    // Brighter scar for pulsing
-    Color teeth_yellow(230, 220, 180);   // Yellowish teeth
-    Color pupil_black(10, 10, 15);       // Eye pupils
-    Color eye_white(240, 240, 230);      // Eye whites
-    Color lightning_flash(220, 220, 255); // Lightning effect
-    Color coat_dark(40, 30, 50);         // Dark coat for back view
-
-    int frame_count = 0;
-    int scene = 0; // 0: wide back shot, 1: back of head, 2: detailed face, 3: lightning/sparkle
-    const int scene_duration = 200; // ~10 seconds per scene at 20 fps
-
-    struct RainDrop {
-        int x;
-        float y;
-        float speed;
-    };
-    const int num_rain = 20;
+    Color bg_dark = Color(15, 10, 20);           // Dark lab background
+    Color bg_storm = Color(10, 10, 30);          // Stormy night background
+    Color rain_blue = Color(50, 50, 100);        // Rain drops
+    Color cloud_gray = Color(80, 80, 100);       // Clouds
+    Color skin_green = Color(140, 160, 120);     // Greenish pale skin
+    Color skin_shadow = Color(100, 120, 90);     // Shadow areas
+    Color skin_highlight = Color(160, 180, 140); // Lighter skin for highlights
+    Color hair_black = Color(20, 20, 25);        // Black hair
+    Color hair_gray = Color(50, 50, 60);         // Gray for hair texture
+    Color bolt_metal = Color(180, 180, 190);     // Metal bolts
+    Color bolt_dark = Color(120, 120, 130);      // Bolt shadows
+    Color bolt_highlight = Color(220, 220, 230); // Bolt highlights
+    Color scar_red = Color(160, 80, 80);         // Reddish scars
+    Color scar_bright = Color(180, 100, 100);    // Brighter scar for pulsing
+    Color teeth_yellow = Color(230, 220, 180);   // Yellowish teeth
+    Color pupil_black = Color(10, 10, 15);       // Eye pupils
+    Color eye_white = Color(240, 240, 230);      // Eye whites
+    Color lightning_flash = Color(220, 220, 255); // Lightning effect
+    Color coat_dark = Color(40, 30, 50);         // Dark coat for back view
+
+    int frame_count;
+    int scene; // 0: wide back shot, 1: back of head, 2: detailed face, 3: lightning/sparkle
+    static const int scene_duration = 200; // ~10 seconds per scene at 20 fps
+    static const int num_rain = 20;
     RainDrop rain[num_rain];
-    for (int i = 0; i < num_rain; ++i) {
-        rain[i].x = rand() % 32;
-        rain[i].y = -(rand() % 32);
-        rain[i].speed = 0.5f + (rand() % 5) / 10.0f;
+    SceneRandom rng;
+
+public:
+    FrankensteinScenes() : frame_count(0), scene(0) {}
+
+    void Init(int w, int h) {
+        rng.seed(Seed(), "frankenstein_scenes");
+
+        for (int i = 0; i < num_rain; ++i) {
+            rain[i].x = rng.below(32);
+            rain[i].y = -rng.below(32);
+            rain[i].speed = 0.5f + rng.below(5) / 10.0f;
+        }
     }
 
-    // Display until interrupted
-    while (running) {
+    void Render(Canvas *canvas) {
         // Clear canvas
         canvas->Fill(bg_dark.r, bg_dark.g, bg_dark.b);
 
@@ -93,9 +76,9 @@ int main() {
         if (lightning) {
             int num_flashes = (scene == 3) ? 30 : 15;
             for (int i = 0; i < num_flashes; ++i) {
-                int lx = rand() % 32;
-                int ly = rand() % 32; // Full screen in scene 3
-                if (scene != 3) ly = rand() % 10; // Top only in other scenes
+                int lx = rng.below(32);
+                int ly = rng.below(32); // Full screen in scene 3
+                if (scene != 3) ly = rng.below(10); // Top only in other scenes
                 canvas->SetPixel(lx, ly, lightning_flash.r, lightning_flash.g, lightning_flash.b);
             }
         }
@@ -120,7 +103,7 @@ int main() {
                 rain[i].y += rain[i].speed;
                 if (rain[i].y >= 32) {
                     rain[i].y = 0;
-                    rain[i].x = rand() % 32;
+                    rain[i].x = rng.below(32);
                 }
                 int rx = (int)rain[i].x;
                 int ry = (int)rain[i].y;
@@ -171,8 +154,8 @@ int main() {
             }
             // Hair texture
             for (int i = 0; i < 10; ++i) {
-                int hx = 8 + rand() % 16;
-                int hy = 6 + rand() % 10;
+                int hx = 8 + rng.below(16);
+                int hy = 6 + rng.below(10);
                 canvas->SetPixel(hx, hy, hair_gray.r, hair_gray.g, hair_gray.b);
             }
 
@@ -292,8 +275,8 @@ int main() {
             }
             // Texture
             for (int i = 0; i < 8; ++i) {
-                int hx = 8 + rand() % 16;
-                int hy = 4 + rand() % 4;
+                int hx = 8 + rng.below(16);
+                int hy = 4 + rng.below(4);
                 canvas->SetPixel(hx, hy, hair_gray.r, hair_gray.g, hair_gray.b);
             }
 
@@ -389,8 +372,8 @@ int main() {
                 }
             }
             for (int i = 0; i < 8; ++i) {
-                int hx = 8 + rand() % 16;
-                int hy = 4 + rand() % 4;
+                int hx = 8 + rng.below(16);
+                int hy = 4 + rng.below(4);
                 canvas->SetPixel(hx, hy, hair_gray.r, hair_gray.g, hair_gray.b);
             }
             for (int y = 8; y < 15; ++y) {
@@ -407,13 +390,13 @@ int main() {
             canvas->SetPixel(25, 9, bolt_highlight.r, bolt_highlight.g, bolt_highlight.b);
 
             // Sparkle (arc) between head bolts
-            if (rand() % 100 < 10) { // 10% chance for arc spark
+            if (rng.below(100) < 10) { // 10% chance for arc spark
                 int arc_steps = 5;
                 for (int step = 0; step < arc_steps; ++step) {
                     float t = step / (float)(arc_steps - 1);
                     int ax = 7 + (int)(17.0f * t); // From left to right bolt
                     int ay = 9 - (int)(sin(t * M_PI) * 4.0f); // Arc shape
-                    int noise = rand() % 3 - 1; // Jaggedness
+                    int noise = rng.below(3) - 1; // Jaggedness
                     ay += noise;
                     if (ax >= 0 && ax < 32 && ay >= 0 && ay < 32) {
                         canvas->SetPixel(ax, ay, lightning_flash.r, lightning_flash.g, lightning_flash.b);
@@ -423,12 +406,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(FrankensteinScenes)
@@ -1,21 +1,18 @@
+// Graveyard Scene
+// Compilation: g++ -o graveyard graveyard.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/graveyard.so graveyard.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 struct Mist {
     float x;
     float y;
@@ -33,68 +30,59 @@ struct RisingGhost {
     bool rising;
 };
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class GraveyardScene : public Scene {
+private:
     // Colors
-    Color sky_dark(10, 5, 25);          // Very dark purple sky
-    Color moon(255, 255, 180);          // Pale moon
-    Color ground(15, 10, 5);            // Dark brown ground
-    Color grass(20, 30, 10);            // Dead grass
-    Color tombstone_gray(100, 100, 110); // Gray tombstone
-    Color tombstone_dark(60, 60, 70);   // Dark gray
-    Color ghost_white(200, 200, 220);   // Ghostly white
-    Color ghost_transparent(150, 150, 170); // Transparent ghost
-    Color mist_color(80, 80, 100);      // Purple mist
-    Color tree_dead(40, 30, 20);        // Dead tree brown
+    Color sky_dark = Color(10, 5, 25);          // Very dark purple sky
+    Color moon = Color(255, 255, 180);          // Pale moon
+    Color ground = Color(15, 10, 5);            // Dark brown ground
+    Color grass = Color(20, 30, 10);            // Dead grass
+    Color tombstone_gray = Color(100, 100, 110); // Gray tombstone
+    Color tombstone_dark = Color(60, 60, 70);   // Dark gray
+    Color ghost_white = Color(200, 200, 220);   // Ghostly white
+    Color ghost_transparent = Color(150, 150, 170); // Transparent ghost
+    Color mist_color = Color(80, 80, 100);      // Purple mist
+    Color tree_dead = Color(40, 30, 20);        // Dead tree brown
 
     // Initialize mist particles
-    const int num_mist = 8;
+    static const int num_mist = 8;
     Mist mist[num_mist];
-    for (int i = 0; i < num_mist; ++i) {
-        mist[i].x = rand() % 32;
-        mist[i].y = 20 + rand() % 10;
-        mist[i].speed = 0.05f + (rand() % 5) / 50.0f;
-        mist[i].width = 2 + rand() % 3;
-        mist[i].active = true;
-    }
 
     // Initialize rising ghosts
-    const int num_ghosts = 2;
+    static const int num_ghosts = 2;
     RisingGhost ghosts[num_ghosts];
-    for (int i = 0; i < num_ghosts; ++i) {
-        ghosts[i].x = 8 + i * 16;
-        ghosts[i].y = 26;  // Start underground
-        ghosts[i].speed = 0.02f;
-        ghosts[i].phase = rand() % 360;
-        ghosts[i].active = false;
-        ghosts[i].rising = false;
-    }
 
-    int frame_count = 0;
-    int ghost_spawn_timer = 0;
+    int frame_count;
+    int ghost_spawn_timer;
+    SceneRandom rng;
+
+public:
+    GraveyardScene() : frame_count(0), ghost_spawn_timer(0) {}
+
+    void Init(int w, int h) {
+        rng.seed(Seed(), "graveyard");
 
-    // Display until interrupted
-    while (running) {
+        // Initialize mist particles
+        for (int i = 0; i < num_mist; ++i) {
+            mist[i].x = rng.below(32);
+            mist[i].y = 20 + rng.below(10);
+            mist[i].speed = 0.05f + rng.below(5) / 50.0f;
+            mist[i].width = 2 + rng.below(3);
+            mist[i].active = true;
+        }
+
+        // Initialize rising ghosts
+        for (int i = 0; i < num_ghosts; ++i) {
+            ghosts[i].x = 8 + i * 16;
+            ghosts[i].y = 26;  // Start underground
+            ghosts[i].speed = 0.02f;
+            ghosts[i].phase = rng.below(360);
+            ghosts[i].active = false;
+            ghosts[i].rising = false;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with night sky
         canvas->Fill(sky_dark.r, sky_dark.g, sky_dark.b);
 
@@ -205,7 +193,7 @@ int main() {
                 // Wrap around
                 if (mist[i].x > 32) {
                     mist[i].x = -mist[i].width;
-                    mist[i].y = 20 + rand() % 10;
+                    mist[i].y = 20 + rng.below(10);
                 }
 
                 // Draw mist wisp
@@ -289,12 +277,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(GraveyardScene)
@@ -1,48 +1,27 @@
 // Green Dragon Scene - Fantasy Theme
-// Compilation: g++ -o greendragon greendragon.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o greendragon greendragon.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/greendragon.so greendragon.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "hsv.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct DragonSegment {
     float x;
     float y;
     float angle;
 };
 
-struct FireBreath {
-    float x;
-    float y;
-    float vx;
-    float vy;
-    int life;
-    int max_life;
-    float size;
-};
-
-struct MagicParticle {
-    float x;
-    float y;
-    float vx;
-    float vy;
-    int life;
-    int max_life;
-    int hue;
-};
-
 struct Treasure {
     int x;
     int y;
@@ -55,14 +34,13 @@ struct Wing {
     int flap_direction;
 };
 
-class GreenDragonScene {
+class GreenDragonScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<DragonSegment> dragon;
-    std::vector<FireBreath> flames;
-    std::vector<MagicParticle> particles;
+    ParticlePool flames;     // kind: 1 for the larger, two pixel flames
+    ParticlePool particles;  // kind: hue
     std::vector<Treasure> treasures;
     Wing left_wing;
     Wing right_wing;
@@ -70,6 +48,7 @@ private:
     int dragon_length;
     bool breathing_fire;
     int fire_cooldown;
+    SceneRandom rng;
     
     // Green dragon colors
     Color dragon_green = Color(60, 180, 60);
@@ -99,13 +78,15 @@ private:
     Color magic_blue = Color(80, 200, 250);
     
 public:
-    GreenDragonScene(RGBMatrix *m) : matrix(m), time_counter(0), dragon_length(18), 
-                                      breathing_fire(false), fire_cooldown(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    GreenDragonScene() : canvas(NULL), width(0), height(0), flames(32), particles(512),
+                         time_counter(0), dragon_length(18),
+                         breathing_fire(false), fire_cooldown(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "greendragon");
         
         // Initialize dragon segments
         for (int i = 0; i < dragon_length; i++) {
@@ -125,32 +106,14 @@ public:
         // Create treasure hoard
         for (int i = 0; i < 8; i++) {
             Treasure t;
-            t.x = 5 + rand() % (width / 3);
-            t.y = height - 5 + rand() % 3;
-            t.glow_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            t.type = rand() % 4; // gold, silver, ruby, sapphire
+            t.x = 5 + rng.below(width / 3);
+            t.y = height - 5 + rng.below(3);
+            t.glow_phase = rng.uniform() * 2 * M_PI;
+            t.type = rng.below(4); // gold, silver, ruby, sapphire
             treasures.push_back(t);
         }
     }
     
-    void HSVtoRGB(float h, float s, float v, int &r, int &g, int &b) {
-        float c = v * s;
-        float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
-        float m = v - c;
-        
-        float r1, g1, b1;
-        if (h < 60) { r1 = c; g1 = x; b1 = 0; }
-        else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
-        else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
-        else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
-        else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
-        else { r1 = c; g1 = 0; b1 = x; }
-        
-        r = (r1 + m) * 255;
-        g = (g1 + m) * 255;
-        b = (b1 + m) * 255;
-    }
-    
     void drawCaveBackground() {
         // Dark cave background
         for (int y = 0; y < height; y++) {
@@ -371,106 +334,86 @@ public:
         fire_cooldown--;
         
         // Start breathing fire periodically
-        if (fire_cooldown <= 0 && rand() % 100 < 5) {
+        if (fire_cooldown <= 0 && rng.below(100) < 5) {
             breathing_fire = true;
             fire_cooldown = 60;
         }
         
         // Create fire particles
-        if (breathing_fire && flames.size() < 30) {
+        if (breathing_fire && flames.count() < 30) {
             for (int i = 0; i < 3; i++) {
-                FireBreath fb;
-                float angle = dragon[0].angle + ((float)rand() / RAND_MAX - 0.5) * 0.5;
-                fb.x = dragon[0].x + cos(dragon[0].angle) * 5;
-                fb.y = dragon[0].y + sin(dragon[0].angle) * 5;
-                fb.vx = cos(angle) * (0.8 + (float)rand() / RAND_MAX * 0.4);
-                fb.vy = sin(angle) * (0.8 + (float)rand() / RAND_MAX * 0.4);
-                fb.life = 0;
-                fb.max_life = 15 + rand() % 10;
-                fb.size = 1.0 + (float)rand() / RAND_MAX;
-                flames.push_back(fb);
+                float angle = dragon[0].angle + (rng.uniform() - 0.5) * 0.5;
+                float x = dragon[0].x + cos(dragon[0].angle) * 5;
+                float y = dragon[0].y + sin(dragon[0].angle) * 5;
+                float vx = cos(angle) * (0.8 + rng.uniform() * 0.4);
+                float vy = sin(angle) * (0.8 + rng.uniform() * 0.4);
+                int max_life = 15 + rng.below(10);
+                bool large = rng.uniform() > 0.5;
+                // Green fire
+                int f = flames.spawn(x, y, vx, vy, max_life,
+                                     Color(fire_yellow.r * 0.5, fire_green.g, fire_emerald.b * 0.7));
+                if (f >= 0) flames.kind[f] = large;
             }
-        } else if (flames.size() >= 30 || fire_cooldown > 50) {
+        } else if (flames.count() >= 30 || fire_cooldown > 50) {
             breathing_fire = false;
         }
         
         // Update flames
-        for (auto it = flames.begin(); it != flames.end();) {
-            it->life++;
+        flames.age(1);
+        for (int i = 0; i < flames.count(); i++) {
+            float fade = flames.fade(i);
             
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                
-                int fx = (int)it->x;
-                int fy = (int)it->y;
+            int fx = (int)flames.x[i];
+            int fy = (int)flames.y[i];
+            
+            if (fx >= 0 && fx < width && fy >= 0 && fy < height) {
+                int r = flames.r[i] * fade;
+                int g = flames.g[i] * fade;
+                int b = flames.b[i] * fade;
+                canvas->SetPixel(fx, fy, r, g, b);
                 
-                if (fx >= 0 && fx < width && fy >= 0 && fy < height) {
-                    // Green fire
-                    int r = fire_yellow.r * fade * 0.5;
-                    int g = fire_green.g * fade;
-                    int b = fire_emerald.b * fade * 0.7;
-                    canvas->SetPixel(fx, fy, r, g, b);
-                    
-                    // Larger flames
-                    if (it->size > 1.5 && fx + 1 < width) {
-                        canvas->SetPixel(fx + 1, fy, r * 0.7, g * 0.7, b * 0.7);
-                    }
+                // Larger flames
+                if (flames.kind[i] && fx + 1 < width) {
+                    canvas->SetPixel(fx + 1, fy, r * 0.7, g * 0.7, b * 0.7);
                 }
-                
-                it->x += it->vx;
-                it->y += it->vy;
-                it->vy += 0.02; // Slight gravity
-                
-                ++it;
-            } else {
-                it = flames.erase(it);
             }
         }
+        flames.integrate(1, 0.02); // Slight gravity
     }
     
     void addMagicParticles() {
         // Magical aura around dragon
-        if (rand() % 3 == 0) {
+        if (rng.below(3) == 0) {
             for (size_t i = 0; i < dragon.size(); i += 2) {
-                MagicParticle mp;
-                mp.x = dragon[i].x + (rand() % 5 - 2);
-                mp.y = dragon[i].y + (rand() % 5 - 2);
-                mp.vx = ((float)rand() / RAND_MAX - 0.5) * 0.1;
-                mp.vy = -0.1 - (float)rand() / RAND_MAX * 0.1;
-                mp.life = 0;
-                mp.max_life = 20 + rand() % 15;
-                mp.hue = 100 + rand() % 80; // Green-cyan spectrum
-                particles.push_back(mp);
+                float x = dragon[i].x + (rng.below(5) - 2);
+                float y = dragon[i].y + (rng.below(5) - 2);
+                float vx = (rng.uniform() - 0.5) * 0.1;
+                float vy = -0.1 - rng.uniform() * 0.1;
+                int max_life = 20 + rng.below(15);
+                int p = particles.spawn(x, y, vx, vy, max_life, Color());
+                if (p >= 0) particles.kind[p] = 100 + rng.below(80); // Green-cyan spectrum
             }
         }
         
         // Update particles
-        for (auto it = particles.begin(); it != particles.end();) {
-            it->life++;
+        particles.age(1);
+        for (int i = 0; i < particles.count(); i++) {
+            int px = (int)particles.x[i];
+            int py = (int)particles.y[i];
             
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                
-                int px = (int)it->x;
-                int py = (int)it->y;
-                
-                if (px >= 0 && px < width && py >= 0 && py < height) {
-                    int r, g, b;
-                    HSVtoRGB(it->hue, 0.8, fade * 0.7, r, g, b);
-                    canvas->SetPixel(px, py, r, g, b);
-                }
-                
-                it->x += it->vx;
-                it->y += it->vy;
-                
-                ++it;
-            } else {
-                it = particles.erase(it);
+            if (px >= 0 && px < width && py >= 0 && py < height) {
+                int r, g, b;
+                HSVtoRGB(particles.kind[i], 0.8, particles.fade(i) * 0.7, r, g, b);
+                canvas->SetPixel(px, py, r, g, b);
             }
         }
+        particles.integrate(1);
     }
     
-    void update() {
+    int DefaultColumns() const { return 64; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawCaveBackground();
@@ -479,47 +422,8 @@ public:
         updateFireBreath();
         updateDragon();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 64;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    GreenDragonScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(GreenDragonScene)
@@ -1,21 +1,18 @@
+// Halloween Night Scene
+// Compilation: g++ -o halloween halloween.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/halloween.so halloween.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 struct Bat {
     float x;
     float y;
@@ -32,67 +29,58 @@ struct Ghost {
     int phase;
 };
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class HalloweenScene : public Scene {
+private:
     // Colors
-    Color bg_night(5, 0, 20);           // Dark purple/black night
-    Color moon(255, 255, 200);          // Pale yellow moon
-    Color ground(20, 10, 0);            // Dark brown ground
-    Color pumpkin_orange(255, 120, 0);  // Orange pumpkin
-    Color pumpkin_dark(180, 80, 0);     // Dark orange for shading
-    Color jack_face(255, 200, 0);       // Glowing jack-o-lantern face
-    Color ghost_white(230, 230, 230);   // White ghost
-    Color bat_black(50, 50, 50);        // Dark gray bat
-    Color grass(10, 40, 0);             // Dark grass
+    Color bg_night = Color(5, 0, 20);           // Dark purple/black night
+    Color moon = Color(255, 255, 200);          // Pale yellow moon
+    Color ground = Color(20, 10, 0);            // Dark brown ground
+    Color pumpkin_orange = Color(255, 120, 0);  // Orange pumpkin
+    Color pumpkin_dark = Color(180, 80, 0);     // Dark orange for shading
+    Color jack_face = Color(255, 200, 0);       // Glowing jack-o-lantern face
+    Color ghost_white = Color(230, 230, 230);   // White ghost
+    Color bat_black = Color(50, 50, 50);        // Dark gray bat
+    Color grass = Color(10, 40, 0);             // Dark grass
 
     // Initialize bats
-    const int num_bats = 4;
+    static const int num_bats = 4;
     Bat bats[num_bats];
-    for (int i = 0; i < num_bats; ++i) {
-        bats[i].x = rand() % 32;
-        bats[i].y = rand() % 15;
-        bats[i].speed_x = (rand() % 2 == 0 ? 1 : -1) * (0.3f + (rand() % 5) / 10.0f);
-        bats[i].speed_y = (rand() % 3 - 1) * 0.1f;
-        bats[i].wing_frame = rand() % 10;
-        bats[i].active = true;
-    }
 
     // Initialize ghosts
     Ghost ghosts[2];
-    ghosts[0].x = 6;
-    ghosts[0].y = 10;
-    ghosts[0].float_offset = 0;
-    ghosts[0].phase = 0;
 
-    ghosts[1].x = 20;
-    ghosts[1].y = 8;
-    ghosts[1].float_offset = 50;
-    ghosts[1].phase = 50;
+    int frame_count;
+    SceneRandom rng;
+
+public:
+    HalloweenScene() : frame_count(0) {}
 
-    int frame_count = 0;
+    void Init(int w, int h) {
+        rng.seed(Seed(), "halloween");
 
-    // Display until interrupted
-    while (running) {
+        // Initialize bats
+        for (int i = 0; i < num_bats; ++i) {
+            bats[i].x = rng.below(32);
+            bats[i].y = rng.below(15);
+            bats[i].speed_x = (rng.below(2) == 0 ? 1 : -1) * (0.3f + rng.below(5) / 10.0f);
+            bats[i].speed_y = (rng.below(3) - 1) * 0.1f;
+            bats[i].wing_frame = rng.below(10);
+            bats[i].active = true;
+        }
+
+        // Initialize ghosts
+        ghosts[0].x = 6;
+        ghosts[0].y = 10;
+        ghosts[0].float_offset = 0;
+        ghosts[0].phase = 0;
+
+        ghosts[1].x = 20;
+        ghosts[1].y = 8;
+        ghosts[1].float_offset = 50;
+        ghosts[1].phase = 50;
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with night sky
         canvas->Fill(bg_night.r, bg_night.g, bg_night.b);
 
@@ -257,12 +245,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(HalloweenScene)
@@ -1,5 +1,12 @@
+// Halloween Scenes - Graveyard, emerging hand and standing zombie
+// Compilation: g++ -o halloween_scenes halloween_scenes.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/halloween_scenes.so halloween_scenes.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "sprite.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
@@ -7,7 +14,7 @@
 #include <ctime>
 using namespace rgb_matrix;
 
-enum Scene {
+enum Stage {
     GRAVEYARD,
     TRANSITION_1,
     HAND_EMERGING,
@@ -22,81 +29,143 @@ struct Particle {
     bool active;
 };
 
-int main() {
-    srand(time(NULL));
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class HalloweenScenes : public Scene {
+private:
     // Colors
-    Color sky_night(10, 5, 30);
-    Color moon(255, 220, 150);
-    Color ground(25, 20, 15);
-    Color tombstone_gray(100, 100, 110);
-    Color tombstone_dark(60, 60, 70);
-    Color grass_dead(30, 40, 20);
-    Color zombie_green(100, 140, 80);
-    Color zombie_dark(60, 90, 50);
-    Color bone_white(220, 220, 200);
-    Color dirt_brown(70, 50, 30);
-    Color mist_purple(80, 60, 100);
+    Color sky_night = Color(10, 5, 30);
+    Color moon = Color(255, 220, 150);
+    Color ground = Color(25, 20, 15);
+    Color tombstone_gray = Color(100, 100, 110);
+    Color tombstone_dark = Color(60, 60, 70);
+    Color grass_dead = Color(30, 40, 20);
+    Color zombie_green = Color(100, 140, 80);
+    Color zombie_dark = Color(60, 90, 50);
+    Color bone_white = Color(220, 220, 200);
+    Color dirt_brown = Color(70, 50, 30);
+    Color mist_purple = Color(80, 60, 100);
+    
+    // Zombie hand and figure, drawn dimmed by the fade alpha
+    SpriteAtlas zombie_sprites;
+    int zombie_hand;
+    int zombie_arms_up;
+    int zombie_arms_forward;
     
     // Mist particles
-    const int num_mist = 10;
+    static const int num_mist = 10;
     Particle mist[num_mist];
-    for (int i = 0; i < num_mist; ++i) {
-        mist[i].x = rand() % 32;
-        mist[i].y = 20 + rand() % 10;
-        mist[i].speed = 0.05f + (rand() % 5) / 50.0f;
-        mist[i].active = true;
+    
+    Stage current_scene;
+    float elapsed;      // Seconds since start, drives the looping animations
+    float scene_timer;  // Seconds spent in the current stage
+    float hand_progress;
+    float transition_alpha;
+    SceneRandom rng;
+    
+public:
+    HalloweenScenes() : zombie_sprites({ {'G', zombie_green},
+                                         {'D', zombie_dark},
+                                         {'W', bone_white},
+                                         {'E', Color(255, 50, 50)},    // Glowing eyes
+                                         {'T', Color(100, 80, 70)} }), // Torn clothes
+                        current_scene(GRAVEYARD), elapsed(0.0f), scene_timer(0.0f),
+                        hand_progress(0.0f), transition_alpha(0.0f) {
+        // Fingers on top, knuckle bone showing through the palm, forearm below
+        zombie_hand = zombie_sprites.add({
+            "..G.",
+            ".DGD",
+            ".DGD",
+            ".DGD",
+            "DGGG",
+            "DGWG",
+            ".GG.",
+            ".GG.",
+            ".GG.",
+            ".GG."
+        });
+        zombie_arms_up = zombie_sprites.add({
+            "..GGG..",
+            "..EGE..",
+            "..GGG..",
+            ".GGGGG.",
+            "DGGGGGD",
+            "..GTG..",
+            "..TGG..",
+            "..GGG..",
+            "..D.D..",
+            "..D.D.."
+        });
+        zombie_arms_forward = zombie_sprites.add({
+            "..GGG..",
+            "..EGE..",
+            "..GGG..",
+            "..GGG..",
+            "DGGGGGD",
+            "..GTG..",
+            "..TGG..",
+            "..GGG..",
+            "..D.D..",
+            "..D.D.."
+        });
     }
     
-    Scene current_scene = GRAVEYARD;
-    int frame_count = 0;
-    int scene_timer = 0;
-    float hand_progress = 0.0f;
-    float transition_alpha = 0.0f;
+    void Init(int width, int height) {
+        rng.seed(Seed(), "halloween_scenes");
+        
+        for (int i = 0; i < num_mist; ++i) {
+            mist[i].x = rng.below(32);
+            mist[i].y = 20 + rng.below(10);
+            mist[i].speed = 0.05f + rng.below(5) / 50.0f;
+            mist[i].active = true;
+        }
+    }
     
-    while (true) {
-        scene_timer++;
+    void Update(float dt) {
+        elapsed += dt;
+        scene_timer += dt;
         
         // Scene transitions
-        if (current_scene == GRAVEYARD && scene_timer > 120) {
+        if (current_scene == GRAVEYARD && scene_timer > 6.0f) {
             current_scene = TRANSITION_1;
             scene_timer = 0;
-        } else if (current_scene == TRANSITION_1 && scene_timer > 20) {
+        } else if (current_scene == TRANSITION_1 && scene_timer > 1.0f) {
             current_scene = HAND_EMERGING;
             scene_timer = 0;
             hand_progress = 0.0f;
-        } else if (current_scene == HAND_EMERGING && scene_timer > 100) {
+        } else if (current_scene == HAND_EMERGING && scene_timer > 5.0f) {
             current_scene = TRANSITION_2;
             scene_timer = 0;
-        } else if (current_scene == TRANSITION_2 && scene_timer > 20) {
+        } else if (current_scene == TRANSITION_2 && scene_timer > 1.0f) {
             current_scene = ZOMBIE_STANDING;
             scene_timer = 0;
-        } else if (current_scene == ZOMBIE_STANDING && scene_timer > 120) {
+        } else if (current_scene == ZOMBIE_STANDING && scene_timer > 6.0f) {
             current_scene = GRAVEYARD;
             scene_timer = 0;
         }
         
         // Calculate transition
         if (current_scene == TRANSITION_1 || current_scene == TRANSITION_2) {
-            transition_alpha = scene_timer / 20.0f;
+            transition_alpha = scene_timer; // Transitions last one second
+            if (transition_alpha > 1.0f) transition_alpha = 1.0f;
         }
         
+        // Mist drifts while the graveyard is visible
+        if (current_scene == GRAVEYARD || current_scene == TRANSITION_1) {
+            for (int i = 0; i < num_mist; ++i) {
+                mist[i].x += mist[i].speed * dt * 20.0f;
+                if (mist[i].x > 32) mist[i].x = -2;
+            }
+        }
+        
+        if (current_scene == HAND_EMERGING) {
+            hand_progress += 0.3f * dt; // Fully out after ~3.3 s
+            if (hand_progress > 1.0f) hand_progress = 1.0f;
+        }
+    }
+    
+    void Render(Canvas *canvas) {
+        // Animation cycles below count 20 fps frames
+        const int frame_count = (int)(elapsed * 20.0f);
+        
         // SCENE 1: GRAVEYARD
         if (current_scene == GRAVEYARD || current_scene == TRANSITION_1) {
             float alpha = (current_scene == TRANSITION_1) ? (1.0f - transition_alpha) : 1.0f;
@@ -181,9 +250,6 @@ int main() {
             
             // Mist
             for (int i = 0; i < num_mist; ++i) {
-                mist[i].x += mist[i].speed;
-                if (mist[i].x > 32) mist[i].x = -2;
-                
                 int mx = (int)mist[i].x;
                 int my = (int)mist[i].y;
                 if (mx >= 0 && mx < 32 && my >= 0 && my < 32) {
@@ -204,11 +270,6 @@ int main() {
             if (current_scene == TRANSITION_1) alpha = transition_alpha;
             if (current_scene == TRANSITION_2) alpha = 1.0f - transition_alpha;
             
-            if (current_scene == HAND_EMERGING) {
-                hand_progress += 0.015f;
-                if (hand_progress > 1.0f) hand_progress = 1.0f;
-            }
-            
             // Dark background
             for (int y = 0; y < 32; ++y) {
                 for (int x = 0; x < 32; ++x) {
@@ -241,88 +302,7 @@ int main() {
             int hand_base_y = 16 - (int)(hand_progress * 6);
             int hand_x = 16;
             
-            // Wrist/forearm
-            for (int y = 0; y < 4; ++y) {
-                int wy = hand_base_y + 6 + y;
-                if (wy >= 0 && wy < 32) {
-                    canvas->SetPixel(hand_x - 1, wy,
-                                   (int)(zombie_green.r * alpha),
-                                   (int)(zombie_green.g * alpha),
-                                   (int)(zombie_green.b * alpha));
-                    canvas->SetPixel(hand_x, wy,
-                                   (int)(zombie_green.r * alpha),
-                                   (int)(zombie_green.g * alpha),
-                                   (int)(zombie_green.b * alpha));
-                }
-            }
-            
-            // Palm
-            for (int y = 0; y < 3; ++y) {
-                int py = hand_base_y + 3 + y;
-                if (py >= 0 && py < 32) {
-                    for (int x = -1; x <= 1; ++x) {
-                        canvas->SetPixel(hand_x + x, py,
-                                       (int)(zombie_green.r * alpha),
-                                       (int)(zombie_green.g * alpha),
-                                       (int)(zombie_green.b * alpha));
-                    }
-                }
-            }
-            
-            // Fingers (reaching up)
-            // Middle finger (longest)
-            for (int y = 0; y < 4; ++y) {
-                int fy = hand_base_y + y;
-                if (fy >= 0 && fy < 32) {
-                    canvas->SetPixel(hand_x, fy,
-                                   (int)(zombie_green.r * alpha),
-                                   (int)(zombie_green.g * alpha),
-                                   (int)(zombie_green.b * alpha));
-                }
-            }
-            
-            // Index finger
-            for (int y = 1; y < 4; ++y) {
-                int fy = hand_base_y + y;
-                if (fy >= 0 && fy < 32) {
-                    canvas->SetPixel(hand_x - 1, fy,
-                                   (int)(zombie_dark.r * alpha),
-                                   (int)(zombie_dark.g * alpha),
-                                   (int)(zombie_dark.b * alpha));
-                }
-            }
-            
-            // Ring finger
-            for (int y = 1; y < 4; ++y) {
-                int fy = hand_base_y + y;
-                if (fy >= 0 && fy < 32) {
-                    canvas->SetPixel(hand_x + 1, fy,
-                                   (int)(zombie_dark.r * alpha),
-                                   (int)(zombie_dark.g * alpha),
-                                   (int)(zombie_dark.b * alpha));
-                }
-            }
-            
-            // Thumb
-            int thumb_y = hand_base_y + 4;
-            if (thumb_y >= 0 && thumb_y < 32) {
-                canvas->SetPixel(hand_x - 2, thumb_y,
-                               (int)(zombie_dark.r * alpha),
-                               (int)(zombie_dark.g * alpha),
-                               (int)(zombie_dark.b * alpha));
-                canvas->SetPixel(hand_x - 2, thumb_y + 1,
-                               (int)(zombie_dark.r * alpha),
-                               (int)(zombie_dark.g * alpha),
-                               (int)(zombie_dark.b * alpha));
-            }
-            
-            // Bone showing through (knuckle)
-            if (hand_base_y + 5 >= 0 && hand_base_y + 5 < 32) {
-                canvas->SetPixel(hand_x, hand_base_y + 5,
-                               (int)(bone_white.r * alpha),
-                               (int)(bone_white.g * alpha),
-                               (int)(bone_white.b * alpha));
-            }
+            zombie_sprites.draw(canvas, zombie_hand, hand_x - 2, hand_base_y, false, alpha);
         }
         
         // SCENE 3: ZOMBIE STANDING
@@ -364,63 +344,12 @@ int main() {
             int zx = 16;
             int zy = 24;
             
-            // Legs
-            canvas->SetPixel(zx - 1, zy, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-            canvas->SetPixel(zx + 1, zy, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-            canvas->SetPixel(zx - 1, zy + 1, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-            canvas->SetPixel(zx + 1, zy + 1, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-            
-            // Body
-            for (int y = -6; y <= -1; ++y) {
-                for (int x = -1; x <= 1; ++x) {
-                    canvas->SetPixel(zx + x, zy + y,
-                                   (int)(zombie_green.r * alpha),
-                                   (int)(zombie_green.g * alpha),
-                                   (int)(zombie_green.b * alpha));
-                }
-            }
-            
-            // Arms (reaching forward menacingly)
+            // Arms alternate between raised and reaching forward menacingly
             bool arms_up = (frame_count / 15) % 2 == 0;
-            if (arms_up) {
-                // Left arm up
-                canvas->SetPixel(zx - 2, zy - 5, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-                canvas->SetPixel(zx - 2, zy - 4, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-                canvas->SetPixel(zx - 3, zy - 4, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-                // Right arm up
-                canvas->SetPixel(zx + 2, zy - 5, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-                canvas->SetPixel(zx + 2, zy - 4, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-                canvas->SetPixel(zx + 3, zy - 4, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-            } else {
-                // Arms forward
-                canvas->SetPixel(zx - 2, zy - 4, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-                canvas->SetPixel(zx - 3, zy - 4, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-                canvas->SetPixel(zx + 2, zy - 4, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-                canvas->SetPixel(zx + 3, zy - 4, (int)(zombie_dark.r * alpha), (int)(zombie_dark.g * alpha), (int)(zombie_dark.b * alpha));
-            }
-            
-            // Head
-            canvas->SetPixel(zx - 1, zy - 7, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-            canvas->SetPixel(zx, zy - 7, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-            canvas->SetPixel(zx + 1, zy - 7, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-            canvas->SetPixel(zx - 1, zy - 8, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-            canvas->SetPixel(zx, zy - 8, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-            canvas->SetPixel(zx + 1, zy - 8, (int)(zombie_green.r * alpha), (int)(zombie_green.g * alpha), (int)(zombie_green.b * alpha));
-            
-            // Glowing red eyes
-            canvas->SetPixel(zx - 1, zy - 7, (int)(255 * alpha), (int)(50 * alpha), (int)(50 * alpha));
-            canvas->SetPixel(zx + 1, zy - 7, (int)(255 * alpha), (int)(50 * alpha), (int)(50 * alpha));
-            
-            // Torn clothes
-            canvas->SetPixel(zx, zy - 3, (int)(100 * alpha), (int)(80 * alpha), (int)(70 * alpha));
-            canvas->SetPixel(zx - 1, zy - 2, (int)(100 * alpha), (int)(80 * alpha), (int)(70 * alpha));
+            zombie_sprites.draw(canvas, arms_up ? zombie_arms_up : zombie_arms_forward,
+                                zx - 3, zy - 8, false, alpha);
         }
-        
-        frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(HalloweenScenes)
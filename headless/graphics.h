@@ -0,0 +1,71 @@
+// -*- mode: c++; c-basic-offset: 2; indent-tabs-mode: nil; -*-
+// Headless stand-in for rpi-rgb-led-matrix's graphics.h: colors, BDF fonts
+// and the simple drawing primitives the scenes use.
+
+#ifndef RGB_HEADLESS_GRAPHICS_H
+#define RGB_HEADLESS_GRAPHICS_H
+
+#include "led-matrix.h"
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+namespace rgb_matrix {
+
+struct Color {
+  Color() : r(0), g(0), b(0) {}
+  Color(uint8_t rr, uint8_t gg, uint8_t bb) : r(rr), g(gg), b(bb) {}
+  bool operator==(const Color &other) const {
+    return r == other.r && g == other.g && b == other.b;
+  }
+  bool operator!=(const Color &other) const { return !(*this == other); }
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+class Font {
+public:
+  Font();
+
+  bool LoadFont(const char *path);
+  int height() const { return font_height_; }
+  int baseline() const { return base_line_; }
+  int CharacterWidth(uint32_t unicode_codepoint) const;
+
+  int DrawGlyph(Canvas *c, int x, int y,
+                const Color &color, const Color *background_color,
+                uint32_t unicode_codepoint) const;
+  int DrawGlyph(Canvas *c, int x, int y, const Color &color,
+                uint32_t unicode_codepoint) const;
+
+private:
+  struct Glyph {
+    int device_width;
+    int width, height;
+    int x_offset, y_offset;
+    std::vector<uint32_t> rows;  // MSB-first bitmap, one word per row.
+  };
+  const Glyph *FindGlyph(uint32_t codepoint) const;
+
+  int font_height_;
+  int base_line_;
+  std::map<uint32_t, Glyph> glyphs_;
+};
+
+int DrawText(Canvas *c, const Font &font, int x, int y,
+             const Color &color, const char *utf8_text);
+int DrawText(Canvas *c, const Font &font, int x, int y,
+             const Color &color, const Color *background_color,
+             const char *utf8_text, int kerning_offset = 0);
+int VerticalDrawText(Canvas *c, const Font &font, int x, int y,
+                     const Color &color, const Color *background_color,
+                     const char *utf8_text, int kerning_offset = 0);
+
+void DrawCircle(Canvas *c, int x, int y, int radius, const Color &color);
+void DrawLine(Canvas *c, int x0, int y0, int x1, int y1, const Color &color);
+
+}  // namespace rgb_matrix
+
+#endif  // RGB_HEADLESS_GRAPHICS_H
@@ -0,0 +1,457 @@
+// -*- mode: c++; c-basic-offset: 2; indent-tabs-mode: nil; -*-
+// Software implementation of the headless rgb_matrix stand-in.
+
+#include "led-matrix.h"
+#include "graphics.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+namespace rgb_matrix {
+
+// -- FrameCanvas -------------------------------------------------------------
+
+FrameCanvas::FrameCanvas(int width, int height)
+  : width_(width), height_(height), pwm_bits_(11), brightness_(100),
+    pixels_(width * height * 3, 0) {
+}
+
+void FrameCanvas::SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue) {
+  if (x < 0 || x >= width_ || y < 0 || y >= height_) return;
+  uint8_t *p = &pixels_[(y * width_ + x) * 3];
+  p[0] = red;
+  p[1] = green;
+  p[2] = blue;
+}
+
+void FrameCanvas::Clear() {
+  std::fill(pixels_.begin(), pixels_.end(), 0);
+}
+
+void FrameCanvas::Fill(uint8_t red, uint8_t green, uint8_t blue) {
+  for (size_t i = 0; i < pixels_.size(); i += 3) {
+    pixels_[i] = red;
+    pixels_[i + 1] = green;
+    pixels_[i + 2] = blue;
+  }
+}
+
+void FrameCanvas::Serialize(const char **data, size_t *len) const {
+  *data = reinterpret_cast<const char*>(&pixels_[0]);
+  *len = pixels_.size();
+}
+
+bool FrameCanvas::Deserialize(const char *data, size_t len) {
+  if (len != pixels_.size()) return false;
+  memcpy(&pixels_[0], data, len);
+  return true;
+}
+
+void FrameCanvas::CopyFrom(const FrameCanvas &other) {
+  if (&other == this) return;
+  width_ = other.width_;
+  height_ = other.height_;
+  pwm_bits_ = other.pwm_bits_;
+  brightness_ = other.brightness_;
+  pixels_ = other.pixels_;
+}
+
+// -- Options -----------------------------------------------------------------
+
+RuntimeOptions::RuntimeOptions()
+  : gpio_slowdown(1), daemon(0), drop_privileges(1), do_gpio_init(true),
+    drop_priv_user(NULL), drop_priv_group(NULL) {
+}
+
+RGBMatrix::Options::Options()
+  : hardware_mapping("regular"), rows(32), cols(32), chain_length(1),
+    parallel(1), pwm_bits(11), pwm_lsb_nanoseconds(130), pwm_dither_bits(0),
+    brightness(100), scan_mode(0), row_address_type(0), multiplexing(0),
+    disable_hardware_pulsing(false), show_refresh_rate(false),
+    inverse_colors(false), led_rgb_sequence("RGB"), pixel_mapper_config(NULL),
+    panel_type(NULL), limit_refresh_rate_hz(0) {
+}
+
+bool RGBMatrix::Options::Validate(const char **err) const {
+  if (rows <= 0 || cols <= 0 || chain_length <= 0 || parallel <= 0) {
+    if (err) *err = "rows, cols, chain and parallel need to be positive";
+    return false;
+  }
+  if (brightness < 1 || brightness > 100) {
+    if (err) *err = "brightness outside usable range (1..100)";
+    return false;
+  }
+  return true;
+}
+
+// -- RGBMatrix ---------------------------------------------------------------
+
+RGBMatrix::RGBMatrix(const Options &options)
+  : options_(options), active_(NULL), swap_count_(0) {
+  active_ = CreateFrameCanvas();
+}
+
+RGBMatrix::~RGBMatrix() {
+  for (size_t i = 0; i < created_.size(); ++i) delete created_[i];
+}
+
+RGBMatrix *RGBMatrix::CreateFromOptions(const Options &options,
+                                        const RuntimeOptions &runtime_options) {
+  const char *err = NULL;
+  if (!options.Validate(&err)) {
+    fprintf(stderr, "%s\n", err);
+    return NULL;
+  }
+  return new RGBMatrix(options);
+}
+
+int RGBMatrix::width() const {
+  return options_.cols * options_.chain_length;
+}
+
+int RGBMatrix::height() const {
+  return options_.rows * options_.parallel;
+}
+
+void RGBMatrix::SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue) {
+  active_->SetPixel(x, y, red, green, blue);
+}
+
+void RGBMatrix::Clear() { active_->Clear(); }
+
+void RGBMatrix::Fill(uint8_t red, uint8_t green, uint8_t blue) {
+  active_->Fill(red, green, blue);
+}
+
+FrameCanvas *RGBMatrix::CreateFrameCanvas() {
+  FrameCanvas *canvas = new FrameCanvas(width(), height());
+  canvas->SetPWMBits(options_.pwm_bits);
+  canvas->SetBrightness(options_.brightness);
+  created_.push_back(canvas);
+  return canvas;
+}
+
+FrameCanvas *RGBMatrix::SwapOnVSync(FrameCanvas *other, unsigned framerate_fraction) {
+  FrameCanvas *previous = active_;
+  if (other) active_ = other;
+  ++swap_count_;
+  return previous;
+}
+
+bool RGBMatrix::SetPWMBits(uint8_t value) {
+  if (value < 1 || value > 11) return false;
+  options_.pwm_bits = value;
+  return active_->SetPWMBits(value);
+}
+
+uint8_t RGBMatrix::pwmbits() { return options_.pwm_bits; }
+
+void RGBMatrix::SetBrightness(uint8_t brightness) {
+  options_.brightness = brightness;
+  active_->SetBrightness(brightness);
+}
+
+uint8_t RGBMatrix::brightness() { return options_.brightness; }
+
+// -- Flags -------------------------------------------------------------------
+
+namespace {
+bool IntFlag(const std::string &value, int *out) {
+  char *end = NULL;
+  long v = strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0') return false;
+  *out = (int)v;
+  return true;
+}
+}  // namespace
+
+bool ParseOptionsFromFlags(int *argc, char ***argv,
+                           RGBMatrix::Options *mopt, RuntimeOptions *ropt,
+                           bool remove_consumed_options) {
+  RGBMatrix::Options scratch_mopt;
+  RuntimeOptions scratch_ropt;
+  if (mopt == NULL) mopt = &scratch_mopt;
+  if (ropt == NULL) ropt = &scratch_ropt;
+
+  std::vector<char*> kept;
+  kept.push_back((*argv)[0]);
+  bool ok = true;
+  for (int i = 1; i < *argc; ++i) {
+    std::string arg = (*argv)[i];
+    if (arg.compare(0, 6, "--led-") != 0) {
+      kept.push_back((*argv)[i]);
+      continue;
+    }
+    std::string name = arg.substr(6);
+    std::string value;
+    const size_t eq = name.find('=');
+    if (eq != std::string::npos) {
+      value = name.substr(eq + 1);
+      name = name.substr(0, eq);
+    }
+
+    // Boolean flags.
+    if (name == "daemon") { ropt->daemon = 1; continue; }
+    if (name == "no-daemon") { ropt->daemon = 0; continue; }
+    if (name == "no-drop-privs") { ropt->drop_privileges = -1; continue; }
+    if (name == "drop-privs") { ropt->drop_privileges = 1; continue; }
+    if (name == "show-refresh") { mopt->show_refresh_rate = true; continue; }
+    if (name == "inverse") { mopt->inverse_colors = true; continue; }
+    if (name == "no-hardware-pulse") { mopt->disable_hardware_pulsing = true; continue; }
+
+    if (eq == std::string::npos) {
+      if (i + 1 >= *argc) {
+        fprintf(stderr, "Flag --led-%s needs a value\n", name.c_str());
+        ok = false;
+        continue;
+      }
+      value = (*argv)[++i];
+    }
+
+    // String flags keep pointing into argv, like the real library.
+    const char *str = strchr((*argv)[i], '=') ? strchr((*argv)[i], '=') + 1 : (*argv)[i];
+    bool valid = true;
+    if (name == "rows") valid = IntFlag(value, &mopt->rows);
+    else if (name == "cols") valid = IntFlag(value, &mopt->cols);
+    else if (name == "chain") valid = IntFlag(value, &mopt->chain_length);
+    else if (name == "parallel") valid = IntFlag(value, &mopt->parallel);
+    else if (name == "pwm-bits") valid = IntFlag(value, &mopt->pwm_bits);
+    else if (name == "pwm-lsb-nanoseconds") valid = IntFlag(value, &mopt->pwm_lsb_nanoseconds);
+    else if (name == "pwm-dither-bits") valid = IntFlag(value, &mopt->pwm_dither_bits);
+    else if (name == "brightness") valid = IntFlag(value, &mopt->brightness);
+    else if (name == "scan-mode") valid = IntFlag(value, &mopt->scan_mode);
+    else if (name == "row-addr-type") valid = IntFlag(value, &mopt->row_address_type);
+    else if (name == "multiplexing") valid = IntFlag(value, &mopt->multiplexing);
+    else if (name == "limit-refresh") valid = IntFlag(value, &mopt->limit_refresh_rate_hz);
+    else if (name == "slowdown-gpio") valid = IntFlag(value, &ropt->gpio_slowdown);
+    else if (name == "gpio-mapping") mopt->hardware_mapping = str;
+    else if (name == "rgb-sequence") mopt->led_rgb_sequence = str;
+    else if (name == "pixel-mapper") mopt->pixel_mapper_config = str;
+    else if (name == "panel-type") mopt->panel_type = str;
+    else {
+      fprintf(stderr, "Unknown flag --led-%s\n", name.c_str());
+      valid = false;
+    }
+    if (!valid) {
+      fprintf(stderr, "Invalid value for --led-%s: %s\n", name.c_str(), value.c_str());
+      ok = false;
+    }
+  }
+
+  if (remove_consumed_options) {
+    for (size_t i = 0; i < kept.size(); ++i) (*argv)[i] = kept[i];
+    *argc = (int)kept.size();
+    (*argv)[*argc] = NULL;
+  }
+  return ok;
+}
+
+RGBMatrix *CreateMatrixFromOptions(const RGBMatrix::Options &options,
+                                   const RuntimeOptions &runtime_options) {
+  return RGBMatrix::CreateFromOptions(options, runtime_options);
+}
+
+RGBMatrix *CreateMatrixFromFlags(int *argc, char ***argv,
+                                 RGBMatrix::Options *default_options,
+                                 RuntimeOptions *default_runtime_options,
+                                 bool remove_consumed_options) {
+  RGBMatrix::Options mopt;
+  RuntimeOptions ropt;
+  if (default_options) mopt = *default_options;
+  if (default_runtime_options) ropt = *default_runtime_options;
+  if (!ParseOptionsFromFlags(argc, argv, &mopt, &ropt, remove_consumed_options)) {
+    return NULL;
+  }
+  return CreateMatrixFromOptions(mopt, ropt);
+}
+
+void PrintMatrixFlags(FILE *out, const RGBMatrix::Options &d,
+                      const RuntimeOptions &r) {
+  fprintf(out,
+          "\t--led-rows=<rows>        : Panel rows (default: %d)\n"
+          "\t--led-cols=<cols>        : Panel columns (default: %d)\n"
+          "\t--led-chain=<chained>    : Number of daisy-chained panels (default: %d)\n"
+          "\t--led-parallel=<parallel>: Parallel chains (default: %d)\n"
+          "\t--led-brightness=<percent>: Brightness in percent (default: %d)\n"
+          "\t--led-gpio-mapping=<name>: Accepted and ignored (headless build)\n"
+          "\t--led-slowdown-gpio=<0..4>: Accepted and ignored (headless build)\n"
+          "\t--led-daemon             : Accepted and ignored (headless build)\n",
+          d.rows, d.cols, d.chain_length, d.parallel, d.brightness);
+}
+
+// -- Fonts -------------------------------------------------------------------
+
+static const uint32_t kUnicodeReplacementCodepoint = 0xFFFD;
+
+Font::Font() : font_height_(-1), base_line_(0) {
+}
+
+bool Font::LoadFont(const char *path) {
+  if (path == NULL || *path == '\0') return false;
+  FILE *f = fopen(path, "r");
+  if (f == NULL) return false;
+
+  char line[1024];
+  Glyph glyph;
+  uint32_t codepoint = 0;
+  int bitmap_row = -1;
+  while (fgets(line, sizeof(line), f)) {
+    int a, b, c, d;
+    if (sscanf(line, "FONTBOUNDINGBOX %d %d %d %d", &a, &b, &c, &d) == 4) {
+      font_height_ = b;
+      base_line_ = b + d;
+    } else if (sscanf(line, "ENCODING %d", &a) == 1) {
+      codepoint = a;
+    } else if (sscanf(line, "DWIDTH %d %d", &a, &b) == 2) {
+      glyph.device_width = a;
+    } else if (sscanf(line, "BBX %d %d %d %d", &a, &b, &c, &d) == 4) {
+      glyph.width = a;
+      glyph.height = b;
+      glyph.x_offset = c;
+      glyph.y_offset = d;
+      glyph.rows.assign(b, 0);
+    } else if (strncmp(line, "BITMAP", 6) == 0) {
+      bitmap_row = 0;
+    } else if (strncmp(line, "ENDCHAR", 7) == 0) {
+      glyphs_[codepoint] = glyph;
+      glyph = Glyph();
+      bitmap_row = -1;
+    } else if (bitmap_row >= 0 && bitmap_row < (int)glyph.rows.size()) {
+      // Hex rows are left-aligned to whole bytes; place column 0 at bit 31
+      // and apply the glyph's x offset.
+      const int hex_digits = strspn(line, "0123456789abcdefABCDEF");
+      uint32_t bits = strtoul(std::string(line, hex_digits).c_str(), NULL, 16);
+      const int shift = 32 - hex_digits * 4 - glyph.x_offset;
+      glyph.rows[bitmap_row++] = shift >= 0 ? bits << shift : bits >> -shift;
+    }
+  }
+  fclose(f);
+  return font_height_ > 0 && !glyphs_.empty();
+}
+
+const Font::Glyph *Font::FindGlyph(uint32_t codepoint) const {
+  std::map<uint32_t, Glyph>::const_iterator it = glyphs_.find(codepoint);
+  return it == glyphs_.end() ? NULL : &it->second;
+}
+
+int Font::CharacterWidth(uint32_t unicode_codepoint) const {
+  const Glyph *g = FindGlyph(unicode_codepoint);
+  return g ? g->device_width : -1;
+}
+
+int Font::DrawGlyph(Canvas *c, int x_pos, int y_pos,
+                    const Color &color, const Color *bgcolor,
+                    uint32_t unicode_codepoint) const {
+  const Glyph *g = FindGlyph(unicode_codepoint);
+  if (g == NULL) g = FindGlyph(kUnicodeReplacementCodepoint);
+  if (g == NULL) return 0;
+  y_pos = y_pos - g->height - g->y_offset;
+  for (int y = 0; y < g->height; ++y) {
+    const uint32_t row = g->rows[y];
+    for (int x = 0; x < g->device_width && x < 32; ++x) {
+      if (row & (0x80000000u >> x)) {
+        c->SetPixel(x_pos + x, y_pos + y, color.r, color.g, color.b);
+      } else if (bgcolor) {
+        c->SetPixel(x_pos + x, y_pos + y, bgcolor->r, bgcolor->g, bgcolor->b);
+      }
+    }
+  }
+  return g->device_width;
+}
+
+int Font::DrawGlyph(Canvas *c, int x_pos, int y_pos, const Color &color,
+                    uint32_t unicode_codepoint) const {
+  return DrawGlyph(c, x_pos, y_pos, color, NULL, unicode_codepoint);
+}
+
+// -- Drawing -----------------------------------------------------------------
+
+static uint32_t NextCodepoint(const char **it) {
+  const unsigned char *p = reinterpret_cast<const unsigned char*>(*it);
+  uint32_t cp;
+  if (p[0] < 0x80) {
+    cp = p[0];
+    *it += 1;
+  } else if ((p[0] & 0xE0) == 0xC0 && p[1]) {
+    cp = ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+    *it += 2;
+  } else if ((p[0] & 0xF0) == 0xE0 && p[1] && p[2]) {
+    cp = ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+    *it += 3;
+  } else if ((p[0] & 0xF8) == 0xF0 && p[1] && p[2] && p[3]) {
+    cp = ((p[0] & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+    *it += 4;
+  } else {
+    cp = kUnicodeReplacementCodepoint;
+    *it += 1;
+  }
+  return cp;
+}
+
+int DrawText(Canvas *c, const Font &font, int x, int y,
+             const Color &color, const char *utf8_text) {
+  return DrawText(c, font, x, y, color, NULL, utf8_text, 0);
+}
+
+int DrawText(Canvas *c, const Font &font, int x, int y,
+             const Color &color, const Color *background_color,
+             const char *utf8_text, int extra_spacing) {
+  const int start_x = x;
+  while (*utf8_text) {
+    const uint32_t cp = NextCodepoint(&utf8_text);
+    x += font.DrawGlyph(c, x, y, color, background_color, cp);
+    x += extra_spacing;
+  }
+  return x - start_x;
+}
+
+int VerticalDrawText(Canvas *c, const Font &font, int x, int y,
+                     const Color &color, const Color *background_color,
+                     const char *utf8_text, int extra_spacing) {
+  const int start_y = y;
+  while (*utf8_text) {
+    const uint32_t cp = NextCodepoint(&utf8_text);
+    font.DrawGlyph(c, x, y, color, background_color, cp);
+    y += font.height() + extra_spacing;
+  }
+  return y - start_y;
+}
+
+void DrawCircle(Canvas *c, int x0, int y0, int radius, const Color &color) {
+  int x = radius, y = 0;
+  int radius_error = 1 - x;
+  while (y <= x) {
+    c->SetPixel(x + x0, y + y0, color.r, color.g, color.b);
+    c->SetPixel(y + x0, x + y0, color.r, color.g, color.b);
+    c->SetPixel(-x + x0, y + y0, color.r, color.g, color.b);
+    c->SetPixel(-y + x0, x + y0, color.r, color.g, color.b);
+    c->SetPixel(-x + x0, -y + y0, color.r, color.g, color.b);
+    c->SetPixel(-y + x0, -x + y0, color.r, color.g, color.b);
+    c->SetPixel(x + x0, -y + y0, color.r, color.g, color.b);
+    c->SetPixel(y + x0, -x + y0, color.r, color.g, color.b);
+    y++;
+    if (radius_error < 0) {
+      radius_error += 2 * y + 1;
+    } else {
+      x--;
+      radius_error += 2 * (y - x + 1);
+    }
+  }
+}
+
+void DrawLine(Canvas *c, int x0, int y0, int x1, int y1, const Color &color) {
+  const int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  const int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+  for (;;) {
+    c->SetPixel(x0, y0, color.r, color.g, color.b);
+    if (x0 == x1 && y0 == y1) break;
+    const int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+}  // namespace rgb_matrix
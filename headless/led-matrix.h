@@ -0,0 +1,153 @@
+// -*- mode: c++; c-basic-offset: 2; indent-tabs-mode: nil; -*-
+// Headless stand-in for rpi-rgb-led-matrix's led-matrix.h.
+//
+// Implements the subset of the rgb_matrix API the scenes use on top of plain
+// RGB buffers, so every scene builds and runs on an ordinary Linux box:
+//
+//   g++ -c -Iheadless -o headless_matrix.o headless/headless_matrix.cpp -std=c++11
+//   g++ -c -Iheadless -o rgbscene.o rgbscene.cpp -std=c++11
+//   ar rcs libheadless.a headless_matrix.o rgbscene.o
+//   g++ -Iheadless -o matrix matrix.cpp -L. -lheadless -std=c++11
+//
+// SwapOnVSync() does not wait for anything, so scenes run as fast as their
+// frame pacing allows.
+
+#ifndef RGB_HEADLESS_LED_MATRIX_H
+#define RGB_HEADLESS_LED_MATRIX_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <vector>
+
+namespace rgb_matrix {
+
+class Canvas {
+public:
+  virtual ~Canvas() {}
+  virtual int width() const = 0;
+  virtual int height() const = 0;
+  virtual void SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue) = 0;
+  virtual void Clear() = 0;
+  virtual void Fill(uint8_t red, uint8_t green, uint8_t blue) = 0;
+};
+
+class FrameCanvas : public Canvas {
+public:
+  FrameCanvas(int width, int height);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  void SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue);
+  void Clear();
+  void Fill(uint8_t red, uint8_t green, uint8_t blue);
+
+  bool SetPWMBits(uint8_t value) { pwm_bits_ = value; return value > 0 && value <= 11; }
+  uint8_t pwmbits() { return pwm_bits_; }
+  void SetBrightness(uint8_t brightness) { brightness_ = brightness; }
+  uint8_t brightness() { return brightness_; }
+
+  void Serialize(const char **data, size_t *len) const;
+  bool Deserialize(const char *data, size_t len);
+  void CopyFrom(const FrameCanvas &other);
+
+  // Headless only: packed RGB rows, width() * height() * 3 bytes.
+  const uint8_t *pixels() const { return &pixels_[0]; }
+
+private:
+  int width_, height_;
+  uint8_t pwm_bits_;
+  uint8_t brightness_;
+  std::vector<uint8_t> pixels_;
+};
+
+struct RuntimeOptions {
+  RuntimeOptions();
+
+  int gpio_slowdown;
+  int daemon;
+  int drop_privileges;
+  bool do_gpio_init;
+  const char *drop_priv_user;
+  const char *drop_priv_group;
+};
+
+class RGBMatrix : public Canvas {
+public:
+  struct Options {
+    Options();
+    bool Validate(const char **err) const;
+
+    const char *hardware_mapping;
+    int rows;
+    int cols;
+    int chain_length;
+    int parallel;
+    int pwm_bits;
+    int pwm_lsb_nanoseconds;
+    int pwm_dither_bits;
+    int brightness;
+    int scan_mode;
+    int row_address_type;
+    int multiplexing;
+    bool disable_hardware_pulsing;
+    bool show_refresh_rate;
+    bool inverse_colors;
+    const char *led_rgb_sequence;
+    const char *pixel_mapper_config;
+    const char *panel_type;
+    int limit_refresh_rate_hz;
+  };
+
+  static RGBMatrix *CreateFromOptions(const Options &options,
+                                      const RuntimeOptions &runtime_options);
+  ~RGBMatrix();
+
+  int width() const;
+  int height() const;
+  void SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue);
+  void Clear();
+  void Fill(uint8_t red, uint8_t green, uint8_t blue);
+
+  FrameCanvas *CreateFrameCanvas();
+  FrameCanvas *SwapOnVSync(FrameCanvas *other, unsigned framerate_fraction = 1);
+
+  bool SetPWMBits(uint8_t value);
+  uint8_t pwmbits();
+  void SetBrightness(uint8_t brightness);
+  uint8_t brightness();
+
+  // Headless only: the canvas most recently passed to SwapOnVSync() and the
+  // number of swaps so far.
+  const FrameCanvas *displayed() const { return active_; }
+  unsigned long swap_count() const { return swap_count_; }
+
+private:
+  explicit RGBMatrix(const Options &options);
+
+  Options options_;
+  FrameCanvas *active_;
+  std::vector<FrameCanvas*> created_;
+  unsigned long swap_count_;
+};
+
+bool ParseOptionsFromFlags(int *argc, char ***argv,
+                           RGBMatrix::Options *default_options,
+                           RuntimeOptions *rt_options,
+                           bool remove_consumed_options = true);
+
+RGBMatrix *CreateMatrixFromOptions(const RGBMatrix::Options &options,
+                                   const RuntimeOptions &runtime_options);
+
+RGBMatrix *CreateMatrixFromFlags(int *argc, char ***argv,
+                                 RGBMatrix::Options *default_options = NULL,
+                                 RuntimeOptions *default_runtime_options = NULL,
+                                 bool remove_consumed_options = true);
+
+void PrintMatrixFlags(FILE *out,
+                      const RGBMatrix::Options &defaults = RGBMatrix::Options(),
+                      const RuntimeOptions &rt_opt = RuntimeOptions());
+
+}  // namespace rgb_matrix
+
+#endif  // RGB_HEADLESS_LED_MATRIX_H
@@ -7,24 +7,313 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <spawn.h>
+#include <sys/syscall.h>
 #include <sstream>
 #include <cstring>
+#include <algorithm>
+#include <set>
+
+extern char **environ;
+
+// Minimum time between restarts of a program that keeps dying, unless
+// --restart-backoff says otherwise
+static const int kRestartBackoffSeconds = 30;
+
+// How long a program gets to run its SIGTERM cleanup before SIGKILL
+static const int kStopGraceMillis = 2000;
+
+static std::string describeExit(int status) {
+    if (WIFEXITED(status)) return "exit code " + std::to_string(WEXITSTATUS(status));
+    if (WIFSIGNALED(status)) return std::string("signal ") + strsignal(WTERMSIG(status));
+    return "status " + std::to_string(status);
+}
+
+// The compiled font next to a BDF font (same name, .rgbf, made by fontc)
+// if there is one, since mapping it starts faster than parsing the BDF
+static std::string preferCompiledFont(const std::string& bdf_path) {
+    const size_t dot = bdf_path.rfind('.');
+    const std::string compiled = bdf_path.substr(0, dot) + ".rgbf";
+    return access(compiled.c_str(), R_OK) == 0 ? compiled : bdf_path;
+}
+
+// Waits up to timeout_ms for pid to exit; pidfd may be -1 (kernel < 5.3)
+static bool waitForExit(pid_t pid, int pidfd, int timeout_ms, int* status) {
+    if (pidfd >= 0) {
+        struct pollfd pfd = { pidfd, POLLIN, 0 };
+        poll(&pfd, 1, timeout_ms);
+        return waitpid(pid, status, WNOHANG) == pid;
+    }
+    for (int waited = 0; ; waited += 10) {
+        if (waitpid(pid, status, WNOHANG) == pid) return true;
+        if (waited >= timeout_ms) return false;
+        usleep(10 * 1000);
+    }
+}
+
+// Runs path with args to completion and returns what it printed on stdout;
+// empty if it could not be started or did not exit with status 0
+static std::string captureOutput(const std::string& path, const std::vector<std::string>& args) {
+    int fds[2];
+    if (pipe(fds) != 0) return "";
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(path.c_str()));
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t unblocked;
+    sigemptyset(&unblocked);
+    posix_spawnattr_setsigmask(&attr, &unblocked);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+    pid_t child;
+    int rc = posix_spawn(&child, path.c_str(), &actions, &attr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    close(fds[1]);
+
+    std::string output;
+    if (rc == 0) {
+        char buffer[256];
+        ssize_t n;
+        while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) {
+            output.append(buffer, n);
+        }
+    }
+    close(fds[0]);
+
+    // Waited for by pid, so the panel child is never reaped here
+    int status;
+    if (rc != 0 || waitpid(child, &status, 0) != child ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return "";
+    }
+    return output;
+}
+
+// Owns the single child process that drives the panel: spawns it without a
+// shell, watches it through a pidfd and stops it with SIGTERM, escalating to
+// SIGKILL only when the grace period runs out.
+class ChildSupervisor {
+private:
+    pid_t pid;
+    int pidfd;
+    std::string program;
+
+    void forget() {
+        if (pidfd >= 0) close(pidfd);
+        pid = 0;
+        pidfd = -1;
+        program.clear();
+    }
+
+public:
+    ChildSupervisor() : pid(0), pidfd(-1) {}
+    ~ChildSupervisor() { if (pidfd >= 0) close(pidfd); }
+
+    bool running() const { return pid > 0; }
+    const std::string& name() const { return program; }
+    int fd() const { return pidfd; }
+
+    // Starts path with args; stdout/stderr go to /dev/null and the child
+    // gets an empty signal mask. Exec failures are reported here.
+    bool spawn(const std::string& name, const std::string& path,
+               const std::vector<std::string>& args, std::string* error) {
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(path.c_str()));
+        for (const auto& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t unblocked;
+        sigemptyset(&unblocked);
+        posix_spawnattr_setsigmask(&attr, &unblocked);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+        pid_t child;
+        int rc = posix_spawn(&child, path.c_str(), &actions, &attr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attr);
+        if (rc != 0) {
+            *error = strerror(rc);
+            return false;
+        }
+
+        pid = child;
+        program = name;
+#ifdef SYS_pidfd_open
+        pidfd = syscall(SYS_pidfd_open, child, 0);
+#endif
+        return true;
+    }
+
+    // Reaps the child if it has exited; fills status and returns true then.
+    // Only this class may wait for the child: once it is reaped elsewhere
+    // its pidfd stays readable and the pid goes stale.
+    bool reap(int* status) {
+        if (pid <= 0) return false;
+        pid_t reaped = waitpid(pid, status, WNOHANG);
+        if (reaped == 0 || (reaped < 0 && errno != ECHILD)) return false;
+        if (reaped < 0) *status = 0; // Already gone, exit status lost
+        forget();
+        return true;
+    }
+
+    // SIGTERM, then SIGKILL after grace_ms; returns the exit status
+    int stop(int grace_ms) {
+        int status = 0;
+        if (pid <= 0) return status;
+        kill(pid, SIGTERM);
+        if (!waitForExit(pid, pidfd, grace_ms, &status)) {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+        }
+        forget();
+        return status;
+    }
+};
 
 struct Holiday {
     int month;
     int day;
-    int duration_hours;
+    int start_hour;
+    int start_minute;
+    int duration_hours; // May span several days and wrap into the next year
     std::string program_name;
     int priority; // Higher priority holidays override lower ones
 };
 
+// Local time at which a holiday window opens in the given year
+static time_t holidayStart(const Holiday& holiday, int year) {
+    struct tm date = {};
+    date.tm_year = year - 1900;
+    date.tm_mon = holiday.month - 1;
+    date.tm_mday = holiday.day;
+    date.tm_hour = holiday.start_hour;
+    date.tm_min = holiday.start_minute;
+    date.tm_isdst = -1;
+    return mktime(&date);
+}
+
+// The holiday windows of a range of years, flattened into consecutive
+// segments that each know their winning holiday. Lookups and "when does
+// the answer change next" are binary searches over the segment starts, so
+// the number of configured slots does not matter at run time.
+class HolidaySchedule {
+private:
+    std::vector<time_t> segment_starts;      // Sorted; segment i ends where i+1 starts
+    std::vector<const Holiday*> segment_winner; // nullptr where no holiday is active
+    int first_year;
+    int last_year;
+
+public:
+    HolidaySchedule() : first_year(0), last_year(-1) {}
+
+    bool covers(int year) const {
+        return year > first_year && year < last_year;
+    }
+
+    // Materializes every holiday for first..last and resolves overlaps:
+    // highest priority wins, ties go to the entry listed first.
+    void build(const std::vector<Holiday>& holidays, int first, int last) {
+        first_year = first;
+        last_year = last;
+        segment_starts.clear();
+        segment_winner.clear();
+
+        struct Edge {
+            time_t when;
+            bool opens;
+            size_t index;
+            // At equal times closes sort before opens, so an instance that
+            // ends where another begins never leaves both counted at once
+            bool operator<(const Edge& other) const {
+                if (when != other.when) return when < other.when;
+                if (opens != other.opens) return !opens;
+                return index < other.index;
+            }
+        };
+        std::vector<Edge> edges;
+        for (size_t i = 0; i < holidays.size(); ++i) {
+            if (holidays[i].duration_hours <= 0) continue;
+            for (int year = first; year <= last; ++year) {
+                time_t start = holidayStart(holidays[i], year);
+                edges.push_back({ start, true, i });
+                edges.push_back({ start + holidays[i].duration_hours * 3600, false, i });
+            }
+        }
+        std::stable_sort(edges.begin(), edges.end());
+
+        // Active windows ordered by (-priority, config order)
+        std::multiset<std::pair<int, size_t>> active;
+        for (size_t e = 0; e < edges.size();) {
+            time_t when = edges[e].when;
+            for (; e < edges.size() && edges[e].when == when; ++e) {
+                std::pair<int, size_t> key(-holidays[edges[e].index].priority, edges[e].index);
+                if (edges[e].opens) {
+                    active.insert(key);
+                } else {
+                    auto open = active.find(key);
+                    if (open != active.end()) active.erase(open);
+                }
+            }
+            const Holiday* winner = active.empty() ? nullptr : &holidays[active.begin()->second];
+            if (!segment_winner.empty() && segment_winner.back() == winner) continue;
+            segment_starts.push_back(when);
+            segment_winner.push_back(winner);
+        }
+    }
+
+    const Holiday* activeAt(time_t when) const {
+        auto it = std::upper_bound(segment_starts.begin(), segment_starts.end(), when);
+        if (it == segment_starts.begin()) return nullptr;
+        return segment_winner[it - segment_starts.begin() - 1];
+    }
+
+    // First moment after `when` at which activeAt() changes, 0 if never
+    time_t nextChange(time_t when) const {
+        auto it = std::upper_bound(segment_starts.begin(), segment_starts.end(), when);
+        return it == segment_starts.end() ? 0 : *it;
+    }
+
+    size_t size() const { return segment_starts.size(); }
+};
+
 class HolidayManager {
 private:
     std::vector<Holiday> holidays;
+    HolidaySchedule schedule;
     std::string scripts_path;
     std::string default_program;
     std::string current_program;
     time_t program_start_time;
+    int restart_backoff_seconds;
     std::string log_file;
     std::vector<std::string> default_args; // Arguments for all programs
     std::vector<std::string> clock_args;   // Additional arguments for clockV2grok
@@ -35,6 +324,25 @@ private:
     int weather_duration_seconds;
     bool weather_enabled;
 
+    // Scene host settings: programs that exist as plugins are shown by one
+    // long-lived scene_host process instead of being launched as binaries
+    bool use_scene_host;
+    std::string scene_host_program;
+    std::string plugin_dir;
+    std::string scene_host_fifo;
+    int host_columns;                           // Panel width the running host was started with
+    std::map<std::string, int> plugin_columns;  // Width each plugin's scene is drawn for
+
+    // Event loop state. The manager sleeps in poll() until either the next
+    // scheduled transition (timer_fd), a child exit (panel pidfd or SIGCHLD)
+    // or a termination request (signal_fd) wakes it up.
+    int signal_fd;
+    int timer_fd;
+    bool stop_requested;
+    ChildSupervisor panel;      // Child currently driving the panel
+    time_t weather_until;       // End of the weather display being shown, 0 if none
+    time_t last_weather_slot;   // Start of the last :18/:48 slot that was shown
+
     void log(const std::string& message) {
         std::ofstream log(log_file, std::ios::app);
         time_t now = time(nullptr);
@@ -44,156 +352,308 @@ private:
         std::cout << "[" << timestamp << "] " << message << std::endl;
     }
 
-    void killAllInstances(const std::string& program_name) {
-        log("Killing all instances of: " + program_name);
-        std::string cmd = "killall -9 " + program_name + " 2>/dev/null";
-        system(cmd.c_str());
-        sleep(1); // Give it time to cleanup
+    // SIGTERMs leftovers from a previous manager run (matched on argv[0])
+    void terminateStrays(const std::vector<std::string>& program_names) {
+        DIR* proc = opendir("/proc");
+        if (!proc) return;
+        std::vector<pid_t> strays;
+        struct dirent* entry;
+        while ((entry = readdir(proc)) != nullptr) {
+            pid_t pid = atoi(entry->d_name);
+            if (pid <= 0 || pid == getpid()) continue;
+            std::ifstream cmdline("/proc/" + std::string(entry->d_name) + "/cmdline");
+            std::string argv0;
+            if (!std::getline(cmdline, argv0, '\0')) continue;
+            std::string base = argv0.substr(argv0.find_last_of('/') + 1);
+            if (std::find(program_names.begin(), program_names.end(), base) != program_names.end()) {
+                log("Terminating leftover " + base + " (pid " + std::to_string(pid) + ")");
+                kill(pid, SIGTERM);
+                strays.push_back(pid);
+            }
+        }
+        closedir(proc);
+
+        // Not our children, so poll for them to disappear
+        for (int waited = 0; !strays.empty() && waited < kStopGraceMillis; waited += 10) {
+            usleep(10 * 1000);
+            strays.erase(std::remove_if(strays.begin(), strays.end(),
+                                        [](pid_t pid) { return kill(pid, 0) != 0; }),
+                         strays.end());
+        }
+        for (pid_t pid : strays) {
+            kill(pid, SIGKILL);
+        }
+    }
+
+    // Stops whatever drives the panel and reports how it exited
+    void stopPanel() {
+        if (!panel.running()) return;
+        std::string program_name = panel.name();
+        log("Stopping: " + program_name);
+        int status = panel.stop(kStopGraceMillis);
+        log("Program " + program_name + " stopped (" + describeExit(status) + ")");
+    }
+
+    // Called when signal_fd or the pidfd reports a child exit. The panel is
+    // the manager's only child, so nothing else needs waiting for.
+    void reapChildren() {
+        std::string program_name = panel.name();
+        int status;
+        if (panel.reap(&status)) {
+            log("Program " + program_name + " exited (" + describeExit(status) + ")");
+        }
     }
 
     bool isProgramRunning(const std::string& program_name) {
-        std::string cmd = "pgrep -x " + program_name + " > /dev/null 2>&1";
-        return (system(cmd.c_str()) == 0);
+        return panel.running() && panel.name() == program_name;
     }
 
-    bool startProgram(const std::string& program_name, bool is_weather = false) {
-        std::string full_path = scripts_path + "/" + program_name;
+    // Replaces whatever drives the panel with program_name from scripts_path
+    bool launchProgram(const std::string& program_name, const std::vector<std::string>& args) {
+        stopPanel();
+        std::string error;
+        if (!panel.spawn(program_name, scripts_path + "/" + program_name, args, &error)) {
+            log("ERROR: Failed to execute " + program_name + ": " + error);
+            return false;
+        }
+        return true;
+    }
 
-        // First, kill any existing instances to prevent doubling
-        killAllInstances(program_name);
+    // Panel width a --led-cols flag in default_args forces on every
+    // program, 0 if there is none
+    int forcedColumns() {
+        for (const auto& arg : default_args) {
+            if (arg.compare(0, 11, "--led-cols=") == 0) return atoi(arg.c_str() + 11);
+        }
+        return 0;
+    }
+
+    // Width the plugin's scene is drawn for, as `scene_host --columns`
+    // reports it; 0 if the plugin cannot be loaded. Asked once per program.
+    int pluginColumns(const std::string& program_name) {
+        auto cached = plugin_columns.find(program_name);
+        if (cached != plugin_columns.end()) return cached->second;
+
+        std::string output = captureOutput(scripts_path + "/" + scene_host_program,
+                                           { "--plugin-dir", plugin_dir, "--columns", program_name });
+        int columns = atoi(output.c_str());
+        plugin_columns[program_name] = columns;
+        if (columns <= 0) {
+            log("WARNING: Could not read the panel width of plugin " + program_name +
+                ", running it standalone");
+        }
+        return columns;
+    }
+
+    // The host refuses scenes drawn for another width than its panel, so a
+    // plugin is only used if the host can be started at its width
+    bool isHosted(const std::string& program_name) {
+        if (!use_scene_host || program_name.empty()) return false;
+        std::string plugin = plugin_dir + "/" + program_name + ".so";
+        if (access(plugin.c_str(), R_OK) != 0) return false;
+        int columns = pluginColumns(program_name);
+        int forced = forcedColumns();
+        return columns > 0 && (forced == 0 || forced == columns);
+    }
+
+    // Stops a program, or the scene host if the program lives in it
+    void stopProgram(const std::string& program_name) {
+        if (isProgramRunning(isHosted(program_name) ? scene_host_program : program_name)) {
+            stopPanel();
+        }
+    }
+
+    bool isRunning(const std::string& program_name) {
+        return isProgramRunning(isHosted(program_name) ? scene_host_program : program_name);
+    }
+
+    // Switches the scene host to program_name, starting the host if needed
+    // and restarting it if the panel width has to change
+    bool showInSceneHost(const std::string& program_name) {
+        int columns = pluginColumns(program_name);
+        if (isProgramRunning(scene_host_program) && host_columns != columns) {
+            log("Scene host runs " + std::to_string(host_columns) + " columns, " +
+                program_name + " needs " + std::to_string(columns) + ", restarting it");
+        } else if (isProgramRunning(scene_host_program)) {
+            int fd = open(scene_host_fifo.c_str(), O_WRONLY | O_NONBLOCK);
+            if (fd >= 0) {
+                std::string cmd = "load " + program_name + "\n";
+                bool sent = write(fd, cmd.c_str(), cmd.size()) == (ssize_t)cmd.size();
+                close(fd);
+                if (sent) {
+                    log("Scene host switched to: " + program_name);
+                    return true;
+                }
+            }
+            log("WARNING: Scene host not responding, restarting it");
+        }
+
+        log("Starting scene host with: " + program_name);
+        mkfifo(scene_host_fifo.c_str(), 0660);
+        std::vector<std::string> args = {
+            "--plugin-dir", plugin_dir,
+            "--control", scene_host_fifo,
+            "--scene", program_name
+        };
+        if (forcedColumns() == 0) {
+            args.push_back("--led-cols=" + std::to_string(columns));
+        }
+        args.insert(args.end(), default_args.begin(), default_args.end());
+
+        if (launchProgram(scene_host_program, args)) {
+            host_columns = columns;
+            log("Scene host started successfully");
+            return true;
+        }
+        return false;
+    }
+
+    bool startProgram(const std::string& program_name, bool is_weather = false) {
+        if (!is_weather) {
+            // Recorded even if the start fails, so retries honour the backoff
+            current_program = program_name;
+            program_start_time = time(nullptr);
+        }
+        if (!is_weather && isHosted(program_name)) {
+            return showInSceneHost(program_name);
+        }
 
         log("Starting program: " + program_name);
 
-        // Build command with arguments
-        std::string cmd = full_path;
+        // Build argument list
+        std::vector<std::string> args;
 
         if (is_weather) {
             // Weather-specific arguments
-            cmd += " -f /home/seth/rgbMatrix/rpi-rgb-led-matrix/fonts/5x7.bdf";
-            cmd += " -k " + weather_api_key;
+            args.push_back("-f");
+            args.push_back(preferCompiledFont("/home/seth/rgbMatrix/rpi-rgb-led-matrix/fonts/5x7.bdf"));
+            args.push_back("-k");
+            args.push_back(weather_api_key);
             // Add default args for matrix control
-            for (const auto& arg : default_args) {
-                cmd += " " + arg;
-            }
+            args.insert(args.end(), default_args.begin(), default_args.end());
         } else {
             // Add default arguments for all programs
-            for (const auto& arg : default_args) {
-                cmd += " " + arg;
-            }
+            args.insert(args.end(), default_args.begin(), default_args.end());
 
             // Add clock-specific arguments only for clockV2grok
             if (program_name == default_program) {
-                for (const auto& arg : clock_args) {
-                    cmd += " " + arg;
-                }
+                args.insert(args.end(), clock_args.begin(), clock_args.end());
             }
         }
 
-        cmd += " > /dev/null 2>&1 &";
-
-        int result = system(cmd.c_str());
-
-        if (result == 0) {
-            sleep(2); // Give it time to start
-            if (isProgramRunning(program_name)) {
-                if (!is_weather) {
-                    current_program = program_name;
-                    program_start_time = time(nullptr);
-                }
-                log("Program started successfully");
-                return true;
-            } else {
-                log("ERROR: Program failed to start");
-                return false;
-            }
-        } else {
-            log("ERROR: Failed to execute command");
-            return false;
+        if (launchProgram(program_name, args)) {
+            log("Program started successfully");
+            return true;
         }
+        return false;
     }
 
-    void showWeather() {
+    // Replaces the current program with the weather display; reconcile()
+    // restores it once weather_until has passed
+    bool showWeather(time_t now) {
         if (!weather_enabled || weather_api_key.empty()) {
             log("Weather display skipped (not configured)");
-            return;
+            return false;
         }
 
         log("Showing weather display");
-        std::string saved_program = current_program;
 
         // Kill current program and show weather
-        killAllInstances(current_program);
+        if (!current_program.empty()) {
+            stopProgram(current_program);
+        }
         
         if (startProgram(weather_program, true)) {
             // Weather display runs for specified duration
-            sleep(weather_duration_seconds);
-            
-            // Kill weather and restore previous program
-            killAllInstances(weather_program);
-            log("Weather display complete, restoring: " + saved_program);
-            startProgram(saved_program);
-        } else {
-            log("ERROR: Failed to start weather display, restoring: " + saved_program);
-            startProgram(saved_program);
+            weather_until = now + weather_duration_seconds;
+            return true;
         }
+        log("ERROR: Failed to start weather display, restoring: " + current_program);
+        return false;
     }
 
-    bool shouldShowWeather() {
-        if (!weather_enabled) return false;
+    // Returns the start of the :18/:48 weather slot containing now, or 0
+    time_t weatherSlot(time_t now) {
+        if (!weather_enabled) return 0;
 
-        time_t now = time(nullptr);
-        struct tm* timeinfo = localtime(&now);
-        int current_minute = timeinfo->tm_min;
+        struct tm timeinfo;
+        localtime_r(&now, &timeinfo);
+        if (timeinfo.tm_min != 18 && timeinfo.tm_min != 48) return 0;
+        return now - timeinfo.tm_sec;
+    }
 
-        // Check if we're at :18 or :48
-        return (current_minute == 18 || current_minute == 48);
+    // Start of the next :18 or :48 minute strictly after now
+    time_t nextWeatherSlot(time_t now) {
+        struct tm timeinfo;
+        localtime_r(&now, &timeinfo);
+        int minute = timeinfo.tm_min;
+        int next_minute = minute < 18 ? 18 : (minute < 48 ? 48 : 60 + 18);
+        return now - timeinfo.tm_sec + (next_minute - minute) * 60;
     }
 
-    Holiday* getCurrentHoliday() {
-        time_t now = time(nullptr);
-        struct tm* timeinfo = localtime(&now);
-        int current_month = timeinfo->tm_mon + 1;
-        int current_day = timeinfo->tm_mday;
-        int current_hour = timeinfo->tm_hour;
-
-        Holiday* active_holiday = nullptr;
-        int highest_priority = -1;
-
-        for (auto& holiday : holidays) {
-            if (holiday.month == current_month && holiday.day == current_day) {
-                // Check if we're within the duration window
-                time_t holiday_start = now - (current_hour * 3600) - (timeinfo->tm_min * 60) - timeinfo->tm_sec;
-                time_t holiday_end = holiday_start + (holiday.duration_hours * 3600);
-
-                if (now >= holiday_start && now < holiday_end) {
-                    if (holiday.priority > highest_priority) {
-                        active_holiday = &holiday;
-                        highest_priority = holiday.priority;
-                    }
-                }
-            }
+    // Earliest moment after now at which the schedule can change: a holiday
+    // window opening or closing, a weather slot, the end of the weather
+    // display, or a pending restart of a crashed program.
+    time_t nextTransition(time_t now) {
+        time_t next = now + 24 * 3600;
+
+        if (weather_enabled) {
+            next = std::min(next, nextWeatherSlot(now));
+        }
+        if (weather_until > now) {
+            next = std::min(next, weather_until);
+        }
+        if (!current_program.empty() && !isRunning(current_program) &&
+            program_start_time + restart_backoff_seconds > now) {
+            next = std::min(next, program_start_time + restart_backoff_seconds);
+        }
+
+        time_t holiday_change = schedule.nextChange(now);
+        if (holiday_change > now) {
+            next = std::min(next, holiday_change);
         }
 
-        return active_holiday;
+        return next;
+    }
+
+    // Highest-priority holiday whose window contains now, if any
+    const Holiday* getCurrentHoliday(time_t now) {
+        struct tm today;
+        localtime_r(&now, &today);
+        int year = today.tm_year + 1900;
+
+        // One year either side covers windows that wrap across New Year
+        if (!schedule.covers(year)) {
+            schedule.build(holidays, year - 1, year + 1);
+            log("Built holiday schedule for " + std::to_string(year) + " (" +
+                std::to_string(schedule.size()) + " segments)");
+        }
+        return schedule.activeAt(now);
     }
 
 public:
     HolidayManager(const std::string& config_file, const std::string& path, const std::string& default_prog, 
-                   const std::vector<std::string>& args, const std::string& api_key = "")
-        : scripts_path(path), default_program(default_prog), program_start_time(0), 
+                   const std::vector<std::string>& args, const std::string& api_key = "",
+                   bool scene_host = false, int restart_backoff = kRestartBackoffSeconds)
+        : scripts_path(path), default_program(default_prog), program_start_time(0),
+          restart_backoff_seconds(restart_backoff),
           weather_program("temp_display"), weather_api_key(api_key), 
-          weather_duration_seconds(30), weather_enabled(!api_key.empty()) {
+          weather_duration_seconds(30), weather_enabled(!api_key.empty()),
+          use_scene_host(scene_host), scene_host_program("scene_host"), host_columns(0),
+          signal_fd(-1), timer_fd(-1), stop_requested(false),
+          weather_until(0), last_weather_slot(0) {
         log_file = path + "/holiday_manager.log";
+        plugin_dir = path + "/plugins";
+        scene_host_fifo = path + "/scene_host.fifo";
 
         // Split args into default_args (for all programs) and clock_args (for clockV2grok)
         default_args = {
             "--led-gpio-mapping=adafruit-hat",
-            "--led-slowdown-gpio=2",
-            "--led-daemon"
+            "--led-slowdown-gpio=2"
         };
 
         clock_args = {
-            "-f", "/home/seth/rgbMatrix/rpi-rgb-led-matrix/fonts/5x8.bdf",
+            "-f", preferCompiledFont("/home/seth/rgbMatrix/rpi-rgb-led-matrix/fonts/5x8.bdf"),
             "-C", "0,0,255",
             "-B", "16,0,32"
         };
@@ -203,6 +663,14 @@ public:
             default_args = args;
         }
 
+        // Programs must stay in the foreground: a daemonized child exits
+        // straight away and can no longer be supervised
+        auto daemon_flag = std::find(default_args.begin(), default_args.end(), "--led-daemon");
+        if (daemon_flag != default_args.end()) {
+            default_args.erase(daemon_flag);
+            log("Ignoring --led-daemon, programs are supervised in the foreground");
+        }
+
         loadConfig(config_file);
         log("Holiday Manager initialized");
         if (weather_enabled) {
@@ -211,6 +679,9 @@ public:
         } else {
             log("Weather display disabled (no API key provided)");
         }
+        if (use_scene_host) {
+            log("Scene host enabled (plugins from " + plugin_dir + ")");
+        }
     }
 
     void loadConfig(const std::string& config_file) {
@@ -225,7 +696,7 @@ public:
             // Skip comments and empty lines
             if (line.empty() || line[0] == '#') continue;
 
-            // Parse: MM-DD,duration_hours,program_name,priority
+            // Parse: MM-DD[ HH:MM],duration_hours,program_name,priority
             std::istringstream iss(line);
             std::string date_str, duration_str, program, priority_str;
 
@@ -235,13 +706,25 @@ public:
                 std::getline(iss, priority_str)) {
 
                 Holiday h;
-                sscanf(date_str.c_str(), "%d-%d", &h.month, &h.day);
+                h.start_hour = 0;
+                h.start_minute = 0;
+                int fields = sscanf(date_str.c_str(), "%d-%d %d:%d", &h.month, &h.day,
+                                    &h.start_hour, &h.start_minute);
+                if ((fields != 2 && fields != 4) || h.month < 1 || h.month > 12 ||
+                    h.day < 1 || h.day > 31 || h.start_hour < 0 || h.start_hour > 23 ||
+                    h.start_minute < 0 || h.start_minute > 59) {
+                    log("WARNING: Skipping invalid date: " + line);
+                    continue;
+                }
                 h.duration_hours = std::stoi(duration_str);
                 h.program_name = program;
                 h.priority = std::stoi(priority_str);
 
                 holidays.push_back(h);
+                char start[16];
+                snprintf(start, sizeof(start), "%02d:%02d", h.start_hour, h.start_minute);
                 log("Loaded holiday: " + std::to_string(h.month) + "/" + std::to_string(h.day) +
+                    " " + start + " +" + std::to_string(h.duration_hours) + "h" +
                     " - " + h.program_name + " (Priority: " + std::to_string(h.priority) + ")");
             }
         }
@@ -249,65 +732,149 @@ public:
         log("Loaded " + std::to_string(holidays.size()) + " holidays");
     }
 
+    // Blocks SIGCHLD/SIGINT/SIGTERM and routes them through signal_fd, and
+    // creates the wall-clock timer used to wait for the next transition
+    bool setupEvents() {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGCHLD);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        if (sigprocmask(SIG_BLOCK, &signals, nullptr) != 0) return false;
+
+        signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        timer_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+        return signal_fd >= 0 && timer_fd >= 0;
+    }
+
+    // Sleeps until wake_at, a child exits, a termination signal arrives or
+    // the system clock is set (e.g. NTP sync after boot on the Pi)
+    void waitForEvent(time_t wake_at) {
+        struct itimerspec timer = {};
+        timer.it_value.tv_sec = wake_at;
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &timer, nullptr);
+
+        // The pidfd (when the kernel has them) reports the panel child's
+        // exit directly; SIGCHLD covers older kernels
+        struct pollfd fds[3] = {
+            { signal_fd, POLLIN, 0 },
+            { timer_fd, POLLIN, 0 },
+            { panel.fd(), POLLIN, 0 }
+        };
+        if (poll(fds, panel.fd() >= 0 ? 3 : 2, -1) < 0) return;
+
+        if (fds[2].revents & POLLIN) {
+            reapChildren();
+        }
+        if (fds[0].revents & POLLIN) {
+            struct signalfd_siginfo info;
+            while (read(signal_fd, &info, sizeof(info)) == sizeof(info)) {
+                if (info.ssi_signo == SIGCHLD) {
+                    reapChildren();
+                } else {
+                    log(std::string("Received ") + strsignal(info.ssi_signo) + ", stopping");
+                    stop_requested = true;
+                }
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            uint64_t expirations;
+            if (read(timer_fd, &expirations, sizeof(expirations)) < 0 && errno == ECANCELED) {
+                log("System clock changed, recomputing schedule");
+            }
+        }
+    }
+
+    // Brings the panel in line with the schedule at time now
+    void reconcile(time_t now) {
+        bool restoring = false;
+        if (weather_until != 0) {
+            if (now < weather_until && isProgramRunning(weather_program)) return;
+
+            // Stop weather and restore previous program
+            stopProgram(weather_program);
+            weather_until = 0;
+            restoring = true;
+        }
+
+        // Check if it's time to show weather (once per slot)
+        time_t slot = weatherSlot(now);
+        if (slot != 0 && slot != last_weather_slot) {
+            last_weather_slot = slot;
+            if (showWeather(now)) return;
+            restoring = true;
+        }
+
+        // Determine what should be running
+        const Holiday* active_holiday = getCurrentHoliday(now);
+        std::string target_program = active_holiday ? active_holiday->program_name : default_program;
+
+        // Check if we need to switch programs
+        if (current_program != target_program) {
+            if (active_holiday) {
+                log("Holiday detected: " + active_holiday->program_name);
+            } else {
+                log("Holiday period ended, switching to default: " + default_program);
+            }
+            // Kill the current program before starting the new one.
+            // Hosted scenes are swapped inside the running scene host.
+            if (!current_program.empty() && !(isHosted(current_program) && isHosted(target_program))) {
+                stopProgram(current_program);
+            }
+            startProgram(target_program);
+        } else if (!isRunning(current_program)) {
+            if (restoring) {
+                log("Weather display complete, restoring: " + current_program);
+            } else if (now < program_start_time + restart_backoff_seconds) {
+                return; // nextTransition() wakes us when the backoff is over
+            } else {
+                log("Program " + current_program + " stopped unexpectedly, restarting...");
+            }
+            startProgram(current_program);
+        }
+    }
+
     void run() {
         log("Starting holiday manager main loop");
 
         // Clean up any existing processes first
         log("Cleaning up any existing matrix processes...");
-        killAllInstances(default_program);
+        std::vector<std::string> known_programs = { default_program, weather_program, scene_host_program };
         for (const auto& h : holidays) {
-            killAllInstances(h.program_name);
+            known_programs.push_back(h.program_name);
         }
-        killAllInstances(weather_program);
+        terminateStrays(known_programs);
 
-        time_t last_weather_check = 0;
+        if (!setupEvents()) {
+            log(std::string("ERROR: Could not set up event loop: ") + strerror(errno));
+            return;
+        }
 
-        while (true) {
+        time_t logged_wake = 0;
+        while (!stop_requested) {
+            // One reading for both: should the clock tick over in between,
+            // reconcile() could still wait out a restart backoff that
+            // nextTransition() no longer schedules a wake-up for
             time_t now = time(nullptr);
-            struct tm* timeinfo = localtime(&now);
-            
-            // Check if it's time to show weather (only once per minute)
-            if (shouldShowWeather() && (now - last_weather_check) >= 60) {
-                showWeather();
-                last_weather_check = now;
-                // After weather, continue with normal operations
+            reconcile(now);
+
+            time_t wake_at = nextTransition(now);
+            if (wake_at != logged_wake) {
+                char wake_str[64];
+                strftime(wake_str, sizeof(wake_str), "%Y-%m-%d %H:%M:%S", localtime(&wake_at));
+                log(std::string("Next transition at ") + wake_str);
+                logged_wake = wake_at;
             }
 
-            // Determine what should be running
-            Holiday* active_holiday = getCurrentHoliday();
-            std::string target_program = active_holiday ? active_holiday->program_name : default_program;
-
-            // Check if we need to switch programs
-            if (current_program != target_program) {
-                if (active_holiday) {
-                    log("Holiday detected: " + active_holiday->program_name);
-                } else {
-                    log("Holiday period ended, switching to default: " + default_program);
-                }
-                // Kill the current program before starting the new one
-                if (!current_program.empty()) {
-                    killAllInstances(current_program);
-                }
-                startProgram(target_program);
-            } else {
-                // Verify the program is still running
-                if (!isProgramRunning(current_program)) {
-                    log("Program " + current_program + " stopped unexpectedly, restarting...");
-                    startProgram(current_program);
-                }
-            }
-
-            // Check every 30 seconds for better weather timing accuracy
-            sleep(30);
+            waitForEvent(wake_at);
         }
     }
 
     ~HolidayManager() {
         log("Holiday Manager shutting down");
-        if (!current_program.empty()) {
-            killAllInstances(current_program);
-        }
-        killAllInstances(weather_program);
+        stopPanel();
+        if (signal_fd >= 0) close(signal_fd);
+        if (timer_fd >= 0) close(timer_fd);
     }
 };
 
@@ -317,18 +884,28 @@ int main(int argc, char* argv[]) {
     std::string default_program = "clockV2grok";
     std::string weather_api_key = "";
     std::vector<std::string> additional_args;
+    bool use_scene_host = false;
+    int restart_backoff = kRestartBackoffSeconds;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--weather-api-key" && i + 1 < argc) {
             weather_api_key = argv[++i];
+        } else if (arg == "--scene-host") {
+            use_scene_host = true;
+        } else if (arg == "--scripts-path" && i + 1 < argc) {
+            scripts_path = argv[++i];
+            config_file = scripts_path + "/holidays.conf";
+        } else if (arg == "--restart-backoff" && i + 1 < argc) {
+            restart_backoff = std::max(0, atoi(argv[++i]));
         } else {
             additional_args.push_back(arg);
         }
     }
 
-    HolidayManager manager(config_file, scripts_path, default_program, additional_args, weather_api_key);
+    HolidayManager manager(config_file, scripts_path, default_program, additional_args, weather_api_key,
+                           use_scene_host, restart_backoff);
     manager.run();
 
     return 0;
@@ -0,0 +1,98 @@
+// HSV to RGB conversion shared by the scenes
+//
+// Fixed point throughout: hue in whole degrees, saturation and value as
+// 0..255. At full saturation each channel sits either at `value` or drops
+// linearly towards 0 over a 60 degree ramp; how far it drops only depends
+// on the hue, so that part is a 360-entry table.
+//
+// HSVtoRGB() keeps the float signature the scenes always used (h 0-360,
+// s and v 0-1) for one-off colours. HSVRowToRGB() converts a whole row
+// without branches or table lookups, so GCC vectorizes it (NEON on the
+// Pi with -O3). hsv_bench.cpp measures both against the old float code.
+//
+// Header only, so plugins can use it without linking librgbscene.
+
+#ifndef HSV_H
+#define HSV_H
+
+#include <math.h>
+#include <stdint.h>
+
+// Drop of one channel below `value` at full saturation, 0 (none) to 60
+// (all the way to 0), for hue 0..359. Channel 0 is red, 1 green, 2 blue.
+inline int HueDrop(int hue, int channel) {
+    static const int offsets[3] = { 300, 180, 60 };
+    int k = hue + offsets[channel];
+    if (k >= 360) k -= 360;
+    int t = (k < 240 - k) ? k : 240 - k;
+    if (t < 0) t = 0;
+    if (t > 60) t = 60;
+    return t;
+}
+
+// HueDrop() for every whole degree, scaled to 0..255
+struct HueTable {
+    uint8_t drop[360][3];
+
+    HueTable() {
+        for (int h = 0; h < 360; h++) {
+            for (int c = 0; c < 3; c++) {
+                drop[h][c] = HueDrop(h, c) * 255 / 60;
+            }
+        }
+    }
+};
+
+// One copy per translation unit; it is only 1 KB and avoids a guarded
+// function-local static on every call
+static const HueTable hue_table;
+
+// Any hue in degrees, including negative ones and ones past 360
+inline int WrapHue(float h) {
+    if (h >= 0.0f && h < 360.0f) return (int)h;
+    int degrees = (int)floorf(h) % 360;
+    return degrees < 0 ? degrees + 360 : degrees;
+}
+
+// 0-1 float to 0..255, clamped
+inline int UnitToByte(float f) {
+    if (f <= 0.0f) return 0;
+    if (f >= 1.0f) return 255;
+    return (int)(f * 255.0f + 0.5f);
+}
+
+// h: 0-360 (wraps), s: 0-1, v: 0-1
+inline void HSVtoRGB(float h, float s, float v, int &r, int &g, int &b) {
+    const uint8_t *drop = hue_table.drop[WrapHue(h)];
+    const int value = UnitToByte(v);
+    const int vs = value * UnitToByte(s);
+    r = value - vs * drop[0] / (255 * 255);
+    g = value - vs * drop[1] / (255 * 255);
+    b = value - vs * drop[2] / (255 * 255);
+}
+
+// HueDrop() without branches, for the row converter; k is hue plus the
+// channel's offset, 0..659
+inline int32_t HueRamp(int32_t k) {
+    k -= (k >= 360) ? 360 : 0;
+    int32_t t = (k < 240 - k) ? k : 240 - k;
+    t = (t < 0) ? 0 : t;
+    return (t > 60) ? 60 : t;
+}
+
+// Converts `count` pixels to packed RGB. Hues must already be 0..359.
+// The division by 255 * 60 is a multiply by 1097 / 2^24, which is within
+// 0.05% and keeps everything in 32 bits.
+inline void HSVRowToRGB(const uint16_t *__restrict hue, const uint8_t *__restrict sat,
+                        const uint8_t *__restrict val, uint8_t *__restrict rgb, int count) {
+    for (int i = 0; i < count; i++) {
+        const int32_t h = hue[i];
+        const uint32_t v = val[i];
+        const uint32_t vs = v * sat[i] * 1097u;
+        rgb[i * 3] = v - ((vs * HueRamp(h + 300)) >> 24);
+        rgb[i * 3 + 1] = v - ((vs * HueRamp(h + 180)) >> 24);
+        rgb[i * 3 + 2] = v - ((vs * HueRamp(h + 60)) >> 24);
+    }
+}
+
+#endif // HSV_H
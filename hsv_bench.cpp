@@ -0,0 +1,124 @@
+// HSV conversion microbenchmark - per-pixel cost of the old float
+// HSVtoRGB() the scenes used to carry against the shared fixed-point code
+// in hsv.h, plus the largest channel difference between them.
+// Compilation: g++ -O3 -o hsv_bench hsv_bench.cpp -std=c++11
+//
+// Usage: hsv_bench [frames]   (default 20000 frames of 32x32)
+
+#include "hsv.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const int width = 32;
+static const int height = 32;
+static const int pixels = width * height;
+
+// The per-scene version this header replaced
+static void LegacyHSVtoRGB(float h, float s, float v, int &r, int &g, int &b) {
+    float c = v * s;
+    float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
+    float m = v - c;
+
+    float r1, g1, b1;
+    if (h < 60) { r1 = c; g1 = x; b1 = 0; }
+    else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
+    else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
+    else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
+    else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
+    else { r1 = c; g1 = 0; b1 = x; }
+
+    r = (r1 + m) * 255;
+    g = (g1 + m) * 255;
+    b = (b1 + m) * 255;
+}
+
+static double NowSeconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    const int frames = (argc > 1) ? atoi(argv[1]) : 20000;
+
+    // fourtwenty's background: diagonal rainbow at 60% saturation with a
+    // brightness wave
+    static float hue_f[pixels], sat_f[pixels], val_f[pixels];
+    static uint16_t hue[pixels];
+    static uint8_t sat[pixels], val[pixels];
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const int i = y * width + x;
+            hue_f[i] = fmod(x * 10 + y * 10 + 17.0, 360);
+            sat_f[i] = 0.6f;
+            val_f[i] = (sin((x * 0.2 + y * 0.2) * M_PI / 10) * 0.3 + 0.7) * 0.3;
+            hue[i] = WrapHue(hue_f[i]);
+            sat[i] = UnitToByte(sat_f[i]);
+            val[i] = UnitToByte(val_f[i]);
+        }
+    }
+
+    static uint8_t rgb[pixels * 3];
+    unsigned long sink = 0;
+    double start, legacy_ns, table_ns, row_ns;
+
+    start = NowSeconds();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < pixels; i++) {
+            int r, g, b;
+            LegacyHSVtoRGB(hue_f[i] + (f & 7), sat_f[i], val_f[i], r, g, b);
+            sink += r + g + b;
+        }
+    }
+    legacy_ns = (NowSeconds() - start) * 1e9 / ((double)frames * pixels);
+
+    start = NowSeconds();
+    for (int f = 0; f < frames; f++) {
+        for (int i = 0; i < pixels; i++) {
+            int r, g, b;
+            HSVtoRGB(hue_f[i] + (f & 7), sat_f[i], val_f[i], r, g, b);
+            sink += r + g + b;
+        }
+    }
+    table_ns = (NowSeconds() - start) * 1e9 / ((double)frames * pixels);
+
+    start = NowSeconds();
+    for (int f = 0; f < frames; f++) {
+        for (int y = 0; y < height; y++) {
+            HSVRowToRGB(hue + y * width, sat + y * width, val + y * width,
+                        rgb + y * width * 3, width);
+        }
+        sink += rgb[f % (pixels * 3)];
+    }
+    row_ns = (NowSeconds() - start) * 1e9 / ((double)frames * pixels);
+
+    // Worst channel difference against the old code over every whole hue
+    int table_error = 0, row_error = 0;
+    for (int h = 0; h < 360; h++) {
+        for (int s = 0; s <= 255; s += 15) {
+            for (int v = 0; v <= 255; v += 15) {
+                int expected[3], table[3];
+                LegacyHSVtoRGB(h, s / 255.0f, v / 255.0f, expected[0], expected[1], expected[2]);
+                HSVtoRGB(h, s / 255.0f, v / 255.0f, table[0], table[1], table[2]);
+                const uint16_t row_h = h;
+                const uint8_t row_s = s, row_v = v;
+                uint8_t row[3];
+                HSVRowToRGB(&row_h, &row_s, &row_v, row, 1);
+                for (int c = 0; c < 3; c++) {
+                    if (abs(table[c] - expected[c]) > table_error) table_error = abs(table[c] - expected[c]);
+                    if (abs(row[c] - expected[c]) > row_error) row_error = abs(row[c] - expected[c]);
+                }
+            }
+        }
+    }
+
+    printf("%d frames of %dx%d\n", frames, width, height);
+    printf("float HSVtoRGB (old):   %6.2f ns/pixel\n", legacy_ns);
+    printf("table HSVtoRGB:         %6.2f ns/pixel  (max error %d)\n", table_ns, table_error);
+    printf("HSVRowToRGB:            %6.2f ns/pixel  (max error %d)\n", row_ns, row_error);
+    fprintf(stderr, "(checksum %lu)\n", sink);
+    return 0;
+}
@@ -1,19 +1,15 @@
+// Jack-o'-Lantern Scene
+// Compilation: g++ -o jackolantern jackolantern.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/jackolantern.so jackolantern.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 void DrawPumpkinBody(Canvas *canvas, Color pumpkin_orange, Color pumpkin_dark, Color stem) {
     // Draw large pumpkin with more realistic rounded shape
 
@@ -167,40 +163,24 @@ void DrawEvilFace(Canvas *canvas, Color glow) {
     }
 }
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class JackOLanternScene : public Scene {
+private:
     // Colors
-    Color bg_night(5, 0, 20);           // Dark background
-    Color pumpkin_orange(255, 120, 0);  // Orange pumpkin
-    Color pumpkin_dark(180, 70, 0);     // Dark orange for shading
-    Color stem(80, 50, 20);             // Brown stem
-    Color glow_bright(255, 200, 0);     // Bright yellow glow
-    Color glow_dark(80, 60, 0);         // Dark yellow for dim state
-
-    int frame_count = 0;
-    int face_type = 0;
-    int face_duration = 120; // frames per face (~6 seconds at 20fps)
-
-    // Display until interrupted
-    while (running) {
+    Color bg_night = Color(5, 0, 20);           // Dark background
+    Color pumpkin_orange = Color(255, 120, 0);  // Orange pumpkin
+    Color pumpkin_dark = Color(180, 70, 0);     // Dark orange for shading
+    Color stem = Color(80, 50, 20);             // Brown stem
+    Color glow_bright = Color(255, 200, 0);     // Bright yellow glow
+    Color glow_dark = Color(80, 60, 0);         // Dark yellow for dim state
+
+    int frame_count;
+    int face_type;
+    int face_duration; // frames per face (~6 seconds at 20fps)
+
+public:
+    JackOLanternScene() : frame_count(0), face_type(0), face_duration(120) {}
+
+    void Render(Canvas *canvas) {
         // Clear canvas
         canvas->Fill(bg_night.r, bg_night.g, bg_night.b);
 
@@ -233,12 +213,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(JackOLanternScene)
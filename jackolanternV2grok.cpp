@@ -1,5 +1,10 @@
+// Jack-o'-Lantern Scene (V2)
+// Compilation: g++ -o jackolanternV2grok jackolanternV2grok.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/jackolanternV2grok.so jackolanternV2grok.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
@@ -227,34 +232,23 @@ void DrawEvilFace(Canvas *canvas, Color glow) {
     }
 }
 
-int main() {
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
+class JackOLanternV2Scene : public Scene {
+private:
+    Color bg_night = Color(5, 0, 20);
+    Color pumpkin_orange = Color(255, 120, 0);
+    Color pumpkin_dark = Color(180, 70, 0);
+    Color stem = Color(80, 50, 20);
+    Color glow = Color(255, 200, 0);
+    Color shadow = Color(20, 10, 5);
 
-    Color bg_night(5, 0, 20);
-    Color pumpkin_orange(255, 120, 0);
-    Color pumpkin_dark(180, 70, 0);
-    Color stem(80, 50, 20);
-    Color glow(255, 200, 0);
-    Color shadow(20, 10, 5);
+    int frame_count;
+    int face_type;
+    int face_duration;
 
-    int frame_count = 0;
-    int face_type = 0;
-    int face_duration = 120;
+public:
+    JackOLanternV2Scene() : frame_count(0), face_type(0), face_duration(120) {}
 
-    while (true) {
+    void Render(Canvas *canvas) {
         canvas->Fill(bg_night.r, bg_night.g, bg_night.b);
 
         // Smoother flickering effect
@@ -276,10 +270,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);
     }
+};
 
-    delete matrix;
-    return 0;
-}
+RGB_SCENE_MAIN(JackOLanternV2Scene)
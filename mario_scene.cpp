@@ -1,34 +1,22 @@
+// Mario Scene
+// Compilation: g++ -o mario_scene mario_scene.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/mario_scene.so mario_scene.cpp -lrgbmatrix -std=c++11
+
 // -*- mode: c++; c-basic-offset: 2; indent-tabs-mode: nil; -*-
 // Mario-inspired scene for 32x32 RGB matrix
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "sprite.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <cmath>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-RGBMatrix* global_matrix = nullptr;
-FrameCanvas* global_canvas = nullptr;
-
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-    if (global_canvas) {
-        global_canvas->Clear();
-        global_canvas = global_matrix->SwapOnVSync(global_canvas);
-    }
-    if (global_matrix) {
-        delete global_matrix;
-        global_matrix = nullptr;
-    }
-    exit(0);
-}
-
 struct Goomba {
     float x;
     float y;
@@ -36,60 +24,43 @@ struct Goomba {
     bool active;
 };
 
-void drawMario(FrameCanvas* canvas, float x, float y, bool jumping, bool facing_right) {
-    int mx = (int)x;
-    int my = (int)y;
-
-    // Hat (red)
-    canvas->SetPixel(mx, my - 4, 255, 0, 0);
-    canvas->SetPixel(mx - 1, my - 4, 255, 0, 0);
-    canvas->SetPixel(mx + 1, my - 4, 255, 0, 0);
-    canvas->SetPixel(mx - 2, my - 4, 255, 0, 0);
-    canvas->SetPixel(mx + 2, my - 4, 255, 0, 0);
-
-    // Face (skin)
-    canvas->SetPixel(mx, my - 3, 255, 200, 150);
-    canvas->SetPixel(mx - 1, my - 3, 255, 200, 150);
-    canvas->SetPixel(mx + 1, my - 3, 255, 200, 150);
-    canvas->SetPixel(mx - 2, my - 3, 0, 0, 0); // Hair
-    canvas->SetPixel(mx + 2, my - 3, 0, 0, 0); // Hair
-
-    // Eyes and mustache
-    canvas->SetPixel(mx - 1, my - 2, 0, 0, 0);
-    canvas->SetPixel(mx + 1, my - 2, 0, 0, 0);
-    canvas->SetPixel(mx, my - 2, 255, 200, 150);
-
-    // Body (red shirt)
-    canvas->SetPixel(mx, my - 1, 255, 0, 0);
-    canvas->SetPixel(mx - 1, my - 1, 255, 0, 0);
-    canvas->SetPixel(mx + 1, my - 1, 255, 0, 0);
-    canvas->SetPixel(mx, my, 0, 0, 255); // Overalls (blue)
-    canvas->SetPixel(mx - 1, my, 0, 0, 255);
-    canvas->SetPixel(mx + 1, my, 0, 0, 255);
-
-    // Arms
-    if (jumping) {
-        canvas->SetPixel(mx - 2, my - 1, 255, 200, 150); // Left arm up
-        canvas->SetPixel(mx + 2, my - 1, 255, 200, 150); // Right arm up
-    } else {
-        canvas->SetPixel(mx - 2, my, 255, 200, 150); // Left arm down
-        canvas->SetPixel(mx + 2, my, 255, 200, 150); // Right arm down
-    }
-
-    // Legs (blue overalls, brown shoes)
-    canvas->SetPixel(mx - 1, my + 1, 0, 0, 255);
-    canvas->SetPixel(mx + 1, my + 1, 0, 0, 255);
-    canvas->SetPixel(mx - 1, my + 2, 139, 69, 19); // Shoes
-    canvas->SetPixel(mx + 1, my + 2, 139, 69, 19);
-
-    // Mirror if facing left
-    if (!facing_right) {
-        // Swap left/right pixels (simplified)
-        // Note: For accuracy, redraw with mirrored positions
-    }
+// Mario, 5x7 with his feet at the bottom row; the two poses differ in the
+// arms (down while walking, up while jumping)
+static SpriteAtlas mario_sprites({
+    {'R', Color(255, 0, 0)},      // Hat and shirt
+    {'S', Color(255, 200, 150)},  // Skin
+    {'K', Color(0, 0, 0)},        // Hair, eyes
+    {'B', Color(0, 0, 255)},      // Overalls
+    {'N', Color(139, 69, 19)}     // Shoes
+});
+
+static const int mario_walking = mario_sprites.add({
+    "RRRRR",
+    "KSSSK",
+    ".KSK.",
+    ".RRR.",
+    "SBBBS",
+    ".B.B.",
+    ".N.N."
+});
+
+static const int mario_jumping = mario_sprites.add({
+    "RRRRR",
+    "KSSSK",
+    ".KSK.",
+    "SRRRS",
+    ".BBB.",
+    ".B.B.",
+    ".N.N."
+});
+
+// (x, y) is the middle of Mario's overalls
+void drawMario(Canvas* canvas, float x, float y, bool jumping, bool facing_right) {
+    mario_sprites.draw(canvas, jumping ? mario_jumping : mario_walking,
+                       (int)x - 2, (int)y - 4, !facing_right);
 }
 
-void drawGoomba(FrameCanvas* canvas, float x, float y) {
+void drawGoomba(Canvas* canvas, float x, float y) {
     int gx = (int)x;
     int gy = (int)y;
 
@@ -112,7 +83,7 @@ void drawGoomba(FrameCanvas* canvas, float x, float y) {
     canvas->SetPixel(gx + 1, gy + 1, 0, 0, 0);
 }
 
-void drawPipe(FrameCanvas* canvas, int x, int height) {
+void drawPipe(Canvas* canvas, int x, int height) {
     for (int y = 31 - height; y < 32; ++y) {
         canvas->SetPixel(x, y, 0, 255, 0);
         canvas->SetPixel(x - 1, y, 0, 255, 0);
@@ -122,7 +93,7 @@ void drawPipe(FrameCanvas* canvas, int x, int height) {
     }
 }
 
-void drawCloud(FrameCanvas* canvas, int x, int y) {
+void drawCloud(Canvas* canvas, int x, int y) {
     canvas->SetPixel(x, y, 255, 255, 255);
     canvas->SetPixel(x - 1, y, 255, 255, 255);
     canvas->SetPixel(x + 1, y, 255, 255, 255);
@@ -135,69 +106,74 @@ bool checkCollision(float x1, float y1, float x2, float y2) {
     return (abs(x1 - x2) < 2 && abs(y1 - y2) < 3);
 }
 
-int main() {
-    srand(time(NULL));
-
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    global_matrix = matrix;
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    global_canvas = canvas;
-
-    Color bg_sky(135, 206, 235); // Light blue sky
-    Color ground_green(0, 255, 0);
-    Color brick_brown(165, 42, 42);
-    Color coin_gold(255, 215, 0);
+class MarioScene : public Scene {
+private:
+    Color bg_sky = Color(135, 206, 235); // Light blue sky
+    Color ground_green = Color(0, 255, 0);
+    Color brick_brown = Color(165, 42, 42);
+    Color coin_gold = Color(255, 215, 0);
 
     // Mario
-    float mario_x = 8.0f;
-    float mario_y = 24.0f;
-    float mario_vx = 0.2f;
-    float mario_vy = 0.0f;
-    bool jumping = false;
-    bool facing_right = true;
-    int jump_timer = 0;
+    float mario_x;
+    float mario_y;
+    float mario_vx;
+    float mario_vy;
+    bool jumping;
+    bool facing_right;
+    int jump_timer;
 
     // Goombas
-    const int num_goombas = 2;
+    static const int num_goombas = 2;
     Goomba goombas[num_goombas];
-    for (int i = 0; i < num_goombas; ++i) {
-        goombas[i].x = 20 + i * 10;
-        goombas[i].y = 24.0f;
-        goombas[i].vx = -0.1f;
-        goombas[i].active = true;
-    }
 
     // Pipes
-    int pipe_x = 24;
-    int pipe_height = 8;
+    int pipe_x;
+    int pipe_height;
 
     // Clouds
     int cloud_x[3] = {4, 14, 28};
     int cloud_y[3] = {4, 6, 5};
 
     // Coins
-    int coin_x = 16;
-    int coin_y = 16;
-    bool coin_collected = false;
+    int coin_x;
+    int coin_y;
+    bool coin_collected;
+
+    int frame_count;
+    bool game_over;
 
-    int frame_count = 0;
+public:
+    MarioScene() : pipe_x(24), pipe_height(8), coin_x(16), coin_y(16), frame_count(0) {}
+
+    void Init(int w, int h) {
+        newGame();
+    }
+
+    // Puts Mario, the Goombas and the coin back; the round restarts
+    // whenever Mario gets hit
+    void newGame() {
+        mario_x = 8.0f;
+        mario_y = 24.0f;
+        mario_vx = 0.2f;
+        mario_vy = 0.0f;
+        jumping = false;
+        facing_right = true;
+        jump_timer = 0;
+
+        for (int i = 0; i < num_goombas; ++i) {
+            goombas[i].x = 20 + i * 10;
+            goombas[i].y = 24.0f;
+            goombas[i].vx = -0.1f;
+            goombas[i].active = true;
+        }
+
+        coin_collected = false;
+        game_over = false;
+    }
+
+    void Render(Canvas *canvas) {
+        if (game_over) newGame();
 
-    while (!interrupt_received) {
         canvas->Fill(bg_sky.r, bg_sky.g, bg_sky.b);
 
         // Draw ground
@@ -239,7 +215,7 @@ int main() {
                     if (mario_vy > 0) { // Mario stomps
                         goombas[i].active = false;
                     } else { // Mario hit
-                        interrupt_received = true; // Game over
+                        game_over = true;
                     }
                 }
             }
@@ -278,19 +254,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000); // ~20 fps
-    }
-
-    // Cleanup
-    if (global_canvas) {
-        global_canvas->Clear();
-        global_canvas = matrix->SwapOnVSync(global_canvas);
-    }
-    if (global_matrix) {
-        delete global_matrix;
-        global_matrix = nullptr;
     }
+};
 
-    return 0;
-}
+RGB_SCENE_MAIN(MarioScene)
@@ -1,5 +1,11 @@
+// Matrix Rain Scene (V2)
+// Compilation: g++ -o matrixV2grok matrixV2grok.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/matrixV2grok.so matrixV2grok.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
@@ -17,48 +23,21 @@ struct RainDrop {
     bool active;
 };
 
-int main() {
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class MatrixV2Scene : public Scene {
+private:
     // Colors for Matrix effect
-    Color bg_black(0, 0, 0);
-    Color matrix_bright(220, 255, 220);    // Bright green (head)
-    Color matrix_green(0, 200, 0);         // Standard green
-    Color matrix_medium(0, 150, 0);        // Medium green
-    Color matrix_dim(0, 80, 0);            // Dim green
-    Color matrix_dark(0, 40, 0);           // Very dim green
-    Color bg_noise(10, 15, 10);            // Subtle background noise
-
-    // Initialize rain drops (columns)
-    const int num_drops = 32;
+    Color bg_black = Color(0, 0, 0);
+    Color matrix_bright = Color(220, 255, 220);    // Bright green (head)
+    Color matrix_green = Color(0, 200, 0);         // Standard green
+    Color matrix_medium = Color(0, 150, 0);        // Medium green
+    Color matrix_dim = Color(0, 80, 0);            // Dim green
+    Color matrix_dark = Color(0, 40, 0);           // Very dim green
+    Color bg_noise = Color(10, 15, 10);            // Subtle background noise
+
+    // Rain drops (columns)
+    static const int num_drops = 32;
     RainDrop drops[num_drops];
 
-    for (int i = 0; i < num_drops; ++i) {
-        drops[i].x = i;
-        drops[i].y = -(rand() % 32);
-        drops[i].speed = 0.4f + (rand() % 8) / 10.0f;
-        drops[i].length = 6 + rand() % 10;
-        drops[i].char_value = rand() % 256;
-        drops[i].opacity = 0.6f + (rand() % 40) / 100.0f; // 0.6 to 1.0
-        drops[i].active = (rand() % 100 < 50);
-    }
-
     // Expanded character patterns (5x3 pixel glyphs)
     int char_patterns[20][5] = {
         {0b01110, 0b10001, 0b10001, 0b10001, 0b01110}, // 0
@@ -83,15 +62,35 @@ int main() {
         {0b00001, 0b00001, 0b00001, 0b10001, 0b01110}, // J
     };
 
-    int frame_count = 0;
+    int frame_count;
+    SceneRandom rng;
+
+public:
+    MatrixV2Scene() : frame_count(0) {}
+
+    float DefaultFps() const { return 25.0f; }
 
-    while (true) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "matrixV2grok");
+
+        for (int i = 0; i < num_drops; ++i) {
+            drops[i].x = i;
+            drops[i].y = -(rng.below(32));
+            drops[i].speed = 0.4f + rng.below(8) / 10.0f;
+            drops[i].length = 6 + rng.below(10);
+            drops[i].char_value = rng.below(256);
+            drops[i].opacity = 0.6f + rng.below(40) / 100.0f; // 0.6 to 1.0
+            drops[i].active = (rng.below(100) < 50);
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Subtle background noise
         canvas->Fill(bg_black.r, bg_black.g, bg_black.b);
-        if (rand() % 100 < 10) { // 10% chance for background noise
+        if (rng.below(100) < 10) { // 10% chance for background noise
             for (int i = 0; i < 5; ++i) {
-                int x = rand() % 32;
-                int y = rand() % 32;
+                int x = rng.below(32);
+                int y = rng.below(32);
                 canvas->SetPixel(x, y, bg_noise.r, bg_noise.g, bg_noise.b);
             }
         }
@@ -104,12 +103,12 @@ int main() {
 
                 // Reset if off screen
                 if (drops[i].y - drops[i].length > 32) {
-                    drops[i].y = -(rand() % 10);
-                    drops[i].speed = 0.4f + (rand() % 8) / 10.0f;
-                    drops[i].length = 6 + rand() % 10;
-                    drops[i].char_value = rand() % 256;
-                    drops[i].opacity = 0.6f + (rand() % 40) / 100.0f;
-                    drops[i].active = (rand() % 100 < 70);
+                    drops[i].y = -(rng.below(10));
+                    drops[i].speed = 0.4f + rng.below(8) / 10.0f;
+                    drops[i].length = 6 + rng.below(10);
+                    drops[i].char_value = rng.below(256);
+                    drops[i].opacity = 0.6f + rng.below(40) / 100.0f;
+                    drops[i].active = (rng.below(100) < 70);
                 }
 
                 // Draw the trail
@@ -155,7 +154,7 @@ int main() {
                                 for (int py = 0; py < 5; ++py) {
                                     int draw_y = y_pos + py - 2;
                                     if (draw_y >= 0 && draw_y < 32 && (pattern[py] & (1 << (2 - px)))) {
-                                        if (rand() % 100 < 90) { // 90% chance to draw
+                                        if (rng.below(100) < 90) { // 90% chance to draw
                                             canvas->SetPixel(draw_x, draw_y, trail_color.r, trail_color.g, trail_color.b);
                                         }
                                     }
@@ -164,7 +163,7 @@ int main() {
                         }
 
                         // Add faint echo effect
-                        if (t > 2 && rand() % 100 < 20) {
+                        if (t > 2 && rng.below(100) < 20) {
                             int echo_y = y_pos + 1;
                             if (echo_y >= 0 && echo_y < 32) {
                                 Color echo_color = Color(trail_color.r * 0.3, trail_color.g * 0.3, trail_color.b * 0.3);
@@ -173,34 +172,31 @@ int main() {
                         }
 
                         // Occasional white glitch
-                        if (t == 0 && rand() % 100 < 8) {
+                        if (t == 0 && rng.below(100) < 8) {
                             canvas->SetPixel(x, y_pos, 255, 255, 255);
                         }
                     }
                 }
             } else {
                 // Randomly activate inactive drops
-                if (rand() % 100 < 3) {
+                if (rng.below(100) < 3) {
                     drops[i].active = true;
                     drops[i].y = 0;
-                    drops[i].char_value = rand() % 256;
-                    drops[i].opacity = 0.6f + (rand() % 40) / 100.0f;
+                    drops[i].char_value = rng.below(256);
+                    drops[i].opacity = 0.6f + rng.below(40) / 100.0f;
                 }
             }
         }
 
         // Random glitch pixels
-        if (rand() % 100 < 5) {
-            int flash_x = rand() % 32;
-            int flash_y = rand() % 32;
+        if (rng.below(100) < 5) {
+            int flash_x = rng.below(32);
+            int flash_y = rng.below(32);
             canvas->SetPixel(flash_x, flash_y, 255, 255, 255);
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(40000); // ~25 fps for smoother animation
     }
+};
 
-    delete matrix;
-    return 0;
-}
+RGB_SCENE_MAIN(MatrixV2Scene)
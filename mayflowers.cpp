@@ -1,22 +1,20 @@
 // May Flowers Scene
-// Compilation: g++ -o mayflowers mayflowers.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o mayflowers mayflowers.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/mayflowers.so mayflowers.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Flower {
     int x;
     int y;
@@ -43,25 +41,16 @@ struct Bee {
     int frame;
 };
 
-struct Petal {
-    float x;
-    float y;
-    float vx;
-    float vy;
-    int color_r, color_g, color_b;
-    float rotation;
-};
-
-class MayFlowersScene {
+class MayFlowersScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Flower> flowers;
     std::vector<Butterfly> butterflies;
     std::vector<Bee> bees;
-    std::vector<Petal> petals;
+    ParticlePool petals;
     float time_counter;
+    SceneRandom rng;
     
     // Flower colors
     Color tulip_red = Color(160, 20, 20);
@@ -95,45 +84,46 @@ private:
     Color bee_black = Color(20, 20, 20);
     
 public:
-    MayFlowersScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    MayFlowersScene() : canvas(NULL), width(0), height(0), petals(128), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "mayflowers");
         
         // Plant flowers in garden
         int num_flowers = width / 4; // Spacing for flowers
         for (int i = 0; i < num_flowers; i++) {
             Flower f;
-            f.x = 4 + (i * width / num_flowers) + (rand() % 3);
-            f.y = height - 8 - (rand() % 4);
-            f.type = rand() % 4;
-            f.color_variant = rand() % 4;
-            f.sway_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            f.sway_speed = 0.5 + (float)rand() / RAND_MAX * 0.5;
+            f.x = 4 + (i * width / num_flowers) + rng.below(3);
+            f.y = height - 8 - rng.below(4);
+            f.type = rng.below(4);
+            f.color_variant = rng.below(4);
+            f.sway_phase = rng.uniform() * 2 * M_PI;
+            f.sway_speed = 0.5 + rng.uniform() * 0.5;
             flowers.push_back(f);
         }
         
         // Add butterflies
         for (int i = 0; i < 2; i++) {
             Butterfly b;
-            b.x = rand() % width;
-            b.y = 5 + rand() % 10;
-            b.target_x = rand() % width;
-            b.target_y = 5 + rand() % 10;
-            b.speed = 0.2 + (float)rand() / RAND_MAX * 0.2;
+            b.x = rng.below(width);
+            b.y = 5 + rng.below(10);
+            b.target_x = rng.below(width);
+            b.target_y = 5 + rng.below(10);
+            b.speed = 0.2 + rng.uniform() * 0.2;
             b.wing_frame = 0;
-            b.color_type = rand() % 3;
+            b.color_type = rng.below(3);
             butterflies.push_back(b);
         }
         
         // Add bees
         for (int i = 0; i < 2; i++) {
             Bee bee;
-            bee.x = rand() % width;
-            bee.y = 8 + rand() % 8;
-            bee.angle = (float)rand() / RAND_MAX * 2 * M_PI;
+            bee.x = rng.below(width);
+            bee.y = 8 + rng.below(8);
+            bee.angle = rng.uniform() * 2 * M_PI;
             bee.frame = 0;
             bees.push_back(bee);
         }
@@ -160,7 +150,7 @@ public:
         for (int y = grass_start; y < height; y++) {
             for (int x = 0; x < width; x++) {
                 // Create grass texture
-                if ((x + y) % 3 == 0 || (rand() % 10 < 2)) {
+                if ((x + y) % 3 == 0 || (rng.below(10) < 2)) {
                     canvas->SetPixel(x, y, grass_light.r, grass_light.g, grass_light.b);
                 } else {
                     canvas->SetPixel(x, y, grass_dark.r, grass_dark.g, grass_dark.b);
@@ -170,7 +160,7 @@ public:
         
         // Add some grass blades
         for (int x = 0; x < width; x += 3) {
-            int blade_y = grass_start + (rand() % 3);
+            int blade_y = grass_start + rng.below(3);
             if (blade_y < height) {
                 canvas->SetPixel(x, blade_y, leaf_green.r, leaf_green.g, leaf_green.b);
             }
@@ -372,8 +362,8 @@ public:
                 butterfly.y += (dy / dist) * butterfly.speed;
             } else {
                 // Pick new target
-                butterfly.target_x = rand() % width;
-                butterfly.target_y = 5 + rand() % (int)(height * 0.4);
+                butterfly.target_x = rng.below(width);
+                butterfly.target_y = 5 + rng.below((int)(height * 0.4));
             }
             
             if ((int)(time_counter * 10) % 3 == 0) {
@@ -417,46 +407,34 @@ public:
     
     void updatePetals() {
         // Occasionally drop a petal
-        if (rand() % 30 == 0 && flowers.size() > 0) {
-            int flower_idx = rand() % flowers.size();
-            Petal p;
-            p.x = flowers[flower_idx].x;
-            p.y = flowers[flower_idx].y - 2;
-            p.vx = ((float)rand() / RAND_MAX - 0.5) * 0.3;
-            p.vy = 0.1 + (float)rand() / RAND_MAX * 0.1;
-            p.rotation = 0;
+        if (rng.below(30) == 0 && flowers.size() > 0) {
+            int flower_idx = rng.below(flowers.size());
+            float x = flowers[flower_idx].x;
+            float y = flowers[flower_idx].y - 2;
+            float vx = (rng.uniform() - 0.5) * 0.3;
+            float vy = 0.1 + rng.uniform() * 0.1;
             
-            // Random petal color
-            if (rand() % 2 == 0) {
-                p.color_r = tulip_pink.r;
-                p.color_g = tulip_pink.g;
-                p.color_b = tulip_pink.b;
-            } else {
-                p.color_r = daisy_white.r;
-                p.color_g = daisy_white.g;
-                p.color_b = daisy_white.b;
-            }
-            
-            petals.push_back(p);
+            // Random petal color; petals never age, they fall until they
+            // leave the panel
+            petals.spawn(x, y, vx, vy, 1, (rng.below(2) == 0) ? tulip_pink : daisy_white);
         }
         
         // Update and draw petals
-        for (auto it = petals.begin(); it != petals.end();) {
-            canvas->SetPixel((int)it->x, (int)it->y, it->color_r, it->color_g, it->color_b);
-            
-            it->x += it->vx;
-            it->y += it->vy;
-            it->rotation += 0.1;
-            
-            if (it->y > height) {
-                it = petals.erase(it);
+        petals.draw(canvas);
+        petals.integrate(1);
+        for (int i = 0; i < petals.count();) {
+            if (petals.y[i] > height) {
+                petals.kill(i);
             } else {
-                ++it;
+                i++;
             }
         }
     }
     
-    void update() {
+    int DefaultColumns() const { return 64; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -466,47 +444,8 @@ public:
         updateBees();
         updatePetals();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 64;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    MayFlowersScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(MayFlowersScene)
@@ -1,20 +1,17 @@
+// Mountain Winter Scene
+// Compilation: g++ -o mountain_winter mountain_winter.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/mountain_winter.so mountain_winter.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 struct Snowflake {
     float x;
     float y;
@@ -22,64 +19,52 @@ struct Snowflake {
     bool active;
 };
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class MountainWinterScene : public Scene {
+private:
     // Colors
-    Color sky(10, 10, 40);              // Dark blue night sky
-    Color mountain_dark(60, 60, 80);    // Dark mountain
-    Color mountain_light(100, 100, 120); // Lighter mountain
-    Color snow_cap(240, 240, 255);      // Snow on mountains
-    Color tree_green(0, 80, 0);         // Dark green for trees
-    Color trunk(80, 50, 20);            // Brown trunk
-    Color snow_white(255, 255, 255);    // White snow
-    Color light_red(255, 0, 0);         // Red Christmas lights
-    Color light_green(0, 255, 0);       // Green Christmas lights
-    Color light_yellow(255, 200, 0);    // Yellow Christmas lights
+    Color sky = Color(10, 10, 40);              // Dark blue night sky
+    Color mountain_dark = Color(60, 60, 80);    // Dark mountain
+    Color mountain_light = Color(100, 100, 120); // Lighter mountain
+    Color snow_cap = Color(240, 240, 255);      // Snow on mountains
+    Color tree_green = Color(0, 80, 0);         // Dark green for trees
+    Color trunk = Color(80, 50, 20);            // Brown trunk
+    Color snow_white = Color(255, 255, 255);    // White snow
+    Color light_red = Color(255, 0, 0);         // Red Christmas lights
+    Color light_green = Color(0, 255, 0);       // Green Christmas lights
+    Color light_yellow = Color(255, 200, 0);    // Yellow Christmas lights
 
     // Initialize snowflakes
-    const int num_snowflakes = 25;
+    static const int num_snowflakes = 25;
     Snowflake snowflakes[num_snowflakes];
-    for (int i = 0; i < num_snowflakes; ++i) {
-        snowflakes[i].x = rand() % 32;
-        snowflakes[i].y = -(rand() % 32);
-        snowflakes[i].speed = 0.15f + (rand() % 10) / 25.0f;
-        snowflakes[i].active = true;
-    }
 
     // Mountain peaks data (x, y pairs defining mountain outline)
-    int back_mountain[][2] = {
+    int back_mountain[7][2] = {
         {0, 20}, {5, 15}, {10, 18}, {15, 12}, {20, 16}, {25, 14}, {32, 18}
     };
 
-    int front_mountain[][2] = {
+    int front_mountain[6][2] = {
         {0, 28}, {6, 22}, {12, 25}, {18, 19}, {24, 23}, {32, 26}
     };
 
     // Twinkling state
-    int frame_count = 0;
+    int frame_count;
+    SceneRandom rng;
+
+public:
+    MountainWinterScene() : frame_count(0) {}
 
-    // Display until interrupted
-    while (running) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "mountain_winter");
+
+        for (int i = 0; i < num_snowflakes; ++i) {
+            snowflakes[i].x = rng.below(32);
+            snowflakes[i].y = -(rng.below(32));
+            snowflakes[i].speed = 0.15f + rng.below(10) / 25.0f;
+            snowflakes[i].active = true;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with night sky
         canvas->Fill(sky.r, sky.g, sky.b);
 
@@ -195,8 +180,8 @@ int main() {
 
                 if (snowflakes[i].y >= 32) {
                     snowflakes[i].y = 0;
-                    snowflakes[i].x = rand() % 32;
-                    snowflakes[i].speed = 0.15f + (rand() % 10) / 25.0f;
+                    snowflakes[i].x = rng.below(32);
+                    snowflakes[i].speed = 0.15f + rng.below(10) / 25.0f;
                 }
 
                 int snow_x = (int)snowflakes[i].x;
@@ -208,12 +193,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(MountainWinterScene)
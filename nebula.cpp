@@ -1,5 +1,13 @@
+// Nebula Scene
+// Compilation: g++ -o nebula nebula.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/nebula.so nebula.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "polarmap.h"
+#include "noisetexture.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
@@ -7,68 +15,36 @@
 #include <ctime>
 using namespace rgb_matrix;
 
-// Simple noise function for organic cloud patterns
-float noise2d(float x, float y, int seed) {
-    int ix = (int)x;
-    int iy = (int)y;
-    float fx = x - ix;
-    float fy = y - iy;
-    
-    // Hash function for pseudo-random values
-    int n = ix + iy * 57 + seed * 131;
-    n = (n << 13) ^ n;
-    float val = 1.0f - ((n * (n * n * 15731 + 789221) + 1376312589) & 0x7fffffff) / 1073741824.0f;
+class NebulaScene : public Scene {
+private:
+    int frame_count;
     
-    return (val + 1.0f) * 0.5f; // Normalize to 0-1
-}
-
-float smoothNoise(float x, float y, int seed) {
-    float corners = (noise2d(x-1, y-1, seed) + noise2d(x+1, y-1, seed) + 
-                    noise2d(x-1, y+1, seed) + noise2d(x+1, y+1, seed)) / 16.0f;
-    float sides = (noise2d(x-1, y, seed) + noise2d(x+1, y, seed) + 
-                  noise2d(x, y-1, seed) + noise2d(x, y+1, seed)) / 8.0f;
-    float center = noise2d(x, y, seed) / 4.0f;
+    // The clouds only scroll, so their turbulence is baked once into
+    // tiling textures and sampled with the scroll offset
+    NoiseTexture clouds_large, clouds_wide, clouds_fine;
     
-    return corners + sides + center;
-}
-
-float turbulence(float x, float y, float size, int seed) {
-    float value = 0.0f;
-    float initialSize = size;
+    // Distance from the centre never changes; cache it with the pulse wave
+    PolarMap polar;
+    PolarMap::Wave pulse_wave;
     
-    while (size >= 1) {
-        value += smoothNoise(x / size, y / size, seed) * size;
-        size /= 2.0f;
-    }
+public:
+    NebulaScene() : frame_count(0) {}
     
-    return value / initialSize;
-}
-
-int main() {
-    srand(time(NULL));
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
+    void Init(int w, int h) {
+        SceneRandom rng(Seed(), "nebula");
+        int seed = rng.below(1000);
+        clouds_large.bake(128, 32, seed);
+        clouds_wide.bake(128, 16, seed + 1);
+        clouds_fine.bake(128, 8, seed + 2);
+        
+        polar.build(32, 32, 16.0f, 16.0f);
+        pulse_wave = polar.radial(0.3f);
     }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
-    int frame_count = 0;
-    int seed = rand() % 1000;
     
-    // Display continuously
-    while (true) {
+    void Render(Canvas *canvas) {
+        const float *distances = polar.distance();
         float time = frame_count * 0.02f;
+        const float pulse_sin = sin(time * 2.0f), pulse_cos = cos(time * 2.0f);
         
         // Draw nebula
         for (int y = 0; y < 32; ++y) {
@@ -77,18 +53,17 @@ int main() {
                 float fy = y + time * 1.5f;
                 
                 // Multi-layer turbulence for cloud-like appearance
-                float cloud1 = turbulence(fx, fy, 32.0f, seed);
-                float cloud2 = turbulence(fx * 0.5f, fy * 0.5f, 16.0f, seed + 1);
-                float cloud3 = turbulence(fx * 2.0f, fy * 2.0f, 8.0f, seed + 2);
+                float cloud1 = clouds_large.sample(fx, fy);
+                float cloud2 = clouds_wide.sample(fx * 0.5f, fy * 0.5f);
+                float cloud3 = clouds_fine.sample(fx * 2.0f, fy * 2.0f);
                 
                 // Combine layers
                 float density = (cloud1 * 0.5f + cloud2 * 0.3f + cloud3 * 0.2f);
                 density = density / 20.0f; // Normalize
                 
                 // Add distance from center for bright core
-                float dx = x - 16.0f;
-                float dy = y - 16.0f;
-                float dist = sqrt(dx*dx + dy*dy);
+                const int i = y * 32 + x;
+                float dist = distances[i];
                 float core_brightness = 1.0f - (dist / 23.0f);
                 if (core_brightness < 0) core_brightness = 0;
                 core_brightness = core_brightness * core_brightness; // Sharper falloff
@@ -134,7 +109,9 @@ int main() {
                 
                 // Add subtle pulsing to bright regions
                 if (total_density > 0.5f) {
-                    float pulse = sin(time * 2.0f + dist * 0.3f) * 0.1f + 1.0f;
+                    // sin(time * 2 + dist * 0.3)
+                    float wave = pulse_sin * pulse_wave.cos[i] + pulse_cos * pulse_wave.sin[i];
+                    float pulse = wave * 0.1f + 1.0f;
                     r = (int)(r * pulse);
                     g = (int)(g * pulse);
                     b = (int)(b * pulse);
@@ -157,7 +134,7 @@ int main() {
             // Only show stars in darker regions
             float fx = sx + time * 2.0f;
             float fy = sy + time * 1.5f;
-            float density = turbulence(fx, fy, 32.0f, seed) / 20.0f;
+            float density = clouds_large.sample(fx, fy) / 20.0f;
             
             if (density < 0.3f) {
                 // Twinkling stars
@@ -177,7 +154,7 @@ int main() {
             // Check if position is in dark region
             float fx = cx + time * 2.0f;
             float fy = cy + time * 1.5f;
-            float density = turbulence(fx, fy, 32.0f, seed) / 20.0f;
+            float density = clouds_large.sample(fx, fy) / 20.0f;
             
             if (density < 0.25f) {
                 // Bright star
@@ -191,10 +168,7 @@ int main() {
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(NebulaScene)
@@ -1,21 +1,21 @@
+// New Year's Eve Scene
+// Compilation: g++ -o new_years_eve new_years_eve.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/new_years_eve.so new_years_eve.cpp -lrgbmatrix -std=c++11
+
 // New Year's Eve Winter Scene
-// Compilation: g++ -o new_years_eve_winter new_years_eve_winter.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -lrgbmatrix -lpthread -lm
+// Compilation: g++ -o new_years_eve_winter new_years_eve_winter.cpp -I ~/rgbMatrix/rpi-rgb-led-matrix/include -L ~/rgbMatrix/rpi-rgb-led-matrix/lib -L. -lrgbscene -lrgbmatrix -lpthread -lm
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Snowflake {
     float x;
     float y;
@@ -23,75 +23,62 @@ struct Snowflake {
     bool active;
 };
 
-int main() {
-    srand(time(NULL));
-
-    // Set up signal handler for graceful exit
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class NewYearsEveScene : public Scene {
+private:
     // Colors
-    Color sky(10, 10, 40);           // Dark blue night sky
-    Color ground(240, 240, 255);     // White snow ground
-    Color tree_green(0, 100, 0);     // Dark green for tree
-    Color trunk(101, 67, 33);        // Brown trunk
-    Color snow_white(255, 255, 255); // White snow
-    Color light_silver(192, 192, 192); // Silver New Year's lights
-    Color light_gold(200, 180, 0);   // Gold New Year's lights
-    Color clock_black(0, 0, 0);      // Black for clock
-    Color clock_white(255, 255, 255); // White for clock hands/numbers
-    Color year_gold(200, 180, 0);    // Gold for "2026" text
+    Color sky = Color(10, 10, 40);           // Dark blue night sky
+    Color ground = Color(240, 240, 255);     // White snow ground
+    Color tree_green = Color(0, 100, 0);     // Dark green for tree
+    Color trunk = Color(101, 67, 33);        // Brown trunk
+    Color snow_white = Color(255, 255, 255); // White snow
+    Color light_silver = Color(192, 192, 192); // Silver New Year's lights
+    Color light_gold = Color(200, 180, 0);   // Gold New Year's lights
+    Color clock_black = Color(0, 0, 0);      // Black for clock
+    Color clock_white = Color(255, 255, 255); // White for clock hands/numbers
+    Color year_gold = Color(200, 180, 0);    // Gold for "2026" text
 
     // Initialize snowflakes
-    const int num_snowflakes = 20;
+    static const int num_snowflakes = 20;
     Snowflake snowflakes[num_snowflakes];
-    for (int i = 0; i < num_snowflakes; ++i) {
-        snowflakes[i].x = rand() % 32;
-        snowflakes[i].y = -(rand() % 32);  // Start above screen
-        snowflakes[i].speed = 0.1f + (rand() % 10) / 20.0f;  // 0.1 to 0.6
-        snowflakes[i].active = true;
-    }
 
     // New Year's light positions on tree (will alternate silver/gold)
-    int light_positions[][2] = {
+    int light_positions[15][2] = {
         {16, 8},   // Top
         {14, 11}, {18, 11},  // Second row
         {13, 14}, {16, 14}, {19, 14},  // Third row
         {12, 17}, {15, 17}, {18, 17}, {21, 17},  // Fourth row
         {11, 20}, {14, 20}, {17, 20}, {20, 20}, {23, 20}  // Fifth row
     };
-    int num_lights = 15;
+    int num_lights;
 
     // Twinkling state
-    int frame_count = 0;
+    int frame_count;
 
     // Static clock at midnight (12:00)
-    int clock_x = 8;
-    int clock_y = 5;
-    int clock_radius = 3;
+    int clock_x;
+    int clock_y;
+    int clock_radius;
 
     // Static "2026" sign
-    int sign_x = 10;
-    int sign_y = 22;
+    int sign_x;
+    int sign_y;
+    SceneRandom rng;
+
+public:
+    NewYearsEveScene() : num_lights(15), frame_count(0), clock_x(8), clock_y(5), clock_radius(3), sign_x(10), sign_y(22) {}
+
+    void Init(int w, int h) {
+        rng.seed(Seed(), "new_years_eve");
 
-    // Display continuously
-    while (!interrupt_received) {
+        for (int i = 0; i < num_snowflakes; ++i) {
+            snowflakes[i].x = rng.below(32);
+            snowflakes[i].y = -(rng.below(32));  // Start above screen
+            snowflakes[i].speed = 0.1f + rng.below(10) / 20.0f;  // 0.1 to 0.6
+            snowflakes[i].active = true;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with night sky
         canvas->Fill(sky.r, sky.g, sky.b);
 
@@ -156,8 +143,8 @@ int main() {
 
                 if (snowflakes[i].y >= 27) {
                     snowflakes[i].y = 0;
-                    snowflakes[i].x = rand() % 32;
-                    snowflakes[i].speed = 0.1f + (rand() % 10) / 20.0f;
+                    snowflakes[i].x = rng.below(32);
+                    snowflakes[i].speed = 0.1f + rng.below(10) / 20.0f;
                 }
 
                 int snow_x = static_cast<int>(snowflakes[i].x);
@@ -223,15 +210,7 @@ int main() {
         canvas->SetPixel(sign_x + 14, sign_y + 2, year_gold.r, year_gold.g, year_gold.b);
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Clean up on exit - clear the display
-    canvas->Clear();
-    canvas = matrix->SwapOnVSync(canvas);
-    delete matrix;
-
-    std::cout << "\nDisplay cleared. Exiting gracefully.\n";
-    return 0;
-}
+RGB_SCENE_MAIN(NewYearsEveScene)
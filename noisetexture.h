@@ -0,0 +1,86 @@
+// Tileable noise textures for cloud, smoke and fog effects
+//
+// Multi-octave value noise is expensive to evaluate per pixel (every octave
+// blurs nine lattice hashes), but effects that only scroll it never need a
+// fresh value: bake it once into a texture that wraps at its edges and
+// sample that with the scroll offset:
+//
+//   NoiseTexture clouds;
+//   clouds.bake(128, 32, seed);              // once, at startup
+//   float density = clouds.sample(x + time * 2.0f, y + time * 1.5f);
+//
+// The noise is the hash/blur/turbulence nebula.cpp used to compute per
+// pixel, with lattice coordinates wrapped so the texture tiles. Samples are
+// bilinearly filtered between texels.
+//
+// Header only, so plugins can use it without linking librgbscene.
+
+#ifndef NOISETEXTURE_H
+#define NOISETEXTURE_H
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+class NoiseTexture {
+private:
+    int size;                   // Texels per side, a power of two
+    std::vector<float> texels;  // Row-major
+
+    // Pseudo-random 0-1 value for a lattice point
+    static float hash(int ix, int iy, int seed) {
+        uint32_t n = ix + iy * 57 + seed * 131;
+        n = (n << 13) ^ n;
+        const float val = 1.0f - ((n * (n * n * 15731u + 789221u) + 1376312589u) & 0x7fffffff) / 1073741824.0f;
+        return (val + 1.0f) * 0.5f;
+    }
+
+    // Lattice value blurred with its eight neighbours; coordinates wrap at
+    // `period` lattice cells
+    static float smooth(int ix, int iy, int period, int seed) {
+        const int x0 = (ix + period - 1) % period, x1 = ix % period, x2 = (ix + 1) % period;
+        const int y0 = (iy + period - 1) % period, y1 = iy % period, y2 = (iy + 1) % period;
+        const float corners = (hash(x0, y0, seed) + hash(x2, y0, seed) +
+                               hash(x0, y2, seed) + hash(x2, y2, seed)) / 16.0f;
+        const float sides = (hash(x0, y1, seed) + hash(x2, y1, seed) +
+                             hash(x1, y0, seed) + hash(x1, y2, seed)) / 8.0f;
+        const float center = hash(x1, y1, seed) / 4.0f;
+        return corners + sides + center;
+    }
+
+public:
+    NoiseTexture() : size(0) {}
+
+    // Bakes turbulence with octaves of `largest_octave`, half that, ... down
+    // to one texel. `texture_size` has to be a power of two and a multiple
+    // of `largest_octave` for the texture to tile.
+    void bake(int texture_size, int largest_octave, int seed) {
+        size = texture_size;
+        texels.assign(size * size, 0.0f);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                float value = 0.0f;
+                for (int octave = largest_octave; octave >= 1; octave /= 2) {
+                    value += smooth(x / octave, y / octave, size / octave, seed) * octave;
+                }
+                texels[y * size + x] = value / largest_octave;
+            }
+        }
+    }
+
+    // Bilinear sample at texel coordinates (u, v); any value wraps.
+    float sample(float u, float v) const {
+        const float fu = floorf(u), fv = floorf(v);
+        const float tu = u - fu, tv = v - fv;
+        const int mask = size - 1;
+        const int x0 = (int)fu & mask, x1 = (x0 + 1) & mask;
+        const int y0 = (int)fv & mask, y1 = (y0 + 1) & mask;
+        const float *row0 = &texels[y0 * size];
+        const float *row1 = &texels[y1 * size];
+        const float top = row0[x0] + (row0[x1] - row0[x0]) * tu;
+        const float bottom = row1[x0] + (row1[x1] - row1[x0]) * tu;
+        return top + (bottom - top) * tv;
+    }
+};
+
+#endif // NOISETEXTURE_H
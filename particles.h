@@ -0,0 +1,179 @@
+// Pooled particles for sparkles, sparks, flames and debris
+//
+// Scenes used to keep particles in a std::vector and erase() them from the
+// middle while iterating, which shifts everything behind them and
+// reallocates as bursts push_back. A ParticlePool allocates its capacity
+// once and stores each field in its own array; a dead particle is replaced
+// by the last live one, so removal is O(1) and live particles stay packed
+// at indices 0..count()-1.
+//
+//   ParticlePool sparks(256);
+//   int i = sparks.spawn(x, y, vx, vy, 20, Color(255, 200, 0));
+//   if (i >= 0) sparks.kind[i] = ...;   // Full pools drop new particles
+//
+//   // Each frame (or with dt in seconds for time-stepped scenes)
+//   sparks.age(1);             // Removes the expired ones
+//   sparks.draw(canvas);       // Or a custom loop over 0..count()-1
+//   sparks.integrate(1, 0.02f);
+//
+// The passes are separate loops over plain arrays, so the position update
+// vectorizes. `kind` is a free byte per particle for the scene's own use:
+// a palette index, a flag, a hue.
+//
+// Header only, so plugins can use it without linking librgbscene.
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "led-matrix.h"
+#include "graphics.h"
+#include <stdint.h>
+#include <vector>
+
+class ParticlePool {
+private:
+    int capacity_;
+    int count_;
+
+    std::vector<float> storage;
+    std::vector<uint8_t> bytes;
+
+public:
+    // Field arrays, valid for indices 0..count()-1
+    float *x;
+    float *y;
+    float *vx;
+    float *vy;
+    float *life;        // Time lived so far
+    float *max_life;    // Removed once life reaches it
+    uint8_t *r;
+    uint8_t *g;
+    uint8_t *b;
+    uint8_t *kind;
+
+    explicit ParticlePool(int capacity)
+        : capacity_(capacity), count_(0), storage(capacity * 6), bytes(capacity * 4) {
+        x = &storage[0];
+        y = x + capacity;
+        vx = y + capacity;
+        vy = vx + capacity;
+        life = vy + capacity;
+        max_life = life + capacity;
+        r = &bytes[0];
+        g = r + capacity;
+        b = g + capacity;
+        kind = b + capacity;
+    }
+
+    // The field pointers point into this pool's own storage
+    ParticlePool(const ParticlePool &) = delete;
+    ParticlePool &operator=(const ParticlePool &) = delete;
+
+    int count() const { return count_; }
+    int capacity() const { return capacity_; }
+    void clear() { count_ = 0; }
+
+    // Index of the new particle, or -1 if the pool is full
+    int spawn(float px, float py, float pvx, float pvy, float lifetime,
+              const rgb_matrix::Color &color) {
+        if (count_ == capacity_) return -1;
+        const int i = count_++;
+        x[i] = px;
+        y[i] = py;
+        vx[i] = pvx;
+        vy[i] = pvy;
+        life[i] = 0.0f;
+        max_life[i] = lifetime;
+        r[i] = color.r;
+        g[i] = color.g;
+        b[i] = color.b;
+        kind[i] = 0;
+        return i;
+    }
+
+    // Removes particle i by moving the last one into its slot. When killing
+    // while iterating, look at index i again afterwards.
+    void kill(int i) {
+        const int last = --count_;
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        life[i] = life[last];
+        max_life[i] = max_life[last];
+        r[i] = r[last];
+        g[i] = g[last];
+        b[i] = b[last];
+        kind[i] = kind[last];
+    }
+
+    // 1 for a newborn particle, falling to 0 as it reaches max_life; 0 for
+    // particles spawned without a lifetime
+    float fade(int i) const { return max_life[i] > 0.0f ? 1.0f - life[i] / max_life[i] : 0.0f; }
+
+    // Advances every particle's life by dt and removes the expired ones
+    void age(float dt) {
+        for (int i = 0; i < count_;) {
+            life[i] += dt;
+            if (life[i] >= max_life[i]) {
+                kill(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    // Moves every particle by its velocity, then applies gravity to vy
+    void integrate(float dt, float gravity = 0.0f) {
+        for (int i = 0; i < count_; i++) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            vy[i] += gravity * dt;
+        }
+    }
+
+    // Removes particles outside left <= x < right, top <= y < bottom
+    void cull(float left, float top, float right, float bottom) {
+        for (int i = 0; i < count_;) {
+            if (x[i] < left || x[i] >= right || y[i] < top || y[i] >= bottom) {
+                kill(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    // One pixel per particle in its colour, dimmed by fade()
+    void draw(rgb_matrix::Canvas *canvas) const {
+        const int w = canvas->width(), h = canvas->height();
+        for (int i = 0; i < count_; i++) {
+            const int px = (int)x[i], py = (int)y[i];
+            if (px < 0 || px >= w || py < 0 || py >= h) continue;
+            const float f = fade(i);
+            canvas->SetPixel(px, py, r[i] * f, g[i] * f, b[i] * f);
+        }
+    }
+};
+
+// Spreads a steady spawn rate over frames: due() returns how many
+// particles to spawn for this step, carrying the fractions over.
+class ParticleEmitter {
+private:
+    float rate;     // Particles per unit of dt
+    float pending;
+
+public:
+    explicit ParticleEmitter(float particles_per_step = 0.0f)
+        : rate(particles_per_step), pending(0.0f) {}
+
+    void setRate(float particles_per_step) { rate = particles_per_step; }
+
+    int due(float dt) {
+        pending += rate * dt;
+        const int n = (int)pending;
+        pending -= n;
+        return n;
+    }
+};
+
+#endif // PARTICLES_H
@@ -0,0 +1,117 @@
+// Polar geometry cache for radial per-pixel scenes
+//
+// Distance and angle from the centre depend only on (x, y), so instead of
+// calling sqrt()/atan2() for every pixel of every frame a scene builds them
+// once per canvas size and centre. Angular and radial waves are cached as
+// sin/cos tables too; a time-varying phase is then applied with the angle
+// sum identity, e.g. for sin(6 * angle + t):
+//
+//   PolarMap::Wave spokes = polar.angular(6.0f);
+//   const float s = sinf(t), c = cosf(t);
+//   float value = spokes.sin[i] * c + spokes.cos[i] * s;
+//
+// Tables are indexed by y * width + x. Header only, so plugins can use it
+// without linking librgbscene.
+
+#ifndef POLARMAP_H
+#define POLARMAP_H
+
+#include <math.h>
+#include <vector>
+
+class PolarMap {
+public:
+    // sin/cos of (multiple * angle) or (multiple * distance) per pixel
+    struct Wave {
+        const float *sin;
+        const float *cos;
+    };
+
+private:
+    struct Table {
+        bool radial;
+        float multiple;
+        std::vector<float> sin_values;
+        std::vector<float> cos_values;
+    };
+
+    int w;
+    int h;
+    float center_x;
+    float center_y;
+    std::vector<float> distances;
+    std::vector<float> angles;   // atan2(dy, dx), -pi..pi
+    std::vector<float> turns;    // angle / 2pi, -0.5..0.5
+    std::vector<Table> tables;
+
+    void fill(Table &table) const {
+        const size_t n = distances.size();
+        table.sin_values.resize(n);
+        table.cos_values.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const float v = table.multiple * (table.radial ? distances[i] : angles[i]);
+            table.sin_values[i] = sinf(v);
+            table.cos_values[i] = cosf(v);
+        }
+    }
+
+    Wave wave(bool radial, float multiple) {
+        for (size_t i = 0; i < tables.size(); i++) {
+            if (tables[i].radial == radial && tables[i].multiple == multiple) {
+                Wave found = { &tables[i].sin_values[0], &tables[i].cos_values[0] };
+                return found;
+            }
+        }
+        Table table;
+        table.radial = radial;
+        table.multiple = multiple;
+        fill(table);
+        tables.push_back(table);
+        Wave added = { &tables.back().sin_values[0], &tables.back().cos_values[0] };
+        return added;
+    }
+
+public:
+    PolarMap() : w(0), h(0), center_x(0), center_y(0) {}
+
+    // Recomputes every table for a new size or centre; a no-op when both
+    // are unchanged, so it is cheap to call at the start of each frame.
+    void build(int width, int height, float cx, float cy) {
+        if (width == w && height == h && cx == center_x && cy == center_y) return;
+        w = width;
+        h = height;
+        center_x = cx;
+        center_y = cy;
+        distances.resize(w * h);
+        angles.resize(w * h);
+        turns.resize(w * h);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                const float dx = x - cx;
+                const float dy = y - cy;
+                const int i = y * w + x;
+                distances[i] = sqrtf(dx * dx + dy * dy);
+                angles[i] = atan2f(dy, dx);
+                turns[i] = angles[i] / (2.0f * (float)M_PI);
+            }
+        }
+        for (size_t i = 0; i < tables.size(); i++) {
+            fill(tables[i]);
+        }
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    const float *distance() const { return &distances[0]; }
+    const float *angle() const { return &angles[0]; }
+    const float *turn() const { return &turns[0]; }
+
+    // sin/cos(multiple * angle) and sin/cos(multiple * distance). The first
+    // request for a multiple computes its table; pointers stay valid until
+    // the next build() that changes the geometry.
+    Wave angular(float multiple) { return wave(false, multiple); }
+    Wave radial(float multiple) { return wave(true, multiple); }
+};
+
+#endif // POLARMAP_H
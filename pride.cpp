@@ -1,22 +1,20 @@
 // Pride Celebration Scene
-// Compilation: g++ -o pride pride.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o pride pride.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/pride.so pride.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct RainbowWave {
     float phase;
     int y_offset;
@@ -41,30 +39,23 @@ struct Heart {
     float pulse_phase;
 };
 
-struct Sparkle {
-    int x;
-    int y;
-    int life;
-    int max_life;
-    int color_index;
-};
-
 struct RainbowFlag {
     int start_y;
     float wave_phase;
 };
 
-class PrideScene {
+class PrideScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<RainbowWave> waves;
     std::vector<Confetti> confetti;
     std::vector<Heart> hearts;
-    std::vector<Sparkle> sparkles;
+    ParticlePool sparkles;
+    ParticleEmitter sparkle_emitter;
     RainbowFlag flag;
     float time_counter;
+    SceneRandom rng;
     
     // Classic Pride rainbow colors (6-stripe version)
     std::vector<Color> pride_colors = {
@@ -89,12 +80,14 @@ private:
     Color sparkle_gold = Color(255, 215, 0);
     
 public:
-    PrideScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    PrideScene() : canvas(NULL), width(0), height(0), sparkles(64), sparkle_emitter(0.4),
+                   time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "pride");
         
         // Create rainbow waves
         for (int i = 0; i < 6; i++) {
@@ -107,25 +100,25 @@ public:
         // Create confetti
         for (int i = 0; i < 20; i++) {
             Confetti c;
-            c.x = rand() % width;
-            c.y = -(rand() % height);
-            c.vx = ((float)rand() / RAND_MAX - 0.5) * 0.2;
-            c.vy = 0.3 + (float)rand() / RAND_MAX * 0.3;
-            c.color_index = rand() % 6;
-            c.rotation = (float)rand() / RAND_MAX * 2 * M_PI;
-            c.rot_speed = ((float)rand() / RAND_MAX - 0.5) * 0.1;
+            c.x = rng.below(width);
+            c.y = -(rng.below(height));
+            c.vx = (rng.uniform() - 0.5) * 0.2;
+            c.vy = 0.3 + rng.uniform() * 0.3;
+            c.color_index = rng.below(6);
+            c.rotation = rng.uniform() * 2 * M_PI;
+            c.rot_speed = (rng.uniform() - 0.5) * 0.1;
             confetti.push_back(c);
         }
         
         // Create floating hearts
         for (int i = 0; i < 4; i++) {
             Heart h;
-            h.x = rand() % width;
-            h.y = height + rand() % 10;
-            h.speed = 0.15 + (float)rand() / RAND_MAX * 0.15;
-            h.size = 2 + rand() % 2;
-            h.color_type = rand() % 6;
-            h.pulse_phase = (float)rand() / RAND_MAX * 2 * M_PI;
+            h.x = rng.below(width);
+            h.y = height + rng.below(10);
+            h.speed = 0.15 + rng.uniform() * 0.15;
+            h.size = 2 + rng.below(2);
+            h.color_type = rng.below(6);
+            h.pulse_phase = rng.uniform() * 2 * M_PI;
             hearts.push_back(h);
         }
         
@@ -236,8 +229,8 @@ public:
             // Reset when off screen
             if (heart.y < -5) {
                 heart.y = height + 5;
-                heart.x = rand() % width;
-                heart.color_type = rand() % 6;
+                heart.x = rng.below(width);
+                heart.color_type = rng.below(6);
             }
         }
     }
@@ -276,50 +269,41 @@ public:
             // Reset at bottom
             if (conf.y > height) {
                 conf.y = -2;
-                conf.x = rand() % width;
-                conf.color_index = rand() % 6;
+                conf.x = rng.below(width);
+                conf.color_index = rng.below(6);
             }
         }
     }
     
     void addSparkles() {
-        // Randomly add sparkles
-        if (rand() % 10 < 4) {
-            Sparkle s;
-            s.x = rand() % width;
-            s.y = rand() % height;
-            s.life = 0;
-            s.max_life = 10 + rand() % 15;
-            s.color_index = rand() % 6;
-            sparkles.push_back(s);
+        // Add a sparkle every two or three frames
+        for (int n = sparkle_emitter.due(1); n > 0; n--) {
+            float x = rng.below(width);
+            float y = rng.below(height);
+            int max_life = 10 + rng.below(15);
+            sparkles.spawn(x, y, 0, 0, max_life, pride_colors[rng.below(6)]);
         }
         
         // Update and draw sparkles
-        for (auto it = sparkles.begin(); it != sparkles.end();) {
-            it->life++;
+        sparkles.age(1);
+        for (int i = 0; i < sparkles.count(); i++) {
+            float brightness = sparkles.fade(i);
+            brightness = sin(brightness * M_PI); // Smooth fade in/out
             
-            if (it->life < it->max_life) {
-                float brightness = 1.0 - (float)it->life / it->max_life;
-                brightness = sin(brightness * M_PI); // Smooth fade in/out
-                
-                Color spark_color = pride_colors[it->color_index];
-                int r = spark_color.r * brightness;
-                int g = spark_color.g * brightness;
-                int b = spark_color.b * brightness;
-                
-                canvas->SetPixel(it->x, it->y, r, g, b);
-                
-                // Sparkle rays
-                if (it->life < it->max_life / 2) {
-                    if (it->x > 0) canvas->SetPixel(it->x - 1, it->y, r * 0.6, g * 0.6, b * 0.6);
-                    if (it->x < width - 1) canvas->SetPixel(it->x + 1, it->y, r * 0.6, g * 0.6, b * 0.6);
-                    if (it->y > 0) canvas->SetPixel(it->x, it->y - 1, r * 0.6, g * 0.6, b * 0.6);
-                    if (it->y < height - 1) canvas->SetPixel(it->x, it->y + 1, r * 0.6, g * 0.6, b * 0.6);
-                }
-                
-                ++it;
-            } else {
-                it = sparkles.erase(it);
+            int x = sparkles.x[i];
+            int y = sparkles.y[i];
+            int r = sparkles.r[i] * brightness;
+            int g = sparkles.g[i] * brightness;
+            int b = sparkles.b[i] * brightness;
+            
+            canvas->SetPixel(x, y, r, g, b);
+            
+            // Sparkle rays
+            if (sparkles.life[i] < sparkles.max_life[i] / 2) {
+                if (x > 0) canvas->SetPixel(x - 1, y, r * 0.6, g * 0.6, b * 0.6);
+                if (x < width - 1) canvas->SetPixel(x + 1, y, r * 0.6, g * 0.6, b * 0.6);
+                if (y > 0) canvas->SetPixel(x, y - 1, r * 0.6, g * 0.6, b * 0.6);
+                if (y < height - 1) canvas->SetPixel(x, y + 1, r * 0.6, g * 0.6, b * 0.6);
             }
         }
     }
@@ -369,7 +353,8 @@ public:
         }
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawRainbowBackground();
@@ -379,47 +364,8 @@ public:
         addSparkles();
         drawPrideText();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    PrideScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(PrideScene)
@@ -1,22 +1,21 @@
 // Progress Bar Scene
-// Compilation: g++ -o progressbar progressbar.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o progressbar progressbar.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/progressbar.so progressbar.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
+#include "hsv.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct ProgressBar {
     int x;
     int y;
@@ -27,24 +26,14 @@ struct ProgressBar {
     float animation_phase;
 };
 
-struct Particle {
-    float x;
-    float y;
-    float vx;
-    float vy;
-    int life;
-    int max_life;
-    int r, g, b;
-};
-
-class ProgressBarScene {
+class ProgressBarScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<ProgressBar> progress_bars;
-    std::vector<Particle> particles;
+    ParticlePool particles;
     float time_counter;
+    SceneRandom rng;
     
     // Colors
     Color bg_dark = Color(20, 20, 30);
@@ -57,12 +46,13 @@ private:
     Color empty_gray = Color(40, 40, 50);
     
 public:
-    ProgressBarScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    ProgressBarScene() : canvas(NULL), width(0), height(0), particles(256), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "progressbar");
         
         // Create multiple progress bars with different styles
         int bar_width = width - 8;
@@ -82,30 +72,8 @@ public:
         }
     }
     
-    void HSVtoRGB(float h, float s, float v, int &r, int &g, int &b) {
-        float c = v * s;
-        float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
-        float m = v - c;
-        
-        float r1, g1, b1;
-        if (h < 60) { r1 = c; g1 = x; b1 = 0; }
-        else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
-        else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
-        else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
-        else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
-        else { r1 = c; g1 = 0; b1 = x; }
-        
-        r = (r1 + m) * 255;
-        g = (g1 + m) * 255;
-        b = (b1 + m) * 255;
-    }
-    
     void drawBackground() {
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                canvas->SetPixel(x, y, bg_dark.r, bg_dark.g, bg_dark.b);
-            }
-        }
+        canvas->Fill(bg_dark.r, bg_dark.g, bg_dark.b);
     }
     
     void drawClassicProgressBar(ProgressBar& pb) {
@@ -309,58 +277,41 @@ public:
         }
         
         // Emit particles when complete
-        if (pb.progress >= 0.99 && rand() % 5 < 2) {
-            Particle p;
-            p.x = pb.x + pb.width - 2;
-            p.y = pb.y + pb.height / 2;
-            p.vx = 0.3 + (float)rand() / RAND_MAX * 0.3;
-            p.vy = ((float)rand() / RAND_MAX - 0.5) * 0.4;
-            p.life = 0;
-            p.max_life = 20 + rand() % 20;
+        if (pb.progress >= 0.99 && rng.below(5) < 2) {
+            float x = pb.x + pb.width - 2;
+            float y = pb.y + pb.height / 2;
+            float vx = 0.3 + rng.uniform() * 0.3;
+            float vy = (rng.uniform() - 0.5) * 0.4;
+            int max_life = 20 + rng.below(20);
             
             // Color based on bar style
+            Color color;
             switch(pb.style) {
                 case 0:
-                    p.r = bar_green.r; p.g = bar_green.g; p.b = bar_green.b;
+                    color = bar_green;
                     break;
                 case 1:
-                    p.r = bar_blue.r; p.g = bar_blue.g; p.b = bar_blue.b;
+                    color = bar_blue;
                     break;
                 case 2:
-                    p.r = bar_yellow.r; p.g = bar_yellow.g; p.b = bar_yellow.b;
+                    color = bar_yellow;
                     break;
-                case 3:
-                    HSVtoRGB(rand() % 360, 1.0, 0.9, p.r, p.g, p.b);
+                case 3: {
+                    int r, g, b;
+                    HSVtoRGB(rng.below(360), 1.0, 0.9, r, g, b);
+                    color = Color(r, g, b);
                     break;
+                }
             }
             
-            particles.push_back(p);
+            particles.spawn(x, y, vx, vy, max_life, color);
         }
     }
     
     void updateParticles() {
-        for (auto it = particles.begin(); it != particles.end();) {
-            it->life++;
-            
-            if (it->life < it->max_life) {
-                float fade = 1.0 - (float)it->life / it->max_life;
-                
-                int px = (int)it->x;
-                int py = (int)it->y;
-                
-                if (px >= 0 && px < width && py >= 0 && py < height) {
-                    canvas->SetPixel(px, py, it->r * fade, it->g * fade, it->b * fade);
-                }
-                
-                it->x += it->vx;
-                it->y += it->vy;
-                it->vy += 0.02; // Gravity
-                
-                ++it;
-            } else {
-                it = particles.erase(it);
-            }
-        }
+        particles.age(1);
+        particles.draw(canvas);
+        particles.integrate(1, 0.02); // Gravity
     }
     
     void drawPercentageText(ProgressBar& pb) {
@@ -380,7 +331,10 @@ public:
         }
     }
     
-    void update() {
+    int DefaultColumns() const { return 64; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawBackground();
@@ -402,47 +356,8 @@ public:
         
         updateParticles();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 64;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    ProgressBarScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(ProgressBarScene)
@@ -0,0 +1,89 @@
+// Seedable random numbers for the scenes
+//
+// rand() goes through libc for every number, shares one sequence between
+// everything in the process, and srand(time(NULL)) made every run
+// different. SceneRandom is xoshiro128**: four words of state and a few
+// shifts and rotates per number, all 32-bit, so it stays cheap on the Pi.
+// Each generator is seeded from the scene's Seed() plus a stream name,
+// giving two scenes on the same seed (a scene_host transition) independent
+// sequences:
+//
+//   SceneRandom rng;
+//   rng.seed(Seed(), "coralreef");           // In Init()
+//   int x = rng.below(width);
+//   float speed = 0.2f + rng.uniform() * 0.3f;
+//   rng.fill(noise, width);                  // A whole row in hot loops
+//
+// The hosts hand every scene the --seed=<n> flag (or a fresh seed per run),
+// so a run can be repeated exactly.
+//
+// Header only, so plugins can use it without linking librgbscene.
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+class SceneRandom {
+private:
+    uint32_t s[4];
+
+    static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+    // splitmix64, to spread a seed over the whole state
+    static uint64_t mix(uint64_t *x) {
+        uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    SceneRandom() { seed(0); }
+    SceneRandom(uint32_t value, const char *stream = "") { seed(value, stream); }
+
+    void seed(uint32_t value, const char *stream = "") {
+        // FNV-1a of the stream name selects the sequence
+        uint64_t x = 14695981039346656037ULL;
+        for (const char *c = stream; *c; c++) {
+            x = (x ^ (uint8_t)*c) * 1099511628211ULL;
+        }
+        x ^= value;
+        const uint64_t a = mix(&x), b = mix(&x);
+        s[0] = (uint32_t)a;
+        s[1] = (uint32_t)(a >> 32);
+        s[2] = (uint32_t)b;
+        s[3] = (uint32_t)(b >> 32);
+    }
+
+    uint32_t next() {
+        const uint32_t result = rotl(s[1] * 5, 7) * 9;
+        const uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+
+    // 0..n-1 for n > 0, by multiply and shift rather than a division
+    int below(int n) { return (int)(((uint64_t)next() * (uint32_t)n) >> 32); }
+
+    // lo..hi-1
+    int range(int lo, int hi) { return lo + below(hi - lo); }
+
+    // 0 <= x < 1
+    float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+    // True with probability p
+    bool chance(float p) { return uniform() < p; }
+
+    // `count` raw numbers at once
+    void fill(uint32_t *out, int count) {
+        for (int i = 0; i < count; i++) out[i] = next();
+    }
+};
+
+#endif // RANDOM_H
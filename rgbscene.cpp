@@ -0,0 +1,470 @@
+// Scene runtime - matrix bootstrap and frame loop shared by all scene binaries
+// Compilation: g++ -c -o rgbscene.o rgbscene.cpp -std=c++11 && ar rcs librgbscene.a rgbscene.o
+
+#include "rgbscene.h"
+#include "framefile.h"
+#include <errno.h>
+#include <grp.h>
+#include <pwd.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace rgb_matrix;
+
+static volatile sig_atomic_t interrupt_received = 0;
+static void InterruptHandler(int signo) {
+    interrupt_received = 1;
+}
+
+static int64_t ClockNanos(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static int64_t MonotonicNanos() {
+    return ClockNanos(CLOCK_MONOTONIC);
+}
+
+// Removes "--name=value" or "--name value" from argv, keeping it
+// NULL-terminated. Returns false if the flag is absent.
+static bool TakeFlag(int *argc, char ***argv, const char *name, const char **value) {
+    char **args = *argv;
+    const size_t len = strlen(name);
+    for (int i = 1; i < *argc; i++) {
+        if (strncmp(args[i], name, len) != 0) continue;
+        int used;
+        if (args[i][len] == '=') {
+            *value = args[i] + len + 1;
+            used = 1;
+        } else if (args[i][len] == '\0' && i + 1 < *argc) {
+            *value = args[i + 1];
+            used = 2;
+        } else {
+            continue;
+        }
+        for (int j = i; j + used <= *argc; j++) {
+            args[j] = args[j + used];
+        }
+        *argc -= used;
+        return true;
+    }
+    return false;
+}
+
+void FrameHistogram::reset() {
+    memset(buckets, 0, sizeof(buckets));
+    samples = 0;
+    max_ns = 0;
+}
+
+void FrameHistogram::add(int64_t ns) {
+    if (ns < 0) ns = 0;
+    int64_t bucket = ns / bucket_ns;
+    if (bucket > num_buckets) bucket = num_buckets;
+    buckets[bucket]++;
+    samples++;
+    if (ns > max_ns) max_ns = ns;
+}
+
+int64_t FrameHistogram::percentile(int pct) const {
+    if (samples == 0) return 0;
+    const uint64_t rank = ((uint64_t)samples * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (int i = 0; i < num_buckets; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            const int64_t upper = (i + 1) * bucket_ns;
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+// TakeFlag() for a non-negative number. Returns false, after printing why,
+// if the flag is present but not a valid value; `value` is left alone if
+// the flag is absent.
+static bool TakeFloatFlag(int *argc, char ***argv, const char *name, float *value) {
+    const char *text;
+    if (!TakeFlag(argc, argv, name, &text)) return true;
+    char *end;
+    const float parsed = strtof(text, &end);
+    if (*end != '\0' || end == text || parsed < 0) {
+        fprintf(stderr, "Invalid %s value '%s'\n", name, text);
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+// Takes --seed=<n> into `seed`, or picks a fresh seed from the clock and
+// process id if the flag is absent. Returns false, after printing why, if
+// the value is not a number.
+static bool TakeSeedFlag(int *argc, char ***argv, uint32_t *seed) {
+    const char *text;
+    if (!TakeFlag(argc, argv, "--seed", &text)) {
+        *seed = (uint32_t)(MonotonicNanos() ^ time(NULL) ^ ((int64_t)getpid() << 16));
+        return true;
+    }
+    char *end;
+    const unsigned long parsed = strtoul(text, &end, 0);
+    if (*end != '\0' || end == text) {
+        fprintf(stderr, "Invalid --seed value '%s'\n", text);
+        return false;
+    }
+    *seed = (uint32_t)parsed;
+    return true;
+}
+
+// Hash of a frame's contents, to spot repeats. Serialize() exposes the
+// canvas' internal buffer without copying it; it is hashed a word at a time.
+static uint64_t FrameHash(const FrameCanvas *canvas) {
+    const char *data;
+    size_t len;
+    canvas->Serialize(&data, &len);
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < len; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Creates the default stats directory. The matrix library drops root for
+// the daemon user (or --led-drop-priv-user) once the matrix is up, so while
+// still root the directory is handed to that user, or the stats could
+// never be written.
+static void PrepareStatsDirectory(const char *dir, const RuntimeOptions &runtime_opt) {
+    mkdir(dir, 0755);
+    if (geteuid() != 0 || runtime_opt.drop_privileges < 0) return;
+    const struct passwd *user = getpwnam(runtime_opt.drop_priv_user ? runtime_opt.drop_priv_user
+                                                                    : "daemon");
+    const struct group *group = getgrnam(runtime_opt.drop_priv_group ? runtime_opt.drop_priv_group
+                                                                     : "daemon");
+    if (!user || !group) return;
+    if (chown(dir, user->pw_uid, group->gr_gid) != 0) {
+        fprintf(stderr, "Cannot hand %s to %s: %s\n", dir, user->pw_name, strerror(errno));
+    }
+}
+
+SceneRuntime::SceneRuntime()
+    : led_matrix(NULL), frame_ns(0), next_deadline(0), wall_clock_aligned(false),
+      frames_shown(0), frames_dropped(0),
+      frames_deduplicated(0), dedup(true), idle_frame_ns(0), have_shown(false), shown_hash(0),
+      last_present(0), frame_delta(0), random_seed(0), stats_interval_ns(0), stats_start(0),
+      stats_frames(0), stats_dropped_before(0), stats_deduplicated_before(0),
+      stats_write_failed(false) {}
+
+SceneRuntime::~SceneRuntime() {
+    if (led_matrix) {
+        led_matrix->Clear();
+        delete led_matrix;
+    }
+    if (frames_dropped > 0) {
+        fprintf(stderr, "%llu frames shown, %llu deadlines missed\n",
+                (unsigned long long)frames_shown, (unsigned long long)frames_dropped);
+    }
+}
+
+bool SceneRuntime::Start(int *argc, char ***argv, int cols, float fps) {
+    RGBMatrix::Options matrix_options;
+    rgb_matrix::RuntimeOptions runtime_opt;
+
+    matrix_options.rows = 32;
+    matrix_options.cols = cols;
+    matrix_options.chain_length = 1;
+    matrix_options.parallel = 1;
+    matrix_options.hardware_mapping = "adafruit-hat";
+    runtime_opt.gpio_slowdown = 2;
+
+    if (!ParseOptionsFromFlags(argc, argv, &matrix_options, &runtime_opt)) {
+        return false;
+    }
+
+    float stats_seconds = 10.0f;
+    float dedup_flag = 1.0f;
+    float idle_fps = 0.0f;
+    if (!TakeFloatFlag(argc, argv, "--fps", &fps) ||
+        !TakeFloatFlag(argc, argv, "--stats-interval", &stats_seconds) ||
+        !TakeFloatFlag(argc, argv, "--dedup", &dedup_flag) ||
+        !TakeFloatFlag(argc, argv, "--idle-fps", &idle_fps) ||
+        !TakeSeedFlag(argc, argv, &random_seed)) {
+        return false;
+    }
+    stats_interval_ns = (int64_t)(stats_seconds * 1e9);
+    dedup = dedup_flag != 0.0f;
+
+    const char *stats_flag;
+
+    const char *program = strrchr((*argv)[0], '/');
+    program = program ? program + 1 : (*argv)[0];
+    stats_label = program;
+    if (TakeFlag(argc, argv, "--stats-file", &stats_flag)) {
+        stats_path = stats_flag;
+    } else {
+        PrepareStatsDirectory("/run/rgbscene", runtime_opt);
+        stats_path = std::string("/run/rgbscene/") + program + ".stats";
+    }
+
+    led_matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
+    if (led_matrix == NULL) {
+        return false;
+    }
+
+    frame_ns = (fps > 0) ? (int64_t)(1e9 / fps) : 0;
+    // Only slows a paced loop down, never speeds it up
+    idle_frame_ns = (idle_fps > 0 && frame_ns > 0) ? (int64_t)(1e9 / idle_fps) : 0;
+    if (idle_frame_ns < frame_ns) idle_frame_ns = 0;
+
+    signal(SIGTERM, InterruptHandler);
+    signal(SIGINT, InterruptHandler);
+    return true;
+}
+
+bool SceneRuntime::running() const {
+    return !interrupt_received;
+}
+
+FrameCanvas *SceneRuntime::Present(FrameCanvas *canvas) {
+    const int64_t rendered = MonotonicNanos();
+    bool repeated = false;
+    if (dedup) {
+        const uint64_t hash = FrameHash(canvas);
+        repeated = have_shown && hash == shown_hash;
+        have_shown = true;
+        shown_hash = hash;
+    }
+    if (repeated) {
+        frames_deduplicated++;
+    } else {
+        canvas = led_matrix->SwapOnVSync(canvas);
+    }
+    frames_shown++;
+    const int64_t swapped = MonotonicNanos();
+    const int64_t period_ns = (repeated && idle_frame_ns > 0) ? idle_frame_ns : frame_ns;
+    if (period_ns > 0) {
+        waitForDeadline(period_ns);
+    }
+
+    const int64_t now = (period_ns > 0) ? MonotonicNanos() : swapped;
+    if (last_present != 0) {
+        frame_delta = (now - last_present) / 1e9f;
+        if (frame_delta > 0.25f) frame_delta = 0.25f;
+    }
+
+    if (stats_interval_ns > 0) {
+        // The first frame has no previous Present() to measure render
+        // time from; it only opens the interval.
+        if (last_present != 0) {
+            render_times.add(rendered - last_present);
+            swap_times.add(swapped - rendered);
+            sleep_times.add(now - swapped);
+            stats_frames++;
+        } else {
+            stats_start = now;
+        }
+        if (now - stats_start >= stats_interval_ns) {
+            publishStats(now);
+        }
+    }
+    last_present = now;
+    return canvas;
+}
+
+// Logs one line for the interval that just ended and rewrites the stats
+// file, then starts a new interval.
+void SceneRuntime::publishStats(int64_t now) {
+    const double seconds = (now - stats_start) / 1e9;
+    const double fps = stats_frames / seconds;
+    const uint64_t dropped = frames_dropped - stats_dropped_before;
+    const uint64_t deduplicated = frames_deduplicated - stats_deduplicated_before;
+
+    fprintf(stderr, "%s: %.1f fps, render p50 %.2f p99 %.2f max %.2f ms, "
+            "swap p50 %.2f p99 %.2f ms, idle p50 %.2f ms, %llu missed, %llu unchanged\n",
+            stats_label.c_str(), fps,
+            render_times.percentile(50) / 1e6, render_times.percentile(99) / 1e6,
+            render_times.max() / 1e6,
+            swap_times.percentile(50) / 1e6, swap_times.percentile(99) / 1e6,
+            sleep_times.percentile(50) / 1e6, (unsigned long long)dropped,
+            (unsigned long long)deduplicated);
+
+    // Written beside the target and renamed over it, so readers never see
+    // a half-written file.
+    const std::string tmp_path = stats_path + ".tmp";
+    FILE *f = fopen(tmp_path.c_str(), "w");
+    if (f) {
+        fprintf(f, "scene=%s\n", stats_label.c_str());
+        fprintf(f, "interval_s=%.3f\n", seconds);
+        fprintf(f, "frames=%llu\n", (unsigned long long)stats_frames);
+        fprintf(f, "fps=%.2f\n", fps);
+        fprintf(f, "missed=%llu\n", (unsigned long long)dropped);
+        fprintf(f, "deduplicated=%llu\n", (unsigned long long)deduplicated);
+        fprintf(f, "seed=%u\n", random_seed);
+        const FrameHistogram *histograms[] = { &render_times, &swap_times, &sleep_times };
+        const char *names[] = { "render", "swap", "idle" };
+        for (int i = 0; i < 3; i++) {
+            fprintf(f, "%s_p50_us=%lld\n", names[i], (long long)(histograms[i]->percentile(50) / 1000));
+            fprintf(f, "%s_p99_us=%lld\n", names[i], (long long)(histograms[i]->percentile(99) / 1000));
+            fprintf(f, "%s_max_us=%lld\n", names[i], (long long)(histograms[i]->max() / 1000));
+        }
+        fclose(f);
+        rename(tmp_path.c_str(), stats_path.c_str());
+    } else if (!stats_write_failed) {
+        fprintf(stderr, "Cannot write stats to %s: %s\n", tmp_path.c_str(), strerror(errno));
+        stats_write_failed = true;
+    }
+
+    render_times.reset();
+    swap_times.reset();
+    sleep_times.reset();
+    stats_frames = 0;
+    stats_dropped_before = frames_dropped;
+    stats_deduplicated_before = frames_deduplicated;
+    stats_start = now;
+}
+
+clockid_t SceneRuntime::deadlineClock() const {
+    return wall_clock_aligned ? CLOCK_REALTIME : CLOCK_MONOTONIC;
+}
+
+void SceneRuntime::waitForDeadline(int64_t period_ns) {
+    const int64_t now = ClockNanos(deadlineClock());
+    if (wall_clock_aligned && (next_deadline == 0 || next_deadline - now > period_ns)) {
+        // Start on the grid, and go back onto it if the clock was set back.
+        next_deadline = now - now % period_ns;
+    }
+    if (next_deadline == 0) next_deadline = now;
+    next_deadline += period_ns;
+    if (now > next_deadline) {
+        // Overran: drop the deadlines already passed instead of rushing
+        // through catch-up frames.
+        const int64_t missed = (now - next_deadline) / period_ns + 1;
+        frames_dropped += missed;
+        next_deadline += missed * period_ns;
+    }
+
+    struct timespec deadline;
+    deadline.tv_sec = next_deadline / 1000000000LL;
+    deadline.tv_nsec = next_deadline % 1000000000LL;
+    while (clock_nanosleep(deadlineClock(), TIMER_ABSTIME, &deadline, NULL) == EINTR
+           && !interrupt_received) {
+    }
+}
+
+// A baked loop always spans at least this long: the animation must have
+// repeated from frame 0 for that long before baking stops early, and the
+// file keeps that many frames of it.
+static const float kMinBakeLoopSeconds = 2.0f;
+
+// FNV-1a over one frame's pixels
+static uint64_t FrameHash(const uint8_t *rgb, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ rgb[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Renders the scene offline, without touching the matrix, into a frame
+// file for frameplayer. Stops early once the animation loops: frames p, p+1,
+// ... have repeated frames 0, 1, ... (compared by hash) for a whole period p
+// and for at least kMinBakeLoopSeconds. A scene that starts on a black or
+// still frame therefore is not cut off after its first frame, and a short
+// period is written as several whole periods.
+static int BakeScene(Scene *scene, const char *path, int frames, float fps) {
+    const int width = scene->DefaultColumns();
+    const int height = 32;
+    const size_t size = width * height * 3;
+    const int min_frames = std::max(1, (int)(kMinBakeLoopSeconds * fps + 0.5f));
+    OffscreenCanvas canvas(width, height);
+    scene->Init(width, height);
+
+    FrameFileWriter writer;
+    if (!writer.open(path, width, height, fps)) {
+        fprintf(stderr, "Cannot write %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    std::vector<uint64_t> hashes;
+    std::vector<int> periods;   // Loop lengths every frame so far agrees with
+    for (int i = 0; i < frames; i++) {
+        scene->Update(i == 0 ? 0.0f : 1.0f / fps);
+        scene->Render(&canvas);
+        const uint8_t *rgb = canvas.row(0);
+        if (!writer.addFrame(rgb)) break;
+
+        const uint64_t hash = FrameHash(rgb, size);
+        hashes.push_back(hash);
+        size_t kept = 0;
+        for (size_t j = 0; j < periods.size(); j++) {
+            if (hash == hashes[i - periods[j]]) periods[kept++] = periods[j];
+        }
+        periods.resize(kept);
+        if (i > 0 && hash == hashes[0]) periods.push_back(i);
+
+        // The shortest candidate is always the first to have repeated long
+        // enough
+        if (!periods.empty() && i + 1 - periods[0] >= std::max(periods[0], min_frames)) {
+            const int period = periods[0];
+            fprintf(stderr, "Animation repeats every %d frames\n", period);
+            if (!writer.truncate((min_frames + period - 1) / period * period)) {
+                fprintf(stderr, "Cannot write %s: %s\n", path, strerror(errno));
+                return 1;
+            }
+            break;
+        }
+    }
+    const uint32_t written = writer.frameCount();
+    if (!writer.close()) {
+        fprintf(stderr, "Cannot write %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "Baked %u frames at %.1f fps into %s\n", written, fps, path);
+    return 0;
+}
+
+int RunScene(Scene *scene, int argc, char *argv[]) {
+    const char *bake_path;
+    if (TakeFlag(&argc, &argv, "--bake", &bake_path)) {
+        float fps = scene->DefaultFps();
+        float seconds = 60.0f;
+        uint32_t seed;
+        if (!TakeFloatFlag(&argc, &argv, "--fps", &fps) ||
+            !TakeFloatFlag(&argc, &argv, "--bake-seconds", &seconds) ||
+            !TakeSeedFlag(&argc, &argv, &seed)) {
+            return 1;
+        }
+        scene->SetSeed(seed);
+        if (fps <= 0) {
+            fprintf(stderr, "Baking needs a frame rate above 0\n");
+            return 1;
+        }
+        return BakeScene(scene, bake_path, (int)(seconds * fps + 0.5f), fps);
+    }
+
+    SceneRuntime runtime;
+    if (!runtime.Start(&argc, &argv, scene->DefaultColumns(), scene->DefaultFps())) {
+        return 1;
+    }
+
+    FrameCanvas *canvas = runtime.matrix()->CreateFrameCanvas();
+    scene->SetSeed(runtime.seed());
+    scene->Init(canvas->width(), canvas->height());
+
+    while (runtime.running()) {
+        scene->Update(runtime.frameDelta());
+        scene->Render(canvas);
+        canvas = runtime.Present(canvas);
+    }
+    return 0;
+}
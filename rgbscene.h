@@ -0,0 +1,443 @@
+// Scene interface and runtime shared by standalone scene binaries and
+// scene_host plugins
+//
+// A scene only draws into the canvas it is handed; it never owns the
+// RGBMatrix. That lets the same code run as its own binary or be loaded by
+// scene_host, which keeps one matrix alive and switches scenes in-process.
+//
+// Standalone binaries get matrix setup, signal handling and the frame loop
+// from the runtime in rgbscene.cpp, built once into librgbscene.a:
+//   g++ -c -o rgbscene.o rgbscene.cpp -std=c++11 && ar rcs librgbscene.a rgbscene.o
+//   g++ -o coralreef coralreef.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+//
+// Plugin build:
+//   g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/coralreef.so coralreef.cpp -lrgbmatrix -std=c++11
+
+#ifndef RGBSCENE_H
+#define RGBSCENE_H
+
+#include "led-matrix.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class Scene {
+private:
+    uint32_t seed_value;
+
+public:
+    Scene() : seed_value(0) {}
+    virtual ~Scene() {}
+
+    // Seed for the scene's random numbers (see random.h), set by the host
+    // before Init(): the --seed flag, or a fresh one every run.
+    void SetSeed(uint32_t seed) { seed_value = seed; }
+    uint32_t Seed() const { return seed_value; }
+
+    // Called once with the canvas size before the first Render().
+    virtual void Init(int width, int height) {}
+
+    // Advance animation state by dt seconds of wall-clock time. Called
+    // before every Render(); dt is 0 for the first frame.
+    virtual void Update(float dt) {}
+
+    // Draw one frame. The canvas is not cleared beforehand.
+    virtual void Render(rgb_matrix::Canvas *canvas) = 0;
+
+    // Panel width and frame rate the standalone runner uses unless the
+    // command line says otherwise.
+    virtual int DefaultColumns() const { return 32; }
+    virtual float DefaultFps() const { return 20.0f; }
+};
+
+// Plain RGB buffer usable wherever a scene expects a canvas. scene_host
+// renders the outgoing and incoming scene into two of these during a
+// transition and mixes them onto the real FrameCanvas.
+class OffscreenCanvas : public rgb_matrix::Canvas {
+private:
+    int w;
+    int h;
+    std::vector<uint8_t> pixels; // Packed RGB, row-major
+
+public:
+    OffscreenCanvas(int width, int height)
+        : w(width), h(height), pixels(width * height * 3, 0) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    void SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue) {
+        if (x < 0 || x >= w || y < 0 || y >= h) return;
+        uint8_t *p = &pixels[(y * w + x) * 3];
+        p[0] = red;
+        p[1] = green;
+        p[2] = blue;
+    }
+
+    void Clear() {
+        memset(&pixels[0], 0, pixels.size());
+    }
+
+    void Fill(uint8_t red, uint8_t green, uint8_t blue) {
+        for (size_t i = 0; i < pixels.size(); i += 3) {
+            pixels[i] = red;
+            pixels[i + 1] = green;
+            pixels[i + 2] = blue;
+        }
+    }
+
+    // Pointer to the RGB triple at (x, y); no bounds check
+    const uint8_t *pixel(int x, int y) const { return &pixels[(y * w + x) * 3]; }
+
+    // Packed RGB of row y, for copying whole rows in
+    uint8_t *row(int y) { return &pixels[y * w * 3]; }
+};
+
+// Background content that changes rarely, drawn once into its own buffer
+// and copied onto every frame until invalidated:
+//
+//   if (sky.needsRedraw(width, height)) drawSky(&sky);
+//   sky.blit(canvas);
+//
+// Pixels the draw code never touched stay transparent, so a layer can sit
+// on top of others. Rows that are fully drawn are copied with memcpy when
+// the target is an OffscreenCanvas (scene_host during transitions); other
+// canvases only have SetPixel(), so the win there is skipping the drawing
+// code, not the pixel writes.
+class CachedLayer : public rgb_matrix::Canvas {
+private:
+    int w;
+    int h;
+    bool valid;
+    std::vector<uint8_t> pixels;      // Packed RGB, row-major
+    std::vector<uint8_t> covered;     // 1 where something was drawn
+    std::vector<int> covered_in_row;
+
+public:
+    CachedLayer() : w(0), h(0), valid(false) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+
+    // Forces a redraw on the next needsRedraw().
+    void invalidate() { valid = false; }
+
+    // True when the layer has to be drawn again (first use, size change or
+    // invalidate()); it is then cleared to transparent and counts as valid
+    // from here on.
+    bool needsRedraw(int width, int height) {
+        if (valid && width == w && height == h) return false;
+        w = width;
+        h = height;
+        pixels.assign(w * h * 3, 0);
+        covered.assign(w * h, 0);
+        covered_in_row.assign(h, 0);
+        valid = true;
+        return true;
+    }
+
+    void SetPixel(int x, int y, uint8_t red, uint8_t green, uint8_t blue) {
+        if (x < 0 || x >= w || y < 0 || y >= h) return;
+        const int i = y * w + x;
+        uint8_t *p = &pixels[i * 3];
+        p[0] = red;
+        p[1] = green;
+        p[2] = blue;
+        if (!covered[i]) {
+            covered[i] = 1;
+            covered_in_row[y]++;
+        }
+    }
+
+    // Back to fully transparent
+    void Clear() {
+        memset(&pixels[0], 0, pixels.size());
+        memset(&covered[0], 0, covered.size());
+        for (int y = 0; y < h; y++) covered_in_row[y] = 0;
+    }
+
+    void Fill(uint8_t red, uint8_t green, uint8_t blue) {
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) SetPixel(x, y, red, green, blue);
+        }
+    }
+
+    // Draws the layer's pixels onto `target` at the same coordinates.
+    void blit(rgb_matrix::Canvas *target) const { blit(target, 0, 0, w, h); }
+
+    // Same, limited to the rectangle at (x0, y0) of rect_w x rect_h pixels.
+    void blit(rgb_matrix::Canvas *target, int x0, int y0, int rect_w, int rect_h) const {
+        int x1 = x0 + rect_w, y1 = y0 + rect_h;
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > w) x1 = w;
+        if (y1 > h) y1 = h;
+        OffscreenCanvas *offscreen = dynamic_cast<OffscreenCanvas *>(target);
+        if (offscreen && (offscreen->width() != w || offscreen->height() != h)) {
+            offscreen = NULL;
+        }
+        for (int y = y0; y < y1; y++) {
+            const uint8_t *src = &pixels[y * w * 3];
+            if (covered_in_row[y] == 0) continue;
+            if (offscreen && covered_in_row[y] == w && x0 == 0 && x1 == w) {
+                memcpy(offscreen->row(y), src, w * 3);
+                continue;
+            }
+            const uint8_t *mask = &covered[y * w];
+            for (int x = x0; x < x1; x++) {
+                if (mask[x]) target->SetPixel(x, y, src[x * 3], src[x * 3 + 1], src[x * 3 + 2]);
+            }
+        }
+    }
+};
+
+// Dirty-rectangle tracking for scenes that mostly show the same picture:
+// the scene marks what changed and repaints only that, instead of the whole
+// frame.
+//
+//   if (time_text_changed) damage.mark(0, time_y, width, line_height);
+//   std::vector<DamageTracker::Rect> dirty;
+//   damage.take(canvas, &dirty);
+//   for (size_t i = 0; i < dirty.size(); i++) {
+//       background.blit(canvas, dirty[i].x, dirty[i].y, dirty[i].w, dirty[i].h);
+//       text.blit(canvas, dirty[i].x, dirty[i].y, dirty[i].w, dirty[i].h);
+//   }
+//   canvas = runtime.Present(canvas);
+//
+// FrameCanvases are double-buffered: the buffer Present() hands back still
+// holds the frame from two swaps ago. Damage is therefore kept per buffer
+// until that buffer is drawn into again, and a buffer the tracker has not
+// seen before (or any buffer after a size change) is repainted in full.
+class DamageTracker {
+public:
+    struct Rect {
+        int x;
+        int y;
+        int w;
+        int h;
+    };
+
+private:
+    // Beyond this many rectangles a buffer's damage collapses to their
+    // bounding box
+    static const size_t max_rects = 16;
+
+    struct Buffer {
+        const void *id;
+        std::vector<Rect> pending;
+    };
+
+    int w;
+    int h;
+    std::vector<Buffer> buffers;
+
+    static void add(std::vector<Rect> *rects, const Rect &r) {
+        for (size_t i = 0; i < rects->size(); i++) {
+            const Rect &o = (*rects)[i];
+            if (r.x >= o.x && r.y >= o.y && r.x + r.w <= o.x + o.w && r.y + r.h <= o.y + o.h) {
+                return;     // Already covered
+            }
+        }
+        if (rects->size() < max_rects) {
+            rects->push_back(r);
+            return;
+        }
+        Rect box = r;
+        for (size_t i = 0; i < rects->size(); i++) {
+            const Rect &o = (*rects)[i];
+            const int x1 = std::max(box.x + box.w, o.x + o.w);
+            const int y1 = std::max(box.y + box.h, o.y + o.h);
+            box.x = std::min(box.x, o.x);
+            box.y = std::min(box.y, o.y);
+            box.w = x1 - box.x;
+            box.h = y1 - box.y;
+        }
+        rects->assign(1, box);
+    }
+
+public:
+    DamageTracker() : w(0), h(0) {}
+
+    // Marks a region as changed in every buffer, clipped to the canvas.
+    void mark(int x, int y, int rect_w, int rect_h) {
+        int x1 = x + rect_w, y1 = y + rect_h;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+        if (x1 > w) x1 = w;
+        if (y1 > h) y1 = h;
+        if (x >= x1 || y >= y1) return;
+        const Rect r = { x, y, x1 - x, y1 - y };
+        for (size_t i = 0; i < buffers.size(); i++) add(&buffers[i].pending, r);
+    }
+
+    void markAll() { mark(0, 0, w, h); }
+
+    // Moves the regions `canvas` has to repaint into `dirty` (empty when it
+    // is up to date) and counts the canvas as repainted.
+    void take(const rgb_matrix::Canvas *canvas, std::vector<Rect> *dirty) {
+        if (canvas->width() != w || canvas->height() != h) {
+            w = canvas->width();
+            h = canvas->height();
+            buffers.clear();
+        }
+        for (size_t i = 0; i < buffers.size(); i++) {
+            if (buffers[i].id == canvas) {
+                dirty->swap(buffers[i].pending);
+                buffers[i].pending.clear();
+                return;
+            }
+        }
+        Buffer buffer;
+        buffer.id = canvas;
+        buffers.push_back(buffer);
+        const Rect all = { 0, 0, w, h };
+        dirty->assign(1, all);
+    }
+};
+
+// Entry point every plugin exports; returns a new scene owned by the caller.
+typedef Scene *(*CreateSceneFunc)();
+#define RGB_SCENE_ENTRY_POINT "CreateScene"
+
+#ifdef RGB_SCENE_PLUGIN
+// Plugins only export the factory; scene_host provides the rest.
+#define RGB_SCENE_MAIN(SceneClass) \
+    extern "C" Scene *CreateScene() { return new SceneClass(); }
+#else
+// Frame-time histogram for one stats interval: 50 us buckets up to 100 ms,
+// anything slower lands in the last bucket.
+class FrameHistogram {
+private:
+    static const int64_t bucket_ns = 50000;
+    static const int num_buckets = 2000;
+    uint32_t buckets[num_buckets + 1];
+    uint32_t samples;
+    int64_t max_ns;
+
+public:
+    FrameHistogram() { reset(); }
+
+    void reset();
+    void add(int64_t ns);
+
+    // Upper edge of the bucket holding the pct-th percentile, in ns; never
+    // more than the largest sample.
+    int64_t percentile(int pct) const;
+    int64_t max() const { return max_ns; }
+    uint32_t count() const { return samples; }
+};
+
+// Owns the matrix of a standalone binary: the shared panel defaults,
+// SIGINT/SIGTERM handling and frame pacing. Implemented in rgbscene.cpp.
+class SceneRuntime {
+private:
+    rgb_matrix::RGBMatrix *led_matrix;
+    int64_t frame_ns;       // Target frame period, 0 = unpaced
+    int64_t next_deadline;  // Time the current frame ends, on deadlineClock()
+    bool wall_clock_aligned; // Deadlines on CLOCK_REALTIME period boundaries
+    uint64_t frames_shown;
+    uint64_t frames_dropped;
+    uint64_t frames_deduplicated;
+    bool dedup;             // Skip the swap for frames equal to the shown one
+    int64_t idle_frame_ns;  // Frame period while frames repeat, 0 = frame_ns
+    bool have_shown;
+    uint64_t shown_hash;    // FrameHash() of the frame on the panel
+    int64_t last_present;   // When the previous Present() returned
+    float frame_delta;
+    uint32_t random_seed;
+
+    // Per-interval frame timing, published by publishStats()
+    std::string stats_label;
+    std::string stats_path;
+    int64_t stats_interval_ns; // 0 = stats off
+    int64_t stats_start;
+    uint64_t stats_frames;
+    uint64_t stats_dropped_before;
+    uint64_t stats_deduplicated_before;
+    bool stats_write_failed;       // Logged once, not every interval
+    FrameHistogram render_times;   // Previous Present() returning to this one
+    FrameHistogram swap_times;     // SwapOnVSync()
+    FrameHistogram sleep_times;    // Waiting for the frame deadline
+
+    clockid_t deadlineClock() const;
+    void waitForDeadline(int64_t period_ns);
+    void publishStats(int64_t now);
+
+public:
+    SceneRuntime();
+    ~SceneRuntime();
+
+    // Applies the shared defaults (32 rows, `cols` columns, adafruit-hat
+    // mapping, GPIO slowdown 2, `fps` frames per second), parses the --led-*
+    // flags and --fps=<n> on top of them and creates the matrix. Consumed
+    // flags are removed from argc/argv. --fps=0 runs unpaced.
+    //
+    // Frame timing stats are logged to stderr and written to
+    // /run/rgbscene/<program>.stats every --stats-interval=<seconds>
+    // (default 10, 0 turns them off); --stats-file=<path> moves the file.
+    //
+    // --seed=<n> fixes seed(), which scenes seed their random numbers from,
+    // so runs repeat exactly; without it every run gets a fresh one.
+    //
+    // A frame identical to the one already on the panel is not swapped in
+    // (--dedup=0 turns this off); --idle-fps=<n> additionally slows the
+    // frame rate to n while frames keep repeating.
+    bool Start(int *argc, char ***argv, int cols = 32, float fps = 20.0f);
+
+    rgb_matrix::RGBMatrix *matrix() const { return led_matrix; }
+
+    // The --seed flag, or the one picked for this run. Also published in
+    // the stats file.
+    uint32_t seed() const { return random_seed; }
+
+    // False once SIGINT or SIGTERM arrived.
+    bool running() const;
+
+    // Shows `canvas` on the next vsync, sleeps until the frame's deadline
+    // and returns the buffer to draw the following frame into. Deadlines sit
+    // on a fixed grid, so render time does not stretch the frame period; a
+    // frame that overruns skips the deadlines it missed and counts them as
+    // dropped. A frame equal to the one on the panel is not swapped; the
+    // same canvas comes back, still holding it.
+    rgb_matrix::FrameCanvas *Present(rgb_matrix::FrameCanvas *canvas);
+
+    // Puts the deadlines on whole multiples of the frame period in wall
+    // clock time instead, so at 1 fps every frame starts right after a
+    // second ticks over. Follows the clock when it is set. Call before the
+    // first Present().
+    void alignToWallClock(bool align) { wall_clock_aligned = align; }
+
+    // Seconds between the last two Present() calls, i.e. how far the next
+    // frame should advance; 0 before the second frame, capped at 0.25 s so a
+    // stall does not teleport everything.
+    float frameDelta() const { return frame_delta; }
+
+    // Name used in the stats log line and file; defaults to the program
+    // name. scene_host sets it to the scene on the panel.
+    void setStatsLabel(const std::string &label) { stats_label = label; }
+
+    uint64_t framesShown() const { return frames_shown; }
+    uint64_t framesDropped() const { return frames_dropped; }
+    uint64_t framesDeduplicated() const { return frames_deduplicated; }
+};
+
+// Standard main loop for a Scene: Init once, then Update/Render/Present
+// until interrupted.
+//
+// With --bake=<file> it instead renders --bake-seconds=<n> (default 60) of
+// the animation at the scene's frame rate (or --fps) into a frame file for
+// frameplayer, without opening the matrix. Both honour --seed=<n>.
+int RunScene(Scene *scene, int argc, char *argv[]);
+
+#define RGB_SCENE_MAIN(SceneClass) \
+    int main(int argc, char *argv[]) { \
+        SceneClass scene; \
+        return RunScene(&scene, argc, argv); \
+    }
+#endif
+
+#endif // RGBSCENE_H
@@ -0,0 +1,381 @@
+// Scene Host - one long-lived RGBMatrix, scenes loaded as in-process plugins
+// Compilation: g++ -rdynamic -o scene_host scene_host.cpp -L. -lrgbscene -lrgbmatrix -ldl -std=c++11
+//
+// The matrix (GPIO setup + refresh thread) is created once. Scenes are
+// shared objects built with -DRGB_SCENE_PLUGIN (see rgbscene.h) and are
+// switched without tearing the panel down.
+//
+// Handoff: while a transition runs, the outgoing and incoming scene each
+// render into their own OffscreenCanvas and the host mixes the two onto the
+// FrameCanvas (crossfade or left-to-right wipe). The old plugin is released
+// only once the transition has finished.
+//
+// Control: write one command per line into the control FIFO.
+//   load <name> [cut|fade|wipe] [frames]   switch to <plugin-dir>/<name>.so
+//   blank [cut|fade|wipe] [frames]         switch to a black panel
+//
+// A scene is only loaded if its DefaultColumns() matches the panel width,
+// so a wide scene never ends up squeezed onto a narrower canvas. --columns
+// prints the width a plugin wants, without opening the matrix, so the
+// caller can start the host with a matching --led-cols.
+//
+// Usage: scene_host [--plugin-dir <dir>] [--control <fifo>] [--scene <name>]
+//                   [--transition cut|fade|wipe] [--transition-frames <n>] [matrix flags]
+//        scene_host [--plugin-dir <dir>] --columns <name>
+
+#include "led-matrix.h"
+#include "rgbscene.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+using namespace rgb_matrix;
+
+// A scene instance together with the plugin library that holds its code.
+struct LoadedScene {
+    std::string name;
+    void *library;
+    Scene *scene;
+
+    LoadedScene() : library(NULL), scene(NULL) {}
+};
+
+enum TransitionMode {
+    TRANSITION_CUT,
+    TRANSITION_FADE,
+    TRANSITION_WIPE
+};
+
+// Opens <dir>/<name>.so and creates its scene; NULL (with the reason on
+// stderr) if that fails. The caller owns both the scene and *library.
+static Scene *createScene(const std::string &dir, const std::string &name, void **library) {
+    std::string path = dir + "/" + name + ".so";
+    *library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!*library) {
+        fprintf(stderr, "scene_host: cannot load %s: %s\n", path.c_str(), dlerror());
+        return NULL;
+    }
+
+    CreateSceneFunc create = (CreateSceneFunc)dlsym(*library, RGB_SCENE_ENTRY_POINT);
+    Scene *scene = create ? create() : NULL;
+    if (!scene) {
+        fprintf(stderr, "scene_host: %s does not export a scene\n", path.c_str());
+        dlclose(*library);
+        *library = NULL;
+    }
+    return scene;
+}
+
+static bool parseTransitionMode(const std::string &text, TransitionMode *mode) {
+    if (text == "cut") *mode = TRANSITION_CUT;
+    else if (text == "fade") *mode = TRANSITION_FADE;
+    else if (text == "wipe") *mode = TRANSITION_WIPE;
+    else return false;
+    return true;
+}
+
+class SceneHost {
+private:
+    SceneRuntime *runtime;
+    FrameCanvas *canvas;
+    std::string plugin_dir;
+    LoadedScene current;
+    LoadedScene outgoing;            // Still rendering until the transition ends
+    OffscreenCanvas *outgoing_buffer;
+    OffscreenCanvas *incoming_buffer;
+    TransitionMode default_mode;
+    int default_frames;
+    TransitionMode transition_mode;
+    int transition_frames;
+    int transition_frame;            // == transition_frames when idle
+    int control_fd;
+    int control_keepalive_fd; // Our own writer, so the FIFO never reports EOF
+    std::string pending_input;
+
+    static void unload(LoadedScene &loaded) {
+        delete loaded.scene;
+        if (loaded.library) dlclose(loaded.library);
+        loaded = LoadedScene();
+    }
+
+    // Makes `next` the current scene. The previous one keeps rendering as
+    // the outgoing side of the transition; a transition still in progress is
+    // cut short and its outgoing scene released right away.
+    void beginTransition(const LoadedScene &next, TransitionMode mode, int frames) {
+        if (mode == TRANSITION_CUT || frames <= 0) {
+            unload(outgoing);
+            unload(current);
+            current = next;
+            transition_frames = transition_frame = 0;
+            return;
+        }
+
+        if (transition_frame < transition_frames) {
+            // The incoming buffer already holds the scene that is now leaving
+            std::swap(outgoing_buffer, incoming_buffer);
+        } else {
+            outgoing_buffer->Clear();
+        }
+        unload(outgoing);
+        outgoing = current;
+        current = next;
+        incoming_buffer->Clear();
+        transition_mode = mode;
+        transition_frames = frames;
+        transition_frame = 0;
+    }
+
+    static void renderInto(LoadedScene &loaded, OffscreenCanvas *buffer, float dt) {
+        if (loaded.scene) {
+            loaded.scene->Update(dt);
+            loaded.scene->Render(buffer);
+        } else {
+            buffer->Clear();
+        }
+    }
+
+    // Mixes the two offscreen buffers onto the FrameCanvas; progress runs
+    // from 0 (all outgoing) to 256 (all incoming).
+    void composite(int progress) {
+        const int width = canvas->width();
+        const int height = canvas->height();
+        const int wipe_column = width * progress / 256;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const uint8_t *a = outgoing_buffer->pixel(x, y);
+                const uint8_t *b = incoming_buffer->pixel(x, y);
+                if (transition_mode == TRANSITION_WIPE) {
+                    const uint8_t *p = (x < wipe_column) ? b : a;
+                    canvas->SetPixel(x, y, p[0], p[1], p[2]);
+                } else {
+                    canvas->SetPixel(x, y,
+                                     (a[0] * (256 - progress) + b[0] * progress) >> 8,
+                                     (a[1] * (256 - progress) + b[1] * progress) >> 8,
+                                     (a[2] * (256 - progress) + b[2] * progress) >> 8);
+                }
+            }
+        }
+    }
+
+    void handleCommand(const std::string &line) {
+        std::istringstream words(line);
+        std::string command, name, mode_text;
+        words >> command;
+        if (command == "load") {
+            words >> name;
+        }
+
+        TransitionMode mode = default_mode;
+        int frames = default_frames;
+        if (words >> mode_text) {
+            if (!parseTransitionMode(mode_text, &mode)) {
+                fprintf(stderr, "scene_host: unknown transition '%s'\n", mode_text.c_str());
+                return;
+            }
+            std::string frames_text;
+            if (words >> frames_text) {
+                char *end;
+                const long parsed = strtol(frames_text.c_str(), &end, 10);
+                if (*end != '\0' || parsed < 0 || parsed > 100000) {
+                    fprintf(stderr, "scene_host: bad frame count '%s' in '%s'\n",
+                            frames_text.c_str(), line.c_str());
+                    return;
+                }
+                frames = parsed;
+            }
+        }
+
+        if (command == "load" && !name.empty()) {
+            loadScene(name, mode, frames);
+        } else if (command == "blank") {
+            fprintf(stderr, "scene_host: blanking panel\n");
+            beginTransition(LoadedScene(), mode, frames);
+            runtime->setStatsLabel("blank");
+        } else if (!line.empty()) {
+            fprintf(stderr, "scene_host: unknown command '%s'\n", line.c_str());
+        }
+    }
+
+public:
+    SceneHost(SceneRuntime *rt, const std::string &dir, TransitionMode mode, int frames)
+        : runtime(rt), plugin_dir(dir), default_mode(mode), default_frames(frames),
+          transition_mode(TRANSITION_CUT), transition_frames(0), transition_frame(0),
+          control_fd(-1), control_keepalive_fd(-1) {
+        canvas = runtime->matrix()->CreateFrameCanvas();
+        outgoing_buffer = new OffscreenCanvas(canvas->width(), canvas->height());
+        incoming_buffer = new OffscreenCanvas(canvas->width(), canvas->height());
+    }
+
+    ~SceneHost() {
+        unload(outgoing);
+        unload(current);
+        delete outgoing_buffer;
+        delete incoming_buffer;
+        if (control_fd >= 0) close(control_fd);
+        if (control_keepalive_fd >= 0) close(control_keepalive_fd);
+    }
+
+    bool openControl(const std::string &path) {
+        if (mkfifo(path.c_str(), 0660) != 0 && errno != EEXIST) {
+            fprintf(stderr, "scene_host: cannot create %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        control_fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+        if (control_fd < 0) {
+            fprintf(stderr, "scene_host: cannot open %s: %s\n", path.c_str(), strerror(errno));
+            return false;
+        }
+        control_keepalive_fd = open(path.c_str(), O_WRONLY | O_NONBLOCK);
+        return true;
+    }
+
+    // Loads the new scene fully before handing over, so a broken plugin
+    // leaves the current scene on the panel.
+    bool loadScene(const std::string &name, TransitionMode mode, int frames) {
+        void *library;
+        Scene *scene = createScene(plugin_dir, name, &library);
+        if (!scene) return false;
+        if (scene->DefaultColumns() != canvas->width()) {
+            fprintf(stderr, "scene_host: refusing %s, it is drawn for %d columns and the "
+                    "panel has %d\n", name.c_str(), scene->DefaultColumns(), canvas->width());
+            delete scene;
+            dlclose(library);
+            return false;
+        }
+        scene->SetSeed(runtime->seed());
+        scene->Init(canvas->width(), canvas->height());
+
+        LoadedScene next;
+        next.name = name;
+        next.library = library;
+        next.scene = scene;
+        beginTransition(next, mode, frames);
+        runtime->setStatsLabel(name);
+        fprintf(stderr, "scene_host: now showing %s\n", name.c_str());
+        return true;
+    }
+
+    // Drains whatever commands arrived since the last frame.
+    void pollControl() {
+        if (control_fd < 0) return;
+        char buffer[256];
+        ssize_t n;
+        while ((n = read(control_fd, buffer, sizeof(buffer))) > 0) {
+            pending_input.append(buffer, n);
+        }
+        size_t newline;
+        while ((newline = pending_input.find('\n')) != std::string::npos) {
+            handleCommand(pending_input.substr(0, newline));
+            pending_input.erase(0, newline + 1);
+        }
+    }
+
+    void renderFrame() {
+        const float dt = runtime->frameDelta();
+        if (transition_frame < transition_frames) {
+            renderInto(outgoing, outgoing_buffer, dt);
+            renderInto(current, incoming_buffer, dt);
+            transition_frame++;
+            composite(transition_frame * 256 / transition_frames);
+            if (transition_frame == transition_frames) {
+                if (outgoing.scene) {
+                    fprintf(stderr, "scene_host: released %s\n", outgoing.name.c_str());
+                }
+                unload(outgoing);
+            }
+        } else if (current.scene) {
+            current.scene->Update(dt);
+            current.scene->Render(canvas);
+        } else {
+            canvas->Clear();
+        }
+        canvas = runtime->Present(canvas);
+    }
+};
+
+// --columns: prints the panel width the plugin's scene is drawn for
+static int printColumns(int argc, char *argv[]) {
+    std::string plugin_dir = "plugins";
+    std::string name;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--plugin-dir" && i + 1 < argc) {
+            plugin_dir = argv[++i];
+        } else if (arg == "--columns" && i + 1 < argc) {
+            name = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--plugin-dir <dir>] --columns <name>\n", argv[0]);
+            return 1;
+        }
+    }
+
+    void *library;
+    Scene *scene = createScene(plugin_dir, name, &library);
+    if (!scene) return 1;
+    printf("%d\n", scene->DefaultColumns());
+    delete scene;
+    dlclose(library);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--columns") == 0) return printColumns(argc, argv);
+    }
+
+    SceneRuntime runtime;
+    if (!runtime.Start(&argc, &argv)) {
+        return 1;
+    }
+
+    std::string plugin_dir = "plugins";
+    std::string control_path = "scene_host.fifo";
+    std::string initial_scene;
+    TransitionMode transition_mode = TRANSITION_FADE;
+    int transition_frames = 20; // 1 second at ~20 FPS
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--plugin-dir" && i + 1 < argc) {
+            plugin_dir = argv[++i];
+        } else if (arg == "--control" && i + 1 < argc) {
+            control_path = argv[++i];
+        } else if (arg == "--scene" && i + 1 < argc) {
+            initial_scene = argv[++i];
+        } else if (arg == "--transition" && i + 1 < argc &&
+                   parseTransitionMode(argv[i + 1], &transition_mode)) {
+            ++i;
+        } else if (arg == "--transition-frames" && i + 1 < argc) {
+            transition_frames = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--plugin-dir <dir>] [--control <fifo>] [--scene <name>] "
+                    "[--transition cut|fade|wipe] [--transition-frames <n>] [matrix flags]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SceneHost *host = new SceneHost(&runtime, plugin_dir, transition_mode, transition_frames);
+    if (!host->openControl(control_path)) {
+        delete host;
+        return 1;
+    }
+    if (!initial_scene.empty()) {
+        host->loadScene(initial_scene, TRANSITION_CUT, 0);
+    }
+
+    while (runtime.running()) {
+        host->pollControl();
+        host->renderFrame();
+    }
+
+    delete host;
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+// Scene Bench - renders scene plugins offscreen and reports their cost
+// Compilation: g++ -O2 -rdynamic -o scenebench scenebench.cpp -ldl -std=c++11
+//
+// Every scene is loaded from <plugin-dir>/<name>.so (built as for
+// scene_host, see rgbscene.h), seeded with --seed, initialised at its
+// default size and then updated and rendered --frames times into an
+// OffscreenCanvas with a fixed step of 1 / --fps seconds. No matrix is
+// opened, so it runs anywhere the plugins build, including the headless
+// backend (link headless_matrix.o in, it provides the drawing functions).
+//
+// One line per scene goes to stdout, key=value like the runtime's stats
+// file:
+//   scene=coralreef width=32 frames=1000 mean_us=4.1 p50_us=3.9 p99_us=7.8
+//   max_us=31.0 allocs_per_frame=0.00 hash=5c1f0a4d2e6b9a13
+// Times cover Update() + Render(). Allocations count operator new calls
+// during the frame loop (Init() is excluded); plugins pick up the counting
+// operator new below because the bench is linked with -rdynamic. The hash
+// is FNV-1a over every rendered frame, so two runs with the same seed and
+// frame count match unless the output changed.
+//
+// Golden frames: with --golden <dir> the frames listed in --golden-frames
+// (increasing, without repeats; default 0,100,1000; rendering runs at least
+// that far) are compared with reference images <dir>/<scene>-<frame>.ppm.
+// A frame passes if no channel of any pixel differs by more than
+// --tolerance (default 0). A failing frame leaves <scene>-<frame>.actual.ppm
+// and <scene>-<frame>.diff.ppm beside the reference; the diff shows
+// offending pixels in red over a dimmed copy of the frame. --update-golden
+// writes the references instead of comparing.
+// The result line gains golden=pass|fail|updated and golden_max_diff=<n>,
+// and the exit status is 1 if any scene failed.
+//
+// Usage: scenebench [--plugin-dir <dir>] [--frames <n>] [--seed <n>] [--fps <n>]
+//                   [--golden <dir> [--golden-frames <n,n,...>] [--tolerance <n>]
+//                   [--update-golden]]
+//                   [scene ...]   (default: every plugin in the directory)
+
+#include "led-matrix.h"
+#include "rgbscene.h"
+#include <dirent.h>
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static uint64_t allocations = 0;
+
+void *operator new(size_t size) {
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+static int64_t MonotonicNanos() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Reference image handling for --golden
+struct GoldenCheck {
+    std::string dir;            // Empty = no golden check
+    std::vector<int> frames;    // Frame numbers to compare, ascending
+    int tolerance;              // Largest allowed per-channel difference
+    bool update;                // Write references instead of comparing
+
+    GoldenCheck() : tolerance(0), update(false) {}
+};
+
+static bool WritePPM(const std::string &path, int width, int height, const uint8_t *rgb) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    const size_t size = width * height * 3;
+    bool ok = fwrite(rgb, 1, size, f) == size;
+    ok = (fclose(f) == 0) && ok;
+    return ok;
+}
+
+static bool ReadPPM(const std::string &path, int *width, int *height, std::vector<uint8_t> *rgb) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int max_value;
+    bool ok = fscanf(f, "P6 %d %d %d", width, height, &max_value) == 3 &&
+              max_value == 255 && fgetc(f) != EOF && *width > 0 && *height > 0;
+    if (ok) {
+        rgb->resize(*width * *height * 3);
+        ok = fread(&(*rgb)[0], 1, rgb->size(), f) == rgb->size();
+    }
+    fclose(f);
+    return ok;
+}
+
+// Compares one rendered frame with its reference. Returns the largest
+// channel difference, or -1 if there is no usable reference; writes the
+// actual and diff images when it is over the tolerance.
+static int CompareGolden(const GoldenCheck &golden, const std::string &base,
+                         int width, int height, const uint8_t *rgb) {
+    int ref_width, ref_height;
+    std::vector<uint8_t> reference;
+    if (!ReadPPM(base + ".ppm", &ref_width, &ref_height, &reference) ||
+        ref_width != width || ref_height != height) {
+        fprintf(stderr, "scenebench: no %dx%d reference %s.ppm\n", width, height, base.c_str());
+        WritePPM(base + ".actual.ppm", width, height, rgb);
+        return -1;
+    }
+
+    const int pixels = width * height;
+    std::vector<uint8_t> diff(pixels * 3);
+    int worst = 0;
+    for (int i = 0; i < pixels; i++) {
+        int pixel_worst = 0;
+        for (int c = 0; c < 3; c++) {
+            pixel_worst = std::max(pixel_worst, abs(rgb[i * 3 + c] - reference[i * 3 + c]));
+        }
+        worst = std::max(worst, pixel_worst);
+        const uint8_t gray = (rgb[i * 3] + rgb[i * 3 + 1] + rgb[i * 3 + 2]) / 12;
+        const bool bad = pixel_worst > golden.tolerance;
+        diff[i * 3] = bad ? 255 : gray;
+        diff[i * 3 + 1] = bad ? 0 : gray;
+        diff[i * 3 + 2] = bad ? 0 : gray;
+    }
+    if (worst > golden.tolerance) {
+        WritePPM(base + ".actual.ppm", width, height, rgb);
+        WritePPM(base + ".diff.ppm", width, height, &diff[0]);
+    }
+    return worst;
+}
+
+// Names of all plugins in `dir`, sorted
+static std::vector<std::string> ListPlugins(const std::string &dir) {
+    std::vector<std::string> names;
+    DIR *d = opendir(dir.c_str());
+    if (!d) return names;
+    while (struct dirent *entry = readdir(d)) {
+        const std::string file = entry->d_name;
+        if (file.size() > 3 && file.compare(file.size() - 3, 3, ".so") == 0) {
+            names.push_back(file.substr(0, file.size() - 3));
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Benchmarks one plugin and prints its result line; false if it cannot be
+// loaded or fails its golden frames.
+static bool BenchScene(const std::string &dir, const std::string &name,
+                       int frames, uint32_t seed, float fps, const GoldenCheck &golden) {
+    const std::string path = dir + "/" + name + ".so";
+    void *library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        fprintf(stderr, "scenebench: cannot load %s: %s\n", path.c_str(), dlerror());
+        return false;
+    }
+    CreateSceneFunc create = (CreateSceneFunc)dlsym(library, RGB_SCENE_ENTRY_POINT);
+    Scene *scene = create ? create() : NULL;
+    if (!scene) {
+        fprintf(stderr, "scenebench: %s does not export a scene\n", path.c_str());
+        dlclose(library);
+        return false;
+    }
+
+    const int width = scene->DefaultColumns();
+    const int height = 32;
+    OffscreenCanvas canvas(width, height);
+    scene->SetSeed(seed);
+    scene->Init(width, height);
+
+    if (!golden.dir.empty()) frames = std::max(frames, golden.frames.back() + 1);
+    std::vector<int64_t> times(frames);
+    uint64_t hash = 14695981039346656037ULL;
+    size_t next_golden = 0;
+    int golden_worst = 0;
+    bool golden_failed = false;
+    const uint64_t allocations_before = allocations;
+    for (int i = 0; i < frames; i++) {
+        const int64_t start = MonotonicNanos();
+        scene->Update(i == 0 ? 0.0f : 1.0f / fps);
+        scene->Render(&canvas);
+        times[i] = MonotonicNanos() - start;
+
+        const uint8_t *rgb = canvas.row(0);
+        for (int j = 0; j < width * height * 3; j++) {
+            hash = (hash ^ rgb[j]) * 1099511628211ULL;
+        }
+
+        if (!golden.dir.empty() && next_golden < golden.frames.size() &&
+            golden.frames[next_golden] == i) {
+            // Kept out of the counted allocations
+            const uint64_t allocations_paused = allocations;
+            std::ostringstream base;
+            base << golden.dir << "/" << name << "-" << i;
+            if (golden.update) {
+                if (!WritePPM(base.str() + ".ppm", width, height, rgb)) {
+                    fprintf(stderr, "scenebench: cannot write %s.ppm\n", base.str().c_str());
+                    golden_failed = true;
+                }
+            } else {
+                const int worst = CompareGolden(golden, base.str(), width, height, rgb);
+                if (worst < 0 || worst > golden.tolerance) golden_failed = true;
+                golden_worst = std::max(golden_worst, worst < 0 ? 255 : worst);
+            }
+            next_golden++;
+            allocations = allocations_paused;
+        }
+    }
+    const uint64_t frame_allocations = allocations - allocations_before;
+
+    delete scene;
+    dlclose(library);
+
+    int64_t total = 0;
+    for (int i = 0; i < frames; i++) total += times[i];
+    std::sort(times.begin(), times.end());
+    printf("scene=%s width=%d frames=%d mean_us=%.1f p50_us=%.1f p99_us=%.1f max_us=%.1f "
+           "allocs_per_frame=%.2f hash=%016llx",
+           name.c_str(), width, frames, total / 1e3 / frames,
+           times[frames / 2] / 1e3, times[(frames - 1) * 99 / 100] / 1e3, times[frames - 1] / 1e3,
+           (double)frame_allocations / frames, (unsigned long long)hash);
+    if (!golden.dir.empty()) {
+        const char *result = golden_failed ? "fail" : golden.update ? "updated" : "pass";
+        printf(" golden=%s golden_max_diff=%d", result, golden_worst);
+    }
+    printf("\n");
+    fflush(stdout);
+    return !golden_failed;
+}
+
+int main(int argc, char *argv[]) {
+    std::string plugin_dir = "plugins";
+    int frames = 1000;
+    uint32_t seed = 1;
+    float fps = 20.0f;
+    std::vector<std::string> scenes;
+    GoldenCheck golden;
+    std::string golden_frames = "0,100,1000";
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--plugin-dir" && i + 1 < argc) {
+            plugin_dir = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 0);
+        } else if (arg == "--fps" && i + 1 < argc) {
+            fps = atof(argv[++i]);
+        } else if (arg == "--golden" && i + 1 < argc) {
+            golden.dir = argv[++i];
+        } else if (arg == "--golden-frames" && i + 1 < argc) {
+            golden_frames = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            golden.tolerance = atoi(argv[++i]);
+        } else if (arg == "--update-golden") {
+            golden.update = true;
+        } else if (arg[0] != '-') {
+            scenes.push_back(arg);
+        } else {
+            fprintf(stderr, "usage: %s [--plugin-dir <dir>] [--frames <n>] [--seed <n>] "
+                    "[--fps <n>] [--golden <dir> [--golden-frames <n,n,...>] [--tolerance <n>] "
+                    "[--update-golden]] [scene ...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (frames <= 0 || fps <= 0) {
+        fprintf(stderr, "scenebench: --frames and --fps must be above 0\n");
+        return 1;
+    }
+
+    if (!golden.dir.empty()) {
+        // Strictly increasing frame numbers, so a mistyped list cannot
+        // quietly check fewer frames than it names
+        std::istringstream list(golden_frames);
+        std::string item;
+        bool valid = true;
+        while (valid && std::getline(list, item, ',')) {
+            char *end;
+            const long frame = strtol(item.c_str(), &end, 10);
+            valid = !item.empty() && *end == '\0' && frame >= 0 && frame <= 10000000 &&
+                    (golden.frames.empty() || frame > golden.frames.back());
+            golden.frames.push_back(frame);
+        }
+        if (!valid || golden.frames.empty() || golden_frames[golden_frames.size() - 1] == ',') {
+            fprintf(stderr, "scenebench: invalid --golden-frames '%s' (need increasing frame "
+                    "numbers without repeats)\n", golden_frames.c_str());
+            return 1;
+        }
+    }
+
+    if (scenes.empty()) scenes = ListPlugins(plugin_dir);
+    if (scenes.empty()) {
+        fprintf(stderr, "scenebench: no plugins in %s\n", plugin_dir.c_str());
+        return 1;
+    }
+
+    int failed = 0;
+    for (size_t i = 0; i < scenes.size(); i++) {
+        if (!BenchScene(plugin_dir, scenes[i], frames, seed, fps, golden)) failed++;
+    }
+    return failed ? 1 : 0;
+}
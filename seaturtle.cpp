@@ -1,22 +1,19 @@
 // Sea Turtle Scene - Graceful Ocean Giants
-// Compilation: g++ -o seaturtle seaturtle.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o seaturtle seaturtle.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/seaturtle.so seaturtle.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct SeaTurtle {
     float x;
     float y;
@@ -68,10 +65,9 @@ struct Jellyfish {
     int size;
 };
 
-class SeaTurtleScene {
+class SeaTurtleScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<SeaTurtle> turtles;
     std::vector<Bubble> bubbles;
@@ -80,6 +76,7 @@ private:
     std::vector<SunRay> sun_rays;
     std::vector<Jellyfish> jellyfish;
     float time_counter;
+    SceneRandom rng;
     
     // Ocean colors
     Color ocean_deep = Color(0, 50, 90);
@@ -105,23 +102,24 @@ private:
     Color jellyfish_purple = Color(120, 80, 140);
     
 public:
-    SeaTurtleScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    SeaTurtleScene() : canvas(NULL), width(0), height(0), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "seaturtle");
         
         // Create sea turtles
         for (int i = 0; i < 2; i++) {
             SeaTurtle t;
-            t.x = rand() % width;
-            t.y = 8 + rand() % (int)(height * 0.4);
-            t.speed = 0.15 + (float)rand() / RAND_MAX * 0.1;
-            t.direction = (rand() % 2) * 2 - 1;
-            t.swim_phase = (float)rand() / RAND_MAX * 2 * M_PI;
+            t.x = rng.below(width);
+            t.y = 8 + rng.below((int)(height * 0.4));
+            t.speed = 0.15 + rng.uniform() * 0.1;
+            t.direction = rng.below(2) * 2 - 1;
+            t.swim_phase = rng.uniform() * 2 * M_PI;
             t.flipper_frame = 0;
-            t.size = 2 + (rand() % 2); // Adult or elder
+            t.size = 2 + rng.below(2); // Adult or elder
             t.diving = false;
             t.target_y = t.y;
             turtles.push_back(t);
@@ -143,11 +141,11 @@ public:
         // Create bubbles
         for (int i = 0; i < 20; i++) {
             Bubble b;
-            b.x = rand() % width;
-            b.y = height * 0.5 + rand() % (int)(height * 0.5);
-            b.speed = 0.1 + (float)rand() / RAND_MAX * 0.15;
-            b.drift = ((float)rand() / RAND_MAX - 0.5) * 0.08;
-            b.brightness = 100 + rand() % 80;
+            b.x = rng.below(width);
+            b.y = height * 0.5 + rng.below((int)(height * 0.5));
+            b.speed = 0.1 + rng.uniform() * 0.15;
+            b.drift = (rng.uniform() - 0.5) * 0.08;
+            b.brightness = 100 + rng.below(80);
             bubbles.push_back(b);
         }
         
@@ -158,7 +156,7 @@ public:
             f.y = height * 0.4 + i * 2;
             f.speed = 0.3;
             f.direction = 1;
-            f.color = rand() % 3;
+            f.color = rng.below(3);
             f.school_offset = i * 0.5;
             school.push_back(f);
         }
@@ -166,31 +164,31 @@ public:
         // Create seaweed
         for (int i = 0; i < width / 8; i++) {
             Seaweed s;
-            s.x = 3 + i * 8 + rand() % 4;
+            s.x = 3 + i * 8 + rng.below(4);
             s.y = height - 2;
-            s.height = 5 + rand() % 5;
-            s.sway_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            s.sway_speed = 0.3 + (float)rand() / RAND_MAX * 0.3;
+            s.height = 5 + rng.below(5);
+            s.sway_phase = rng.uniform() * 2 * M_PI;
+            s.sway_speed = 0.3 + rng.uniform() * 0.3;
             seaweed.push_back(s);
         }
         
         // Create sun rays from surface
         for (int i = 0; i < 5; i++) {
             SunRay r;
-            r.x = i * (width / 5) + rand() % 5;
-            r.angle = 0.1 + (float)rand() / RAND_MAX * 0.2;
-            r.length = 10 + rand() % 10;
-            r.brightness = 40 + rand() % 30;
+            r.x = i * (width / 5) + rng.below(5);
+            r.angle = 0.1 + rng.uniform() * 0.2;
+            r.length = 10 + rng.below(10);
+            r.brightness = 40 + rng.below(30);
             sun_rays.push_back(r);
         }
         
         // Add jellyfish
         for (int i = 0; i < 2; i++) {
             Jellyfish j;
-            j.x = rand() % width;
-            j.y = 5 + rand() % 8;
-            j.pulse_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            j.size = 2 + rand() % 2;
+            j.x = rng.below(width);
+            j.y = 5 + rng.below(8);
+            j.pulse_phase = rng.uniform() * 2 * M_PI;
+            j.size = 2 + rng.below(2);
             jellyfish.push_back(j);
         }
     }
@@ -369,7 +367,7 @@ public:
             // Gentle diving motion
             if (abs(turtle.y - turtle.target_y) < 0.5) {
                 // Pick new depth
-                turtle.target_y = 8 + rand() % (int)(height * 0.4);
+                turtle.target_y = 8 + rng.below((int)(height * 0.4));
             } else {
                 // Move towards target depth
                 if (turtle.y < turtle.target_y) {
@@ -414,7 +412,7 @@ public:
             // Reset at top
             if (bubble.y < 0) {
                 bubble.y = height - 5;
-                bubble.x = rand() % width;
+                bubble.x = rng.below(width);
             }
         }
     }
@@ -478,7 +476,8 @@ public:
         }
     }
     
-    void update() {
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawOcean();
@@ -490,47 +489,8 @@ public:
         drawBubbles();
         updateTurtles();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    SeaTurtleScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(SeaTurtleScene)
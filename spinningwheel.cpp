@@ -1,32 +1,28 @@
 // Spinning Progress Wheel - Old School Mac Style
-// Compilation: g++ -o spinningwheel spinningwheel.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o spinningwheel spinningwheel.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/spinningwheel.so spinningwheel.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "hsv.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Segment {
     float angle;
     int hue;
     int brightness;
 };
 
-class SpinningWheelScene {
+class SpinningWheelScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Segment> segments;
     float rotation;
@@ -35,12 +31,11 @@ private:
     int radius;
     
 public:
-    SpinningWheelScene(RGBMatrix *m) : matrix(m), rotation(0), rotation_speed(0.15) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
-        
-        srand(time(NULL));
+    SpinningWheelScene() : canvas(NULL), width(0), height(0), rotation(0), rotation_speed(0.15) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
         // Classic spinning beach ball has segments
         num_segments = 12;
@@ -56,24 +51,6 @@ public:
         }
     }
     
-    void HSVtoRGB(float h, float s, float v, int &r, int &g, int &b) {
-        float c = v * s;
-        float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
-        float m = v - c;
-        
-        float r1, g1, b1;
-        if (h < 60) { r1 = c; g1 = x; b1 = 0; }
-        else if (h < 120) { r1 = x; g1 = c; b1 = 0; }
-        else if (h < 180) { r1 = 0; g1 = c; b1 = x; }
-        else if (h < 240) { r1 = 0; g1 = x; b1 = c; }
-        else if (h < 300) { r1 = x; g1 = 0; b1 = c; }
-        else { r1 = c; g1 = 0; b1 = x; }
-        
-        r = (r1 + m) * 255;
-        g = (g1 + m) * 255;
-        b = (b1 + m) * 255;
-    }
-    
     void drawSpinningWheel() {
         int center_x = width / 2;
         int center_y = height / 2;
@@ -252,7 +229,10 @@ public:
         }
     }
     
-    void update() {
+    float DefaultFps() const { return 33.0f; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         // Clear to dark background
@@ -277,46 +257,7 @@ public:
         if (rotation > 2 * M_PI) {
             rotation -= 2 * M_PI;
         }
-        
-        canvas = matrix->SwapOnVSync(canvas);
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Optimized for 32x32
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    SpinningWheelScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(30000); // ~33 FPS for smooth spinning
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(SpinningWheelScene)
@@ -0,0 +1,151 @@
+// Palette-indexed sprites
+//
+// A SpriteAtlas holds a palette and any number of sprite frames drawn as
+// text rows, one character per pixel: a palette key, or '.' for a
+// transparent pixel.
+//
+//   SpriteAtlas atlas({ {'R', Color(255, 0, 0)}, {'S', Color(255, 200, 150)} });
+//   int standing = atlas.add({ ".RRR.",
+//                              "SSSSS" });
+//   atlas.draw(canvas, standing, x, y, !facing_right);
+//
+// add() compiles each row into runs of opaque pixels once, so drawing only
+// walks the runs: transparent pixels cost nothing, clipping happens once per
+// run rather than per pixel, and there is no character decoding per frame.
+// Frames can be mirrored horizontally and dimmed by a brightness factor
+// (applied to the palette once per draw, for fades).
+//
+// Header only, so plugins can use it without linking librgbscene.
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include "led-matrix.h"
+#include "graphics.h"
+#include <stdint.h>
+#include <string.h>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+class SpriteAtlas {
+private:
+    // Opaque pixels [x, x + length) of one row; their palette indices start
+    // at indices[first]
+    struct Run {
+        int16_t x;
+        int16_t y;
+        int16_t length;
+        uint32_t first;
+    };
+
+    struct Frame {
+        int width;
+        int height;
+        size_t first_run;
+        size_t run_count;
+    };
+
+    std::vector<char> keys;
+    std::vector<rgb_matrix::Color> colors;
+    std::vector<Run> runs;
+    std::vector<uint8_t> indices;
+    std::vector<Frame> frames;
+
+    // Palette index of `key`, or -1 for transparent and unknown keys
+    int lookup(char key) const {
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == key) return i;
+        }
+        return -1;
+    }
+
+public:
+    SpriteAtlas(std::initializer_list<std::pair<char, rgb_matrix::Color> > palette) {
+        for (const std::pair<char, rgb_matrix::Color> &entry : palette) {
+            keys.push_back(entry.first);
+            colors.push_back(entry.second);
+        }
+    }
+
+    // Adds a frame and returns its id. Rows may differ in length; the frame
+    // is as wide as the longest.
+    int add(std::initializer_list<const char *> rows) {
+        Frame frame;
+        frame.width = 0;
+        frame.height = rows.size();
+        frame.first_run = runs.size();
+        int y = 0;
+        for (const char *row : rows) {
+            const int length = strlen(row);
+            if (length > frame.width) frame.width = length;
+            int x = 0;
+            while (x < length) {
+                if (lookup(row[x]) < 0) {
+                    x++;
+                    continue;
+                }
+                Run run;
+                run.x = x;
+                run.y = y;
+                run.first = indices.size();
+                while (x < length && lookup(row[x]) >= 0) {
+                    indices.push_back(lookup(row[x]));
+                    x++;
+                }
+                run.length = x - run.x;
+                runs.push_back(run);
+            }
+            y++;
+        }
+        frame.run_count = runs.size() - frame.first_run;
+        frames.push_back(frame);
+        return frames.size() - 1;
+    }
+
+    int width(int frame) const { return frames[frame].width; }
+    int height(int frame) const { return frames[frame].height; }
+
+    // Draws `frame` with its top-left corner at (x, y), clipped to the
+    // canvas. flip_x mirrors it within its own width.
+    void draw(rgb_matrix::Canvas *canvas, int frame, int x, int y,
+              bool flip_x = false, float brightness = 1.0f) const {
+        const Frame &f = frames[frame];
+        const int canvas_w = canvas->width();
+        const int canvas_h = canvas->height();
+        if (x >= canvas_w || y >= canvas_h || x + f.width <= 0 || y + f.height <= 0) return;
+
+        rgb_matrix::Color shaded[256];
+        for (size_t i = 0; i < colors.size(); i++) {
+            shaded[i] = rgb_matrix::Color((int)(colors[i].r * brightness),
+                                          (int)(colors[i].g * brightness),
+                                          (int)(colors[i].b * brightness));
+        }
+
+        for (size_t r = f.first_run; r < f.first_run + f.run_count; r++) {
+            const Run &run = runs[r];
+            const int py = y + run.y;
+            if (py < 0 || py >= canvas_h) continue;
+
+            // Leftmost pixel of the run on the canvas and the direction its
+            // indices are read in
+            const uint8_t *index = &indices[run.first];
+            int start = x + run.x;
+            int step = 1;
+            if (flip_x) {
+                start = x + f.width - run.x - run.length;
+                index += run.length - 1;
+                step = -1;
+            }
+            int begin = 0, end = run.length;
+            if (start < 0) begin = -start;
+            if (start + end > canvas_w) end = canvas_w - start;
+            for (int i = begin; i < end; i++) {
+                const rgb_matrix::Color &c = shaded[index[i * step]];
+                canvas->SetPixel(start + i, py, c.r, c.g, c.b);
+            }
+        }
+    }
+};
+
+#endif // SPRITE_H
@@ -1,22 +1,20 @@
 // St. Patrick's Day Scene
-// Compilation: g++ -o stpatricksday stpatricksday.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o stpatricksday stpatricksday.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/st_patricks_day.so st_patricks_day.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
+#include "particles.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Shamrock {
     float x;
     float y;
@@ -26,13 +24,6 @@ struct Shamrock {
     int size;
 };
 
-struct Sparkle {
-    int x;
-    int y;
-    int life;
-    int max_life;
-};
-
 struct Coin {
     float x;
     float y;
@@ -40,16 +31,16 @@ struct Coin {
     int brightness;
 };
 
-class StPatricksScene {
+class StPatricksScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Shamrock> shamrocks;
-    std::vector<Sparkle> sparkles;
+    ParticlePool sparkles;
     std::vector<Coin> coins;
     float time_counter;
     int rainbow_phase;
+    SceneRandom rng;
     
     // Colors
     Color green_dark = Color(0, 80, 0);
@@ -64,32 +55,34 @@ private:
     Color black = Color(0, 0, 0);
     
 public:
-    StPatricksScene(RGBMatrix *m) : matrix(m), time_counter(0), rainbow_phase(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    StPatricksScene() : canvas(NULL), width(0), height(0), sparkles(64), time_counter(0),
+                        rainbow_phase(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "st_patricks_day");
         
         // Initialize falling shamrocks
         for (int i = 0; i < 8; i++) {
             Shamrock s;
-            s.x = rand() % width;
-            s.y = -(rand() % height);
-            s.speed = 0.1 + (float)rand() / RAND_MAX * 0.2;
-            s.rotation = (float)rand() / RAND_MAX * 2 * M_PI;
-            s.rot_speed = ((float)rand() / RAND_MAX - 0.5) * 0.1;
-            s.size = 2 + rand() % 2;
+            s.x = rng.below(width);
+            s.y = -(rng.below(height));
+            s.speed = 0.1 + rng.uniform() * 0.2;
+            s.rotation = rng.uniform() * 2 * M_PI;
+            s.rot_speed = (rng.uniform() - 0.5) * 0.1;
+            s.size = 2 + rng.below(2);
             shamrocks.push_back(s);
         }
         
         // Initialize gold coins
         for (int i = 0; i < 5; i++) {
             Coin c;
-            c.x = rand() % width;
-            c.y = height + (rand() % 20);
-            c.speed = 0.05 + (float)rand() / RAND_MAX * 0.1;
-            c.brightness = rand() % 50;
+            c.x = rng.below(width);
+            c.y = height + rng.below(20);
+            c.speed = 0.05 + rng.uniform() * 0.1;
+            c.brightness = rng.below(50);
             coins.push_back(c);
         }
     }
@@ -208,8 +201,8 @@ public:
             
             if (shamrock.y > height + 5) {
                 shamrock.y = -5;
-                shamrock.x = rand() % width;
-                shamrock.speed = 0.1 + (float)rand() / RAND_MAX * 0.2;
+                shamrock.x = rng.below(width);
+                shamrock.speed = 0.1 + rng.uniform() * 0.2;
             }
         }
     }
@@ -245,42 +238,34 @@ public:
             
             if (coin.y < -5) {
                 coin.y = height + 5;
-                coin.x = rand() % width;
+                coin.x = rng.below(width);
             }
         }
     }
     
     void addSparkles() {
         // Randomly add sparkles
-        if (rand() % 10 < 3) {
-            Sparkle s;
-            s.x = rand() % width;
-            s.y = rand() % height;
-            s.life = 0;
-            s.max_life = 10 + rand() % 10;
-            sparkles.push_back(s);
+        if (rng.below(10) < 3) {
+            float x = rng.below(width);
+            float y = rng.below(height);
+            int max_life = 10 + rng.below(10);
+            sparkles.spawn(x, y, 0, 0, max_life, Color(200, 200, 200));
         }
         
         // Update and draw sparkles
-        for (auto it = sparkles.begin(); it != sparkles.end();) {
-            it->life++;
+        sparkles.age(1);
+        for (int i = 0; i < sparkles.count(); i++) {
+            int x = sparkles.x[i];
+            int y = sparkles.y[i];
+            int b = sparkles.r[i] * sparkles.fade(i);
             
-            if (it->life < it->max_life) {
-                float brightness = 1.0 - (float)it->life / it->max_life;
-                int b = 200 * brightness;
-                
-                canvas->SetPixel(it->x, it->y, b, b, b);
-                
-                // Cross sparkle
-                if (it->x > 0) canvas->SetPixel(it->x - 1, it->y, b/2, b/2, b/2);
-                if (it->x < width - 1) canvas->SetPixel(it->x + 1, it->y, b/2, b/2, b/2);
-                if (it->y > 0) canvas->SetPixel(it->x, it->y - 1, b/2, b/2, b/2);
-                if (it->y < height - 1) canvas->SetPixel(it->x, it->y + 1, b/2, b/2, b/2);
-                
-                ++it;
-            } else {
-                it = sparkles.erase(it);
-            }
+            canvas->SetPixel(x, y, b, b, b);
+            
+            // Cross sparkle
+            if (x > 0) canvas->SetPixel(x - 1, y, b/2, b/2, b/2);
+            if (x < width - 1) canvas->SetPixel(x + 1, y, b/2, b/2, b/2);
+            if (y > 0) canvas->SetPixel(x, y - 1, b/2, b/2, b/2);
+            if (y < height - 1) canvas->SetPixel(x, y + 1, b/2, b/2, b/2);
         }
     }
     
@@ -310,7 +295,10 @@ public:
         }
     }
     
-    void update() {
+    int DefaultColumns() const { return 64; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawBackground();
@@ -324,47 +312,8 @@ public:
         drawFallingShamrocks();
         addSparkles();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 64;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    StPatricksScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(StPatricksScene)
@@ -1,22 +1,19 @@
 // Starry Night - Van Gogh Inspired Scene
-// Compilation: g++ -o starrynight starrynight.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o starrynight starrynight.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/starrynight.so starrynight.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 #include <vector>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Star {
     int x;
     int y;
@@ -40,15 +37,25 @@ struct Moon {
     float glow_phase;
 };
 
-class StarryNightScene {
+struct Building {
+    int x;
+    int y;
+    int width;
+    int height;
+    bool is_church;
+};
+
+class StarryNightScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Star> stars;
     std::vector<SkySwirl> swirls;
     Moon moon;
+    std::vector<Building> buildings;
+    CachedLayer village;  // Hills and buildings; only the windows flicker
     float time_counter;
+    SceneRandom rng;
     
     // Van Gogh color palette
     Color sky_deep_blue = Color(20, 40, 100);
@@ -77,22 +84,23 @@ private:
     Color hill_green = Color(50, 80, 60);
     
 public:
-    StarryNightScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    StarryNightScene() : canvas(NULL), width(0), height(0), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "starrynight");
         
         // Create prominent stars
         for (int i = 0; i < 8; i++) {
             Star s;
-            s.x = 3 + rand() % (width - 6);
-            s.y = 2 + rand() % (int)(height * 0.4);
-            s.pulse_phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            s.pulse_speed = 0.5 + (float)rand() / RAND_MAX * 0.5;
-            s.brightness = 180 + rand() % 60;
-            s.size = 2 + (rand() % 3 == 0 ? 1 : 0); // Mostly size 2, some size 3
+            s.x = 3 + rng.below(width - 6);
+            s.y = 2 + rng.below((int)(height * 0.4));
+            s.pulse_phase = rng.uniform() * 2 * M_PI;
+            s.pulse_speed = 0.5 + rng.uniform() * 0.5;
+            s.brightness = 180 + rng.below(60);
+            s.size = 2 + (rng.below(3) == 0 ? 1 : 0); // Mostly size 2, some size 3
             stars.push_back(s);
         }
         
@@ -100,10 +108,10 @@ public:
         for (int i = 0; i < 3; i++) {
             SkySwirl sw;
             sw.center_x = 5 + i * (width / 3);
-            sw.center_y = 5 + rand() % 8;
-            sw.rotation = (float)rand() / RAND_MAX * 2 * M_PI;
-            sw.rotation_speed = 0.02 + (float)rand() / RAND_MAX * 0.02;
-            sw.radius = 4 + rand() % 3;
+            sw.center_y = 5 + rng.below(8);
+            sw.rotation = rng.uniform() * 2 * M_PI;
+            sw.rotation_speed = 0.02 + rng.uniform() * 0.02;
+            sw.radius = 4 + rng.below(3);
             swirls.push_back(sw);
         }
         
@@ -111,6 +119,13 @@ public:
         moon.x = width - 8;
         moon.y = 6;
         moon.glow_phase = 0;
+        
+        // Village buildings
+        int village_y = height * 0.65;
+        buildings.push_back({width / 2 - 6, village_y - 6, 4, 6, true});  // Church with steeple
+        buildings.push_back({width / 2 + 2, village_y - 4, 3, 4, false}); // House
+        buildings.push_back({width / 2 + 7, village_y - 3, 3, 3, false}); // Small house
+        buildings.push_back({width / 2 - 12, village_y - 5, 4, 5, false}); // House on left
     }
     
     void drawSky() {
@@ -309,12 +324,13 @@ public:
         }
         
         // Village buildings
-        drawBuilding(width / 2 - 6, village_y - 6, 4, 6, true);  // Church with steeple
-        drawBuilding(width / 2 + 2, village_y - 4, 3, 4, false); // House
-        drawBuilding(width / 2 + 7, village_y - 3, 3, 3, false); // Small house
-        drawBuilding(width / 2 - 12, village_y - 5, 4, 5, false); // House on left
+        for (auto& building : buildings) {
+            drawBuilding(building.x, building.y, building.width, building.height, building.is_church);
+        }
     }
     
+    // Static part of a building; the lit window is drawn every frame by
+    // drawWindows()
     void drawBuilding(int x, int y, int width_b, int height_b, bool is_church) {
         // Building body
         for (int by = 0; by < height_b; by++) {
@@ -337,19 +353,6 @@ public:
             }
         }
         
-        // Windows (lit)
-        if (height_b >= 3) {
-            int window_x = x + width_b / 2;
-            int window_y = y + height_b - 2;
-            if (window_x >= 0 && window_x < width && window_y < height) {
-                float flicker = sin(time_counter * 3 + x) * 0.2 + 0.8;
-                canvas->SetPixel(window_x, window_y, 
-                               window_yellow.r * flicker,
-                               window_yellow.g * flicker,
-                               window_yellow.b * flicker);
-            }
-        }
-        
         // Church steeple
         if (is_church) {
             for (int s = 0; s < 3; s++) {
@@ -362,57 +365,43 @@ public:
         }
     }
     
-    void update() {
+    void drawWindows() {
+        for (auto& building : buildings) {
+            // Windows (lit)
+            if (building.height >= 3) {
+                int window_x = building.x + building.width / 2;
+                int window_y = building.y + building.height - 2;
+                if (window_x >= 0 && window_x < width && window_y < height) {
+                    float flicker = sin(time_counter * 3 + building.x) * 0.2 + 0.8;
+                    canvas->SetPixel(window_x, window_y, 
+                                   window_yellow.r * flicker,
+                                   window_yellow.g * flicker,
+                                   window_yellow.b * flicker);
+                }
+            }
+        }
+    }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
         drawSkySwirls();
         drawMoon();
         drawStars();
-        drawVillage();
-        drawCypress();
         
-        canvas = matrix->SwapOnVSync(canvas);
+        if (village.needsRedraw(width, height)) {
+            canvas = &village;
+            drawVillage();
+            canvas = c;
+        }
+        village.blit(canvas);
+        drawWindows();
+        drawCypress();
         
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Optimized for 32x32
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    StarryNightScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(StarryNightScene)
@@ -1,40 +1,44 @@
+// STS9 VJ - Kaleidoscope and starfield visuals
+// Compilation: g++ -o sts9_vj sts9_vj.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/sts9_vj.so sts9_vj.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "polarmap.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
-void DrawKaleidoscopeScene(FrameCanvas *canvas, int frame_count) {
+void DrawKaleidoscopeScene(Canvas *canvas, PolarMap &polar, int frame_count) {
     float center_x = 16.0f;
     float center_y = 16.0f;
     float time = frame_count * 0.05f;
     float pulse = sin(time * 2.0f) * 0.5f + 0.5f;  // 0 to 1 pulsing
     float rotation = time * 0.3f;
 
+    // Per-pixel geometry comes from the cache; only the time phases are
+    // computed per frame
+    const float *distances = polar.distance();
+    const float *turns = polar.turn();
+    PolarMap::Wave ripples = polar.radial(0.5f);
+    PolarMap::Wave spokes = polar.angular(6.0f);
+    const float ripple_sin = sin(time * 2.0f), ripple_cos = cos(time * 2.0f);
+    const float spoke_sin = sin(time), spoke_cos = cos(time);
+
     // Draw radial kaleidoscope pattern
     for (int y = 0; y < 32; ++y) {
         for (int x = 0; x < 32; ++x) {
-            float dx = x - center_x;
-            float dy = y - center_y;
-            float distance = sqrt(dx*dx + dy*dy);
-            float angle = atan2(dy, dx);
+            const int i = y * 32 + x;
+            float distance = distances[i];
 
-            // Create rotating spiral pattern
-            float spiral = angle + distance * 0.3f + rotation;
-            float radial_waves = sin(distance * 0.5f - time * 2.0f) * 0.5f + 0.5f;
+            // sin(distance * 0.5 - time * 2)
+            float radial_waves = (ripples.sin[i] * ripple_cos - ripples.cos[i] * ripple_sin) * 0.5f + 0.5f;
 
             // Kaleidoscope effect - mirror across multiple axes
-            float kaleidoscope = sin(angle * 6.0f + time) * 0.5f + 0.5f;
+            // sin(angle * 6 + time)
+            float kaleidoscope = (spokes.sin[i] * spoke_cos + spokes.cos[i] * spoke_sin) * 0.5f + 0.5f;
 
             // Combine patterns
             float intensity = (radial_waves * 0.5f + kaleidoscope * 0.5f);
@@ -51,7 +55,7 @@ void DrawKaleidoscopeScene(FrameCanvas *canvas, int frame_count) {
             if (intensity < 0.0f) intensity = 0.0f;
 
             // Color based on angle and time (psychedelic colors)
-            float hue = fmod(angle / (2.0f * M_PI) + time * 0.2f, 1.0f);
+            float hue = fmod(turns[i] + time * 0.2f, 1.0f);
 
             int r, g, b;
             if (hue < 0.33f) {
@@ -111,7 +115,7 @@ void DrawKaleidoscopeScene(FrameCanvas *canvas, int frame_count) {
     }
 }
 
-void DrawStarfieldScene(FrameCanvas *canvas, int frame_count) {
+void DrawStarfieldScene(Canvas *canvas, PolarMap &polar, int frame_count) {
     // Colors for starfield scene
     Color nebula_base(20, 10, 40);      // Dark purple nebula base
     Color nebula_accent(100, 50, 150);  // Brighter purple accent
@@ -121,16 +125,23 @@ void DrawStarfieldScene(FrameCanvas *canvas, int frame_count) {
     float time = frame_count * 0.05f;
     float pulse = sin(time * 1.5f) * 0.5f + 0.5f;  // Slower pulse for stars
 
+    const float *distances = polar.distance();
+    PolarMap::Wave swirl = polar.angular(4.0f);
+    PolarMap::Wave bands = polar.radial(0.3f);
+    const float swirl_sin = sin(time * 0.8f), swirl_cos = cos(time * 0.8f);
+    const float band_sin = sin(time), band_cos = cos(time);
+
     // Draw nebula background (flowing color gradients)
     for (int y = 0; y < 32; ++y) {
         for (int x = 0; x < 32; ++x) {
-            float dx = x - 16.0f;
-            float dy = y - 16.0f;
-            float distance = sqrt(dx*dx + dy*dy);
-            float angle = atan2(dy, dx);
-
-            // Create swirling nebula effect
-            float nebula_flow = sin(angle * 4.0f + time * 0.8f) * cos(distance * 0.3f - time) * 0.5f + 0.5f;
+            const int i = y * 32 + x;
+            float distance = distances[i];
+
+            // Create swirling nebula effect:
+            // sin(angle * 4 + time * 0.8) * cos(distance * 0.3 - time)
+            float flow_angle = swirl.sin[i] * swirl_cos + swirl.cos[i] * swirl_sin;
+            float flow_radius = bands.cos[i] * band_cos + bands.sin[i] * band_sin;
+            float nebula_flow = flow_angle * flow_radius * 0.5f + 0.5f;
             float intensity = nebula_flow * (1.0f - distance / 25.0f);  // Fade at edges
 
             if (intensity > 1.0f) intensity = 1.0f;
@@ -183,54 +194,36 @@ void DrawStarfieldScene(FrameCanvas *canvas, int frame_count) {
     }
 }
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
+class Sts9VjScene : public Scene {
+private:
+    PolarMap polar;
+    float elapsed;  // Seconds since start; the effects count frames at 20 fps
+
+public:
+    Sts9VjScene() : elapsed(0) {}
+
+    void Init(int width, int height) {
+        polar.build(32, 32, 16.0f, 16.0f);
+    }
+
+    void Update(float dt) {
+        elapsed += dt;
     }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
 
-    int frame_count = 0;
-    int scene = 0; // 0 for kaleidoscope, 1 for starfield
-    const int scene_duration = 200; // ~10 seconds at 20 fps
+    void Render(Canvas *canvas) {
+        const int frame_count = (int)(elapsed * 20.0f);
+        const int scene_duration = 200; // ~10 seconds at 20 fps
 
-    // Display until interrupted
-    while (running) {
         // Clear canvas
         canvas->Clear();
 
-        // Switch scenes every 10 seconds
-        if (frame_count % scene_duration == 0 && frame_count > 0) {
-            scene = (scene + 1) % 2;
-        }
-
-        // Draw appropriate scene
-        if (scene == 0) {
-            DrawKaleidoscopeScene(canvas, frame_count);
+        // Switch between kaleidoscope and starfield every 10 seconds
+        if ((frame_count / scene_duration) % 2 == 0) {
+            DrawKaleidoscopeScene(canvas, polar, frame_count);
         } else {
-            DrawStarfieldScene(canvas, frame_count);
+            DrawStarfieldScene(canvas, polar, frame_count);
         }
-
-        frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(Sts9VjScene)
@@ -1,21 +1,18 @@
 // Summer Beach Scene
-// Compilation: g++ -o summer summer.cpp -lrgbmatrix -std=c++11
+// Compilation: g++ -o summer summer.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/summer.so summer.cpp -lrgbmatrix -std=c++11
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Wave {
     float x;
     float y;
@@ -37,15 +34,15 @@ struct Seagull {
     int frame;
 };
 
-class SummerScene {
+class SummerScene : public Scene {
 private:
-    RGBMatrix *matrix;
-    FrameCanvas *canvas;
+    Canvas *canvas;
     int width, height;
     std::vector<Wave> waves;
     std::vector<Cloud> clouds;
     std::vector<Seagull> seagulls;
     float time_counter;
+    SceneRandom rng;
     
     // Colors - darker and more contrasted
     Color sky_blue = Color(70, 130, 180);
@@ -69,40 +66,41 @@ private:
     Color seagull_gray = Color(100, 100, 100);
     
 public:
-    SummerScene(RGBMatrix *m) : matrix(m), time_counter(0) {
-        canvas = matrix->CreateFrameCanvas();
-        width = canvas->width();
-        height = canvas->height();
+    SummerScene() : canvas(NULL), width(0), height(0), time_counter(0) {}
+    
+    void Init(int w, int h) {
+        width = w;
+        height = h;
         
-        srand(time(NULL));
+        rng.seed(Seed(), "summer");
         
         // Initialize waves
         for (int i = 0; i < 5; i++) {
             Wave w;
-            w.x = rand() % width;
-            w.y = height * 0.6 + (rand() % 10);
-            w.phase = (float)rand() / RAND_MAX * 2 * M_PI;
-            w.amplitude = 2 + rand() % 3;
+            w.x = rng.below(width);
+            w.y = height * 0.6 + rng.below(10);
+            w.phase = rng.uniform() * 2 * M_PI;
+            w.amplitude = 2 + rng.below(3);
             waves.push_back(w);
         }
         
         // Initialize clouds
         for (int i = 0; i < 3; i++) {
             Cloud c;
-            c.x = rand() % width;
-            c.y = 2 + rand() % 8;
-            c.speed = 0.1 + (float)rand() / RAND_MAX * 0.2;
-            c.size = 3 + rand() % 3;
+            c.x = rng.below(width);
+            c.y = 2 + rng.below(8);
+            c.speed = 0.1 + rng.uniform() * 0.2;
+            c.size = 3 + rng.below(3);
             clouds.push_back(c);
         }
         
         // Initialize seagulls
         for (int i = 0; i < 2; i++) {
             Seagull s;
-            s.x = rand() % width;
-            s.y = 8 + rand() % 10;
-            s.speed = 0.3 + (float)rand() / RAND_MAX * 0.3;
-            s.frame = rand() % 4;
+            s.x = rng.below(width);
+            s.y = 8 + rng.below(10);
+            s.speed = 0.3 + rng.uniform() * 0.3;
+            s.frame = rng.below(4);
             seagulls.push_back(s);
         }
     }
@@ -177,7 +175,7 @@ public:
             cloud.x += cloud.speed;
             if (cloud.x > width) {
                 cloud.x = -cloud.size;
-                cloud.y = 2 + rand() % 8;
+                cloud.y = 2 + rng.below(8);
             }
         }
     }
@@ -213,7 +211,7 @@ public:
             wave.x += 0.5;
             if (wave.x > width) {
                 wave.x = 0;
-                wave.y = ocean_start + (rand() % (beach_start - ocean_start));
+                wave.y = ocean_start + rng.below(beach_start - ocean_start);
             }
         }
     }
@@ -225,7 +223,7 @@ public:
         for (int y = beach_start; y < height; y++) {
             for (int x = 0; x < width; x++) {
                 // Add some variation to sand
-                if (rand() % 10 > 7) {
+                if (rng.below(10) > 7) {
                     canvas->SetPixel(x, y, sand_dark.r, sand_dark.g, sand_dark.b);
                 } else {
                     canvas->SetPixel(x, y, sand_light.r, sand_light.g, sand_light.b);
@@ -289,12 +287,15 @@ public:
             
             if (seagull.x > width + 2) {
                 seagull.x = -2;
-                seagull.y = 8 + rand() % 10;
+                seagull.y = 8 + rng.below(10);
             }
         }
     }
     
-    void update() {
+    int DefaultColumns() const { return 64; }
+    
+    void Render(Canvas *c) {
+        canvas = c;
         canvas->Clear();
         
         drawSky();
@@ -313,47 +314,8 @@ public:
         
         drawSeagulls();
         
-        canvas = matrix->SwapOnVSync(canvas);
-        
         time_counter += 0.05;
     }
 };
 
-int main(int argc, char *argv[]) {
-    RGBMatrix::Options matrix_options;
-    rgb_matrix::RuntimeOptions runtime_opt;
-    
-    // Default settings
-    matrix_options.rows = 32;
-    matrix_options.cols = 64;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    
-    // Parse flags
-    if (!ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
-        return 1;
-    }
-    
-    // Create matrix
-    RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-    if (matrix == NULL) {
-        return 1;
-    }
-    
-    // Set up interrupt handler
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-    
-    SummerScene scene(matrix);
-    
-    while (!interrupt_received) {
-        scene.update();
-        usleep(50000); // 50ms = ~20 FPS
-    }
-    
-    matrix->Clear();
-    delete matrix;
-    
-    return 0;
-}
+RGB_SCENE_MAIN(SummerScene)
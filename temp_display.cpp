@@ -3,24 +3,29 @@
 
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "fontfile.h"
+#include "textcache.h"
 #include <getopt.h>
-#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <curl/curl.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include <cmath>
 
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-  interrupt_received = true;
-}
-
 // Callback for CURL to write response data
 static size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
   ((std::string*)userp)->append((char*)contents, size * nmemb);
@@ -55,8 +60,22 @@ bool ParseWeatherJson(const std::string &json, double &temp_c, std::string &cond
   return true;
 }
 
-// Fetch temperature from OpenWeatherMap API
-bool FetchTemperature(const std::string &api_key, double &temp_c, std::string &condition) {
+// Centennial, CO coordinates: 39.5794, -104.8772
+static std::string OpenWeatherMapUrl(const std::string &api_key) {
+  return "https://api.openweathermap.org/data/2.5/weather?lat=39.5794&lon=-104.8772&appid=" +
+         api_key + "&units=metric";
+}
+
+// CURL progress callback: a non-zero return aborts the transfer, so a
+// shutdown does not wait out the timeout
+static int AbortTransferCallback(void *stopping, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+  return static_cast<std::atomic<bool>*>(stopping)->load() ? 1 : 0;
+}
+
+// Fetch temperature from the weather API at `url` (OpenWeatherMap, or any
+// URL curl reads serving the same JSON, e.g. file:// or a local server)
+bool FetchTemperature(const std::string &url, double &temp_c, std::string &condition,
+                      std::atomic<bool> *stopping) {
   CURL *curl;
   CURLcode res;
   std::string readBuffer;
@@ -64,14 +83,14 @@ bool FetchTemperature(const std::string &api_key, double &temp_c, std::string &c
 
   curl = curl_easy_init();
   if(curl) {
-    // Centennial, CO coordinates: 39.5794, -104.8772
-    std::string url = "https://api.openweathermap.org/data/2.5/weather?lat=39.5794&lon=-104.8772&appid=" + 
-                      api_key + "&units=metric";
-    
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);  // Not on the main thread
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, AbortTransferCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, stopping);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
     
     res = curl_easy_perform(curl);
     
@@ -83,12 +102,89 @@ bool FetchTemperature(const std::string &api_key, double &temp_c, std::string &c
   return success;
 }
 
+// First delay before retrying a failed fetch
+static const int kRetryMinSeconds = 15;
+
+// One successful fetch
+struct WeatherReading {
+  double temp_c;
+  std::string condition;
+  time_t fetched_at;
+};
+
+// Fetches the weather on its own thread, so a slow or unreachable API
+// never stalls the render loop. Each new reading is published by swapping
+// it into an atomic pointer, which the render loop swaps out again: neither
+// side ever waits for the other, and a reading the loop has not picked up
+// yet is simply replaced. Failed fetches are retried after kRetryMinSeconds,
+// doubling up to the refresh interval.
+class WeatherFetcher {
+public:
+  WeatherFetcher(const std::string &url, int refresh_seconds)
+    : url_(url), refresh_seconds_(std::max(refresh_seconds, 1)), latest_(NULL),
+      stopping_(false) {}
+
+  ~WeatherFetcher() {
+    Stop();
+    delete latest_.exchange(NULL);
+  }
+
+  void Start() { worker_ = std::thread(&WeatherFetcher::Run, this); }
+
+  // Wakes the worker, aborts a transfer in progress and waits for it
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) worker_.join();
+  }
+
+  // The newest reading since the last call, or NULL
+  WeatherReading *TakeReading() { return latest_.exchange(NULL); }
+
+private:
+  void Run() {
+    int retry_seconds = kRetryMinSeconds;
+    while (!stopping_) {
+      WeatherReading reading;
+      int wait_seconds;
+      if (FetchTemperature(url_, reading.temp_c, reading.condition, &stopping_)) {
+        reading.fetched_at = time(NULL);
+        printf("Temperature: %.1f°C (%.1f°F) - %s\n",
+               reading.temp_c, reading.temp_c * 9.0 / 5.0 + 32.0, reading.condition.c_str());
+        delete latest_.exchange(new WeatherReading(reading));
+        retry_seconds = kRetryMinSeconds;
+        wait_seconds = refresh_seconds_;
+      } else {
+        if (stopping_) break;
+        fprintf(stderr, "Failed to fetch temperature data, retrying in %d s\n", retry_seconds);
+        wait_seconds = retry_seconds;
+        retry_seconds = std::min(retry_seconds * 2, std::max(refresh_seconds_, kRetryMinSeconds));
+      }
+      std::unique_lock<std::mutex> lock(wait_mutex_);
+      wake_.wait_for(lock, std::chrono::seconds(wait_seconds),
+                     [this] { return stopping_.load(); });
+    }
+  }
+
+  const std::string url_;
+  const int refresh_seconds_;
+  std::atomic<WeatherReading*> latest_;
+  std::atomic<bool> stopping_;
+  std::mutex wait_mutex_;         // Only for sleeping between fetches
+  std::condition_variable wake_;
+  std::thread worker_;
+};
+
 static int usage(const char *progname) {
   fprintf(stderr, "usage: %s [options]\n", progname);
   fprintf(stderr, "Displays current temperature for Centennial, CO.\n");
   fprintf(stderr, "Options:\n");
-  fprintf(stderr, "\t-f <font-file>    : Use given BDF font file (e.g., 7x13.bdf).\n");
-  fprintf(stderr, "\t-k <api-key>      : OpenWeatherMap API key (required).\n");
+  fprintf(stderr, "\t-f <font-file>    : Use given BDF or compiled font file (e.g., 7x13.bdf, see fontc).\n");
+  fprintf(stderr, "\t-k <api-key>      : OpenWeatherMap API key (required unless -u is given).\n");
+  fprintf(stderr, "\t-u <url>          : Fetch this URL instead, e.g. file:// or a local server.\n");
   fprintf(stderr, "\t-r <refresh-sec>  : Refresh interval in seconds (default: 600).\n");
   fprintf(stderr, "\t-x <x-origin>     : X-Origin of text (default: 2).\n");
   fprintf(stderr, "\t-y <y-origin>     : Y-Origin of text (default: 0).\n");
@@ -104,7 +200,7 @@ static bool parseColor(Color *c, const char *str) {
   return sscanf(str, "%hhu,%hhu,%hhu", &c->r, &c->g, &c->b) == 3;
 }
 
-void DrawGradientBackground(FrameCanvas *canvas, const Color &start_color, const Color &end_color, int rows) {
+void DrawGradientBackground(Canvas *canvas, const Color &start_color, const Color &end_color, int rows) {
   for (int y = 0; y < rows; ++y) {
     float t = (float)y / (rows - 1);
     uint8_t r = start_color.r + t * (end_color.r - start_color.r);
@@ -117,34 +213,29 @@ void DrawGradientBackground(FrameCanvas *canvas, const Color &start_color, const
 }
 
 int main(int argc, char *argv[]) {
-  RGBMatrix::Options matrix_options;
-  matrix_options.rows = 32;
-  matrix_options.cols = 32;
-  matrix_options.chain_length = 1;
-  matrix_options.parallel = 1;
-  matrix_options.hardware_mapping = "adafruit-hat";
-  rgb_matrix::RuntimeOptions runtime_opt;
-  runtime_opt.gpio_slowdown = 2;
-
-  if (!rgb_matrix::ParseOptionsFromFlags(&argc, &argv, &matrix_options, &runtime_opt)) {
+  SceneRuntime runtime;
+  if (!runtime.Start(&argc, &argv, 32, 1.0f)) { // One frame per second
     return usage(argv[0]);
   }
+  RGBMatrix *matrix = runtime.matrix();
 
   Color text_color(255, 100, 0);
   Color bg_start_color(0, 0, 20);
   Color bg_end_color(0, 20, 40);
   const char *bdf_font_file = NULL;
   std::string api_key = "";
+  std::string weather_url = "";
   int x_orig = 2;
   int y_orig = 0;
   int line_spacing = 1;
   int refresh_interval = 600; // 10 minutes default
 
   int opt;
-  while ((opt = getopt(argc, argv, "f:k:r:x:y:s:C:B:G:")) != -1) {
+  while ((opt = getopt(argc, argv, "f:k:u:r:x:y:s:C:B:G:")) != -1) {
     switch (opt) {
     case 'f': bdf_font_file = strdup(optarg); break;
     case 'k': api_key = optarg; break;
+    case 'u': weather_url = optarg; break;
     case 'r': refresh_interval = atoi(optarg); break;
     case 'x': x_orig = atoi(optarg); break;
     case 'y': y_orig = atoi(optarg); break;
@@ -177,85 +268,109 @@ int main(int argc, char *argv[]) {
     return usage(argv[0]);
   }
 
-  if (api_key.empty()) {
+  if (api_key.empty() && weather_url.empty()) {
     fprintf(stderr, "Need to specify OpenWeatherMap API key with -k\n");
     fprintf(stderr, "Get a free API key at: https://openweathermap.org/api\n");
     return usage(argv[0]);
   }
 
+  // Compiled fonts (see fontc) are mapped instead of parsed
   rgb_matrix::Font font;
-  if (!font.LoadFont(bdf_font_file)) {
+  FontFile compiled_font;
+  const bool compiled = FontFile::IsFontFile(bdf_font_file);
+  if (compiled ? !compiled_font.open(bdf_font_file) : !font.LoadFont(bdf_font_file)) {
     fprintf(stderr, "Couldn't load font '%s'\n", bdf_font_file);
     free((void*)bdf_font_file);
     return 1;
   }
 
-  RGBMatrix *matrix = RGBMatrix::CreateFromOptions(matrix_options, runtime_opt);
-  if (matrix == NULL) {
-    free((void*)bdf_font_file);
-    return 1;
-  }
-
   curl_global_init(CURL_GLOBAL_DEFAULT);
 
   FrameCanvas *offscreen = matrix->CreateFrameCanvas();
   double temp_celsius = 0.0;
   std::string condition = "---";
-  time_t last_fetch = 0;
-  bool first_fetch = true;
+  time_t fetched_at = 0;  // 0 = nothing fetched yet
+  bool stale = false;
 
-  signal(SIGTERM, InterruptHandler);
-  signal(SIGINT, InterruptHandler);
+  // Until the first fetch completes the panel shows placeholders. After
+  // that, a reading older than this many refresh intervals is shown dimmed,
+  // with a red pixel in the top right corner
+  const int kStaleIntervals = 2;
+  const Color stale_text_color(text_color.r / 3, text_color.g / 3, text_color.b / 3);
 
-  while (!interrupt_received) {
-    time_t current_time = time(NULL);
-    
-    // Fetch temperature data at specified interval
-    if (first_fetch || (current_time - last_fetch) >= refresh_interval) {
-      if (FetchTemperature(api_key, temp_celsius, condition)) {
-        last_fetch = current_time;
-        first_fetch = false;
-        printf("Temperature: %.1f°C (%.1f°F) - %s\n", 
-               temp_celsius, temp_celsius * 9.0 / 5.0 + 32.0, condition.c_str());
+  WeatherFetcher fetcher(weather_url.empty() ? OpenWeatherMapUrl(api_key) : weather_url,
+                         refresh_interval);
+  fetcher.Start();
+
+  // The whole picture only changes when new data arrives, so it is drawn
+  // into a cached layer then and copied into each frame buffer once
+  TextCache text = compiled ? TextCache(compiled_font) : TextCache(font);
+  CachedLayer panel;
+  DamageTracker damage;
+  std::vector<DamageTracker::Rect> dirty;
+
+  while (runtime.running()) {
+    std::unique_ptr<WeatherReading> reading(fetcher.TakeReading());
+    if (reading) {
+      temp_celsius = reading->temp_c;
+      condition = reading->condition;
+      fetched_at = reading->fetched_at;
+      panel.invalidate();
+    }
+
+    const bool now_stale = fetched_at != 0 &&
+                           time(NULL) - fetched_at > (time_t)kStaleIntervals * refresh_interval;
+    if (now_stale != stale) {
+      stale = now_stale;
+      panel.invalidate();
+    }
+
+    if (panel.needsRedraw(matrix->width(), matrix->height())) {
+      // Draw gradient background
+      DrawGradientBackground(&panel, bg_start_color, bg_end_color, matrix->height());
+
+      // Convert to Fahrenheit
+      double temp_fahrenheit = temp_celsius * 9.0 / 5.0 + 32.0;
+
+      // Format temperature strings
+      char temp_buffer[32];
+      char condition_buffer[32];
+      if (fetched_at == 0) {
+        snprintf(temp_buffer, sizeof(temp_buffer), "-- F");
       } else {
-        fprintf(stderr, "Failed to fetch temperature data\n");
+        snprintf(temp_buffer, sizeof(temp_buffer), "%.0f F", temp_fahrenheit);
       }
-    }
+      snprintf(condition_buffer, sizeof(condition_buffer), "%s", condition.c_str());
 
-    // Draw gradient background
-    DrawGradientBackground(offscreen, bg_start_color, bg_end_color, matrix->height());
+      const Color &color = stale ? stale_text_color : text_color;
 
-    // Convert to Fahrenheit
-    double temp_fahrenheit = temp_celsius * 9.0 / 5.0 + 32.0;
-    
-    // Format temperature strings
-    char temp_buffer[32];
-    char condition_buffer[32];
-    snprintf(temp_buffer, sizeof(temp_buffer), "%.0f F", temp_fahrenheit);
-    snprintf(condition_buffer, sizeof(condition_buffer), "%s", condition.c_str());
+      // Draw location
+      int y = y_orig + text.baseline();
+      text.draw(&panel, x_orig, y, color, "Cent'l");
 
-    // Draw location
-    int y = y_orig + font.baseline();
-    rgb_matrix::DrawText(offscreen, font, x_orig, y, text_color, NULL, "Cent'l");
+      // Draw temperature
+      y += text.height() + line_spacing;
+      text.draw(&panel, x_orig, y, color, temp_buffer);
 
-    // Draw temperature
-    y += font.height() + line_spacing;
-    rgb_matrix::DrawText(offscreen, font, x_orig, y, text_color, NULL, temp_buffer);
+      // Draw condition
+      y += text.height() + line_spacing;
+      text.draw(&panel, x_orig, y, color, condition_buffer);
 
-    // Draw condition
-    y += font.height() + line_spacing;
-    rgb_matrix::DrawText(offscreen, font, x_orig, y, text_color, NULL, condition_buffer);
+      if (stale) panel.SetPixel(panel.width() - 1, 0, 255, 0, 0);
+
+      damage.markAll();
+    }
 
-    // Update display
-    offscreen = matrix->SwapOnVSync(offscreen);
+    damage.take(offscreen, &dirty);
+    if (!dirty.empty()) panel.blit(offscreen);
 
-    // Sleep for 1 second
-    sleep(1);
+    // Update display and hold it for the rest of the second
+    offscreen = runtime.Present(offscreen);
   }
 
+  fetcher.Stop();
   curl_global_cleanup();
   free((void*)bdf_font_file);
-  delete matrix;
   std::cout << std::endl;
   return 0;
 }
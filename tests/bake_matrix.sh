@@ -0,0 +1,42 @@
+#!/bin/sh
+# Bakes matrix, which starts on a black frame, and checks that baking did not
+# stop at the first repeated frame; then bakes the still link_display and
+# checks it is cut down to the minimum loop length.
+#
+# Usage: tests/bake_matrix.sh   (from the repository root, headless build)
+
+set -e
+repo=$(pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+cd "$work"
+g++ -c -I"$repo/headless" -o headless_matrix.o "$repo/headless/headless_matrix.cpp" -std=c++11
+g++ -c -I"$repo/headless" -o rgbscene.o "$repo/rgbscene.cpp" -std=c++11
+ar rcs libheadless.a headless_matrix.o rgbscene.o
+g++ -I"$repo/headless" -o matrix "$repo/matrix.cpp" -L. -lheadless -std=c++11
+g++ -I"$repo/headless" -o link_display "$repo/link_display.cpp" -L. -lheadless -std=c++11
+
+# frame_count is the little-endian uint32 at offset 16 of the header
+frame_count() {
+    od -A n -t u4 -j 16 -N 4 "$1" | tr -d ' '
+}
+
+fail=0
+check() {
+    if [ "$2" = "$3" ]; then
+        echo "ok   $1: $2 frames"
+    else
+        echo "FAIL $1: $2 frames, expected $3"
+        fail=1
+    fi
+}
+
+./matrix --bake=matrix.frames --seed=1 --bake-seconds=10 2>/dev/null
+check matrix "$(frame_count matrix.frames)" 200
+
+# One still frame, repeated for the 2 s minimum at 20 fps
+./link_display --bake=link_display.frames --seed=1 --bake-seconds=10 2>/dev/null
+check link_display "$(frame_count link_display.frames)" 40
+
+exit $fail
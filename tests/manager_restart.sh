@@ -0,0 +1,49 @@
+#!/bin/sh
+# Runs holiday_manager against a stand-in clockV2grok, kills the program and
+# checks that the manager starts it again.
+#
+# Usage: tests/manager_restart.sh   (from the repository root)
+#
+# Like any manager start, this terminates leftover clockV2grok, temp_display
+# and scene_host processes, so don't run it next to a live panel.
+
+set -e
+repo=$(pwd)
+work=$(mktemp -d)
+manager=
+cleanup() {
+    [ -n "$manager" ] && kill "$manager" 2>/dev/null && wait "$manager" 2>/dev/null
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+g++ -o "$work/holiday_manager" "$repo/holiday_manager.cpp" -std=c++11
+printf '#!/bin/sh\nexec sleep 1000\n' > "$work/clockV2grok"
+chmod +x "$work/clockV2grok"
+
+"$work/holiday_manager" --scripts-path "$work" --restart-backoff 1 > /dev/null &
+manager=$!
+
+# Prints the pid of the manager's child once it differs from $1, polling
+# for up to five seconds
+wait_child() {
+    for i in $(seq 50); do
+        child=$(pgrep -P "$manager" || true)
+        if [ -n "$child" ] && [ "$child" != "$1" ]; then
+            echo "$child"
+            return 0
+        fi
+        sleep 0.1
+    done
+    return 1
+}
+
+first=$(wait_child "") || { echo "FAIL clockV2grok was never started"; exit 1; }
+kill -9 "$first"
+second=$(wait_child "$first") || { echo "FAIL clockV2grok was not restarted after being killed"; cat "$work/holiday_manager.log"; exit 1; }
+
+if ! grep -q "stopped unexpectedly, restarting" "$work/holiday_manager.log"; then
+    echo "FAIL restart not logged"
+    exit 1
+fi
+echo "ok   clockV2grok restarted (pid $first -> $second)"
@@ -0,0 +1,115 @@
+// Pre-rasterized BDF text
+//
+// rgb_matrix::DrawText() decodes the string and walks every glyph's bitmap
+// bit by bit each time it is called. A TextCache rasterizes each glyph the
+// first time it is used into runs of set pixels, and keeps whole laid-out
+// strings as runs too, so drawing text that was drawn before is one
+// SetPixel loop per run:
+//
+//   TextCache text(font, letter_spacing);
+//   text.draw(canvas, x, y + text.baseline(), color, "12:34");
+//
+// draw() takes the same arguments as DrawText() without a background colour
+// and returns the same advance. The font must outlive the cache. Laid-out
+// strings are kept until max_layouts different ones were seen, then the
+// cache starts over, so strings that change every frame cannot grow it.
+//
+// A TextCache can also draw from a compiled FontFile (see fontfile.h).
+// Those glyphs are runs already, so it draws them straight from the mapped
+// file without caching anything, and never allocates.
+//
+// Header only, so plugins can use it without linking librgbscene.
+
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include "led-matrix.h"
+#include "graphics.h"
+#include "fontfile.h"
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class TextCache {
+private:
+    static const size_t max_layouts = 64;
+
+    struct Glyph {
+        int advance;
+        std::vector<GlyphSpan> spans;
+    };
+
+    struct Layout {
+        int width;
+        std::vector<GlyphSpan> spans;
+    };
+
+    const rgb_matrix::Font *bdf;    // Exactly one of these is set
+    const FontFile *compiled;
+    int spacing;
+    std::map<uint32_t, Glyph> glyphs;
+    std::map<std::string, Layout> layouts;
+
+    const Glyph &glyph(uint32_t codepoint) {
+        std::map<uint32_t, Glyph>::iterator it = glyphs.find(codepoint);
+        if (it != glyphs.end()) return it->second;
+
+        Glyph &g = glyphs[codepoint];
+        g.advance = RasterizeGlyph(*bdf, codepoint, &g.spans);
+        return g;
+    }
+
+    const Layout &layout(const char *text) {
+        const std::string key(text);
+        std::map<std::string, Layout>::iterator it = layouts.find(key);
+        if (it != layouts.end()) return it->second;
+
+        if (layouts.size() >= max_layouts) layouts.clear();
+        Layout &l = layouts[key];
+        int pen = 0;
+        while (*text) {
+            const Glyph &g = glyph(NextTextCodepoint(&text));
+            for (size_t i = 0; i < g.spans.size(); i++) {
+                GlyphSpan s = g.spans[i];
+                s.x += pen;
+                l.spans.push_back(s);
+            }
+            pen += g.advance + spacing;
+        }
+        l.width = pen;
+        MergeGlyphSpans(&l.spans);
+        return l;
+    }
+
+public:
+    TextCache(const rgb_matrix::Font &font, int letter_spacing = 0)
+        : bdf(&font), compiled(NULL), spacing(letter_spacing) {}
+    TextCache(const FontFile &font, int letter_spacing = 0)
+        : bdf(NULL), compiled(&font), spacing(letter_spacing) {}
+
+    // Metrics of the underlying font
+    int height() const { return bdf ? bdf->height() : compiled->height(); }
+    int baseline() const { return bdf ? bdf->baseline() : compiled->baseline(); }
+    int characterWidth(uint32_t codepoint) const {
+        return bdf ? bdf->CharacterWidth(codepoint) : compiled->CharacterWidth(codepoint);
+    }
+
+    // Width `text` takes up, as DrawText() would return it
+    int width(const char *text) {
+        if (compiled) return compiled->TextWidth(text, spacing);
+        return layout(text).width;
+    }
+
+    // Draws `text` with its left edge at x and its baseline at y, clipped
+    // to the canvas.
+    int draw(rgb_matrix::Canvas *canvas, int x, int y, const rgb_matrix::Color &color,
+             const char *text) {
+        if (compiled) return compiled->DrawText(canvas, x, y, color, text, spacing);
+        const Layout &l = layout(text);
+        if (!l.spans.empty()) DrawGlyphSpans(canvas, x, y, color, &l.spans[0], l.spans.size());
+        return l.width;
+    }
+};
+
+#endif // TEXTCACHE_H
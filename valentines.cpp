@@ -1,21 +1,18 @@
+// Valentine's Day Scene
+// Compilation: g++ -o valentines valentines.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/valentines.so valentines.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
-#include <signal.h>
 using namespace rgb_matrix;
 
-// Flag to control the main loop
-static volatile bool running = true;
-
-// Signal handler for Ctrl+C
-void handle_interrupt(int sig) {
-    running = false;
-}
-
 struct Petal {
     float x;
     float y;
@@ -96,60 +93,48 @@ void DrawHeart(Canvas *canvas, int cx, int cy, int size, Color color) {
     }
 }
 
-int main() {
-    // Set up signal handler for Ctrl+C
-    signal(SIGINT, handle_interrupt);
-
-    srand(time(NULL));
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class ValentinesScene : public Scene {
+private:
     // Colors
-    Color bg_pink(40, 10, 20);           // Dark pink/purple background
-    Color heart_red(255, 0, 50);         // Bright red heart
-    Color heart_pink(255, 100, 150);     // Pink heart
-    Color heart_white(255, 200, 220);    // White/light pink heart
-    Color petal_pink(255, 150, 180);     // Rose petal pink
-    Color petal_light(255, 200, 220);    // Light petal
-    Color sparkle(255, 255, 255);        // White sparkle
+    Color bg_pink = Color(40, 10, 20);           // Dark pink/purple background
+    Color heart_red = Color(255, 0, 50);         // Bright red heart
+    Color heart_pink = Color(255, 100, 150);     // Pink heart
+    Color heart_white = Color(255, 200, 220);    // White/light pink heart
+    Color petal_pink = Color(255, 150, 180);     // Rose petal pink
+    Color petal_light = Color(255, 200, 220);    // Light petal
+    Color sparkle = Color(255, 255, 255);        // White sparkle
 
     // Initialize falling petals
-    const int num_petals = 15;
+    static const int num_petals = 15;
     Petal petals[num_petals];
-    for (int i = 0; i < num_petals; ++i) {
-        petals[i].x = rand() % 32;
-        petals[i].y = -(rand() % 32);
-        petals[i].speed = 0.1f + (rand() % 8) / 20.0f;
-        petals[i].sway = 0.3f;
-        petals[i].sway_offset = rand() % 360;
-        petals[i].active = true;
-    }
 
     // Sparkle positions (will twinkle around hearts)
-    int sparkle_positions[][2] = {
+    int sparkle_positions[9][2] = {
         {8, 8}, {24, 8}, {16, 20}, {10, 18}, {22, 18},
         {6, 12}, {26, 12}, {14, 24}, {18, 24}
     };
-    int num_sparkles = 9;
+    int num_sparkles;
+
+    int frame_count;
+    SceneRandom rng;
 
-    int frame_count = 0;
+public:
+    ValentinesScene() : num_sparkles(9), frame_count(0) {}
 
-    // Display until interrupted
-    while (running) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "valentines");
+
+        for (int i = 0; i < num_petals; ++i) {
+            petals[i].x = rng.below(32);
+            petals[i].y = -(rng.below(32));
+            petals[i].speed = 0.1f + rng.below(8) / 20.0f;
+            petals[i].sway = 0.3f;
+            petals[i].sway_offset = rng.below(360);
+            petals[i].active = true;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with pink background
         canvas->Fill(bg_pink.r, bg_pink.g, bg_pink.b);
 
@@ -191,9 +176,9 @@ int main() {
                 // Reset if it goes off screen
                 if (petals[i].y >= 32) {
                     petals[i].y = 0;
-                    petals[i].x = rand() % 32;
-                    petals[i].speed = 0.1f + (rand() % 8) / 20.0f;
-                    petals[i].sway_offset = rand() % 360;
+                    petals[i].x = rng.below(32);
+                    petals[i].speed = 0.1f + rng.below(8) / 20.0f;
+                    petals[i].sway_offset = rng.below(360);
                 }
 
                 // Draw petal (small 2x2 or 1x2 shape)
@@ -212,12 +197,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Cleanup
-    delete matrix;
-    std::cout << "Program terminated gracefully." << std::endl;
-    return 0;
-}
+RGB_SCENE_MAIN(ValentinesScene)
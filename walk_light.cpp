@@ -1,5 +1,11 @@
+// Walk Toward the Light Scene
+// Compilation: g++ -o walk_light walk_light.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/walk_light.so walk_light.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
@@ -14,41 +20,33 @@ struct Particle {
     int brightness;
 };
 
-int main() {
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class WalkLightScene : public Scene {
+private:
     // Particles for light rays
-    const int num_particles = 40;
+    static const int num_particles = 40;
     Particle particles[num_particles];
-    for (int i = 0; i < num_particles; ++i) {
-        particles[i].x = 16.0f;
-        particles[i].y = 16.0f;
-        particles[i].vx = (rand() % 200 - 100) / 100.0f;
-        particles[i].vy = (rand() % 200 - 100) / 100.0f;
-        particles[i].lifetime = rand() % 100;
-        particles[i].brightness = 255;
-    }
     
-    int frame_count = 0;
-    float center_x = 16.0f;
-    float center_y = 16.0f;
+    int frame_count;
+    float center_x;
+    float center_y;
+    SceneRandom rng;
+    
+public:
+    WalkLightScene() : frame_count(0), center_x(16.0f), center_y(16.0f) {}
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "walk_light");
+        for (int i = 0; i < num_particles; ++i) {
+            particles[i].x = 16.0f;
+            particles[i].y = 16.0f;
+            particles[i].vx = (rng.below(200) - 100) / 100.0f;
+            particles[i].vy = (rng.below(200) - 100) / 100.0f;
+            particles[i].lifetime = rng.below(100);
+            particles[i].brightness = 255;
+        }
+    }
     
-    // Display continuously
-    while (true) {
+    void Render(Canvas *canvas) {
         float time = frame_count * 0.05f;
         float pulse = sin(time) * 0.5f + 0.5f;
         float breath = sin(time * 0.5f) * 0.5f + 0.5f;
@@ -116,12 +114,12 @@ int main() {
                 particles[i].y = center_y;
                 
                 // Radiate outward in all directions
-                float angle = (rand() % 360) * M_PI / 180.0f;
-                float speed = 0.5f + (rand() % 100) / 100.0f;
+                float angle = rng.below(360) * M_PI / 180.0f;
+                float speed = 0.5f + rng.below(100) / 100.0f;
                 particles[i].vx = cos(angle) * speed;
                 particles[i].vy = sin(angle) * speed;
                 particles[i].lifetime = 0;
-                particles[i].brightness = 200 + rand() % 55;
+                particles[i].brightness = 200 + rng.below(55);
             }
             
             // Move particle
@@ -179,10 +177,7 @@ int main() {
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(WalkLightScene)
@@ -1,17 +1,17 @@
+// Winter Night Scene
+// Compilation: g++ -o winter winter.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/winter.so winter.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <signal.h>
 using namespace rgb_matrix;
 
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
-
 struct Snowflake {
     float x;
     float y;
@@ -19,50 +19,22 @@ struct Snowflake {
     bool active;
 };
 
-int main() {
-    srand(time(NULL));
-
-    // Set up signal handler for graceful exit
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class WinterScene : public Scene {
+private:
     // Colors
-    Color sky(10, 10, 40);           // Dark blue night sky
-    Color ground(240, 240, 255);     // White snow ground
-    Color tree_green(0, 100, 0);     // Dark green for tree
-    Color trunk(101, 67, 33);        // Brown trunk
-    Color snow_white(255, 255, 255); // White snow
-    Color light_red(255, 0, 0);      // Red Christmas lights
-    Color light_green(0, 255, 0);    // Green Christmas lights
-
-    // Initialize snowflakes
-    const int num_snowflakes = 20;
+    Color sky = Color(10, 10, 40);           // Dark blue night sky
+    Color ground = Color(240, 240, 255);     // White snow ground
+    Color tree_green = Color(0, 100, 0);     // Dark green for tree
+    Color trunk = Color(101, 67, 33);        // Brown trunk
+    Color snow_white = Color(255, 255, 255); // White snow
+    Color light_red = Color(255, 0, 0);      // Red Christmas lights
+    Color light_green = Color(0, 255, 0);    // Green Christmas lights
+
+    static const int num_snowflakes = 20;
     Snowflake snowflakes[num_snowflakes];
-    for (int i = 0; i < num_snowflakes; ++i) {
-        snowflakes[i].x = rand() % 32;
-        snowflakes[i].y = -(rand() % 32);  // Start above screen
-        snowflakes[i].speed = 0.1f + (rand() % 10) / 20.0f;  // 0.1 to 0.6
-        snowflakes[i].active = true;
-    }
 
     // Christmas light positions on tree (will alternate red/green)
-    int light_positions[][2] = {
+    int light_positions[15][2] = {
         {16, 8},   // Top
         {14, 11}, {18, 11},  // Second row
         {13, 14}, {16, 14}, {19, 14},  // Third row
@@ -72,10 +44,25 @@ int main() {
     int num_lights = 15;
 
     // Twinkling state
-    int frame_count = 0;
+    int frame_count;
+    SceneRandom rng;
+
+public:
+    WinterScene() : frame_count(0) {}
 
-    // Display continuously
-    while (!interrupt_received) {
+    void Init(int w, int h) {
+        rng.seed(Seed(), "winter");
+
+        // Initialize snowflakes
+        for (int i = 0; i < num_snowflakes; ++i) {
+            snowflakes[i].x = rng.below(32);
+            snowflakes[i].y = -(rng.below(32));  // Start above screen
+            snowflakes[i].speed = 0.1f + rng.below(10) / 20.0f;  // 0.1 to 0.6
+            snowflakes[i].active = true;
+        }
+    }
+
+    void Render(Canvas *canvas) {
         // Clear canvas with night sky
         canvas->Fill(sky.r, sky.g, sky.b);
 
@@ -144,8 +131,8 @@ int main() {
                 // Reset if it goes off screen
                 if (snowflakes[i].y >= 27) {  // Hit the ground
                     snowflakes[i].y = 0;
-                    snowflakes[i].x = rand() % 32;
-                    snowflakes[i].speed = 0.1f + (rand() % 10) / 20.0f;
+                    snowflakes[i].x = rng.below(32);
+                    snowflakes[i].speed = 0.1f + rng.below(10) / 20.0f;
                 }
 
                 // Draw snowflake
@@ -158,15 +145,7 @@ int main() {
         }
 
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Clean up on exit - clear the display
-    canvas->Clear();
-    canvas = matrix->SwapOnVSync(canvas);
-    delete matrix;
-    
-    std::cout << "\nDisplay cleared. Exiting gracefully.\n";
-    return 0;
-}
+RGB_SCENE_MAIN(WinterScene)
@@ -1,5 +1,11 @@
+// Winter Journey Cabin
+// Compilation: g++ -o winter_journey_cabin winter_journey_cabin.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/winter_journey_cabin.so winter_journey_cabin.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
@@ -7,7 +13,7 @@
 #include <ctime>
 using namespace rgb_matrix;
 
-enum Scene {
+enum Stage {
     CABIN_WINDOW,
     TRANSITION_1,
     EVERGREEN_SNOW,
@@ -23,54 +29,48 @@ struct Snowflake {
     bool active;
 };
 
-int main() {
-    srand(time(NULL));
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class WinterJourneyCabinScene : public Scene {
+private:
     // Colors
-    Color cabin_wood(101, 67, 33);
-    Color cabin_dark(70, 45, 20);
-    Color window_frame(80, 60, 40);
-    Color glass_tint(180, 200, 220);
-    Color sky_winter(200, 210, 230);
-    Color ground_snow(240, 245, 255);
-    Color tree_green(40, 100, 60);
-    Color tree_dark(20, 60, 30);
-    Color snow_white(255, 255, 255);
-    Color frost(220, 235, 255);
+    Color cabin_wood = Color(101, 67, 33);
+    Color cabin_dark = Color(70, 45, 20);
+    Color window_frame = Color(80, 60, 40);
+    Color glass_tint = Color(180, 200, 220);
+    Color sky_winter = Color(200, 210, 230);
+    Color ground_snow = Color(240, 245, 255);
+    Color tree_green = Color(40, 100, 60);
+    Color tree_dark = Color(20, 60, 30);
+    Color snow_white = Color(255, 255, 255);
+    Color frost = Color(220, 235, 255);
     
     // Snowflakes
-    const int num_snowflakes = 25;
+    static const int num_snowflakes = 25;
     Snowflake snowflakes[num_snowflakes];
-    for (int i = 0; i < num_snowflakes; ++i) {
-        snowflakes[i].x = rand() % 32;
-        snowflakes[i].y = -(rand() % 32);
-        snowflakes[i].speed = 0.1f + (rand() % 10) / 30.0f;
-        snowflakes[i].size = 1;
-        snowflakes[i].active = true;
-    }
     
-    Scene current_scene = CABIN_WINDOW;
-    int frame_count = 0;
-    int scene_timer = 0;
-    float transition_progress = 0.0f;
+    Stage current_scene;
+    int frame_count;
+    int scene_timer;
+    float transition_progress;
+    SceneRandom rng;
+    
+public:
+    WinterJourneyCabinScene() : current_scene(CABIN_WINDOW), frame_count(0), scene_timer(0),
+                                transition_progress(0.0f) {}
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "winter_journey_cabin");
     
-    while (true) {
+        // Snowflakes
+        for (int i = 0; i < num_snowflakes; ++i) {
+            snowflakes[i].x = rng.below(32);
+            snowflakes[i].y = -rng.below(32);
+            snowflakes[i].speed = 0.1f + rng.below(10) / 30.0f;
+            snowflakes[i].size = 1;
+            snowflakes[i].active = true;
+        }
+    }
+    
+    void Render(Canvas *canvas) {
         scene_timer++;
         
         // Scene timing
@@ -227,8 +227,8 @@ int main() {
             // Frost on window edges
             if ((frame_count / 5) % 2 == 0) {
                 for (int i = 0; i < 5; ++i) {
-                    int fx = 9 + rand() % 2;
-                    int fy = 5 + rand() % 22;
+                    int fx = 9 + rng.below(2);
+                    int fy = 5 + rng.below(22);
                     canvas->SetPixel(fx, fy, (int)(frost.r * alpha), (int)(frost.g * alpha), (int)(frost.b * alpha));
                 }
             }
@@ -469,16 +469,13 @@ int main() {
                 snowflakes[i].y += snowflakes[i].speed;
                 if (snowflakes[i].y > 32) {
                     snowflakes[i].y = 0;
-                    snowflakes[i].x = rand() % 32;
+                    snowflakes[i].x = rng.below(32);
                 }
             }
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(WinterJourneyCabinScene)
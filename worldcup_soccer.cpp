@@ -1,26 +1,23 @@
+// World Cup Soccer Scene
+// Compilation: g++ -o worldcup_soccer worldcup_soccer.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/worldcup_soccer.so worldcup_soccer.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
-#include <chrono>
-#include <signal.h>
 #include <vector>
 #include <cmath>
 
 using namespace rgb_matrix;
-using namespace std::chrono;
-
-volatile bool interrupt_received = false;
-static void InterruptHandler(int signo) {
-    interrupt_received = true;
-}
 
 // Soccer field element structure
 struct SoccerElement {
     float x, y;
     float speed;
     bool active;
-    steady_clock::time_point last_active;
     Color color;
 };
 
@@ -31,8 +28,8 @@ struct GoalEvent {
     bool active;
 };
 
-// Simple circle drawing function (since your example used it)
-void DrawCircle(FrameCanvas *canvas, int x, int y, int radius, Color color) {
+// Filled circle; the library's DrawCircle() only draws the outline
+void DrawFilledCircle(Canvas *canvas, int x, int y, int radius, Color color) {
     for (int i = -radius; i <= radius; ++i) {
         for (int j = -radius; j <= radius; ++j) {
             if (i*i + j*j <= radius*radius) {
@@ -46,75 +43,71 @@ void DrawCircle(FrameCanvas *canvas, int x, int y, int radius, Color color) {
     }
 }
 
-int main() {
-    // Set up signal handler for graceful exit
-    signal(SIGTERM, InterruptHandler);
-    signal(SIGINT, InterruptHandler);
-
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-
+class WorldCupSoccerScene : public Scene {
+private:
     // World Cup colors
-    Color field_green(0, 128, 0);
-    Color white(255, 255, 255);
-    Color team_a_blue(0, 0, 255);    // Team A (blue)
-    Color team_b_yellow(255, 255, 0); // Team B (yellow)
-    Color ball_white(255, 255, 255);
-    Color goal_net(200, 200, 200);
-    Color crowd(30, 144, 255);       // Crowd blue
-    Color trophy_gold(255, 215, 0);
-
+    Color field_green = Color(0, 128, 0);
+    Color white = Color(255, 255, 255);
+    Color team_a_blue = Color(0, 0, 255);    // Team A (blue)
+    Color team_b_yellow = Color(255, 255, 0); // Team B (yellow)
+    Color ball_white = Color(255, 255, 255);
+    Color goal_net = Color(200, 200, 200);
+    Color crowd = Color(30, 144, 255);       // Crowd blue
+    Color trophy_gold = Color(255, 215, 0);
+    
     // Soccer ball position and movement
-    float ball_x = 16.0f, ball_y = 16.0f;
-    float ball_dx = 0.8f, ball_dy = 0.6f;
+    float ball_x, ball_y;
+    float ball_dx, ball_dy;
     
     // Players
     std::vector<SoccerElement> players;
-    for (int i = 0; i < 8; ++i) {
-        SoccerElement player;
-        player.x = rand() % 32;
-        player.y = 8 + (rand() % 16);
-        player.speed = 0.1f + (rand() % 100) / 500.0f;
-        player.active = true;
-        player.color = (i < 4) ? team_a_blue : team_b_yellow;
-        players.push_back(player);
-    }
-
+    
     // Cheering crowd elements
     std::vector<SoccerElement> crowd_effects;
-    for (int i = 0; i < 15; ++i) {
-        SoccerElement effect;
-        effect.x = rand() % 32;
-        effect.y = rand() % 4;  // Top rows for crowd
-        effect.speed = 0.05f + (rand() % 50) / 1000.0f;
-        effect.active = true;
-        effect.color = white;
-        crowd_effects.push_back(effect);
-    }
 
     // Goal event
-    GoalEvent goal = {0, 0, false};
-    int score_team_a = 0, score_team_b = 0;
-    auto last_goal_time = steady_clock::now();
+    GoalEvent goal;
+    int score_team_a, score_team_b;
     
     // Celebration particles
     std::vector<SoccerElement> celebration;
-
-    // Main display loop
-    while (!interrupt_received) {
+    SceneRandom rng;
+    
+public:
+    WorldCupSoccerScene() : ball_x(16.0f), ball_y(16.0f), ball_dx(0.8f), ball_dy(0.6f),
+                          score_team_a(0), score_team_b(0) {
+        goal.x = 0;
+        goal.frame = 0;
+        goal.active = false;
+    }
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "worldcup_soccer");
+    
+        // Players
+        for (int i = 0; i < 8; ++i) {
+            SoccerElement player;
+            player.x = rng.below(32);
+            player.y = 8 + rng.below(16);
+            player.speed = 0.1f + rng.below(100) / 500.0f;
+            player.active = true;
+            player.color = (i < 4) ? team_a_blue : team_b_yellow;
+            players.push_back(player);
+        }
+    
+        // Cheering crowd elements
+        for (int i = 0; i < 15; ++i) {
+            SoccerElement effect;
+            effect.x = rng.below(32);
+            effect.y = rng.below(4);  // Top rows for crowd
+            effect.speed = 0.05f + rng.below(50) / 1000.0f;
+            effect.active = true;
+            effect.color = white;
+            crowd_effects.push_back(effect);
+        }
+    }
+    
+    void Render(Canvas *canvas) {
         canvas->Fill(0, 0, 0);  // Clear canvas
 
         // Draw soccer field
@@ -130,7 +123,7 @@ int main() {
         }
         
         // Draw center circle
-        DrawCircle(canvas, 16, 16, 4, white);
+        DrawFilledCircle(canvas, 16, 16, 4, white);
 
         // Draw goals
         for (int y = 10; y < 22; ++y) {
@@ -167,14 +160,12 @@ int main() {
                 if (ball_x <= 2) score_team_b++;
                 else score_team_a++;
                 
-                last_goal_time = steady_clock::now();
-                
                 // Create celebration particles
                 for (int i = 0; i < 20; ++i) {
                     SoccerElement particle;
                     particle.x = ball_x;
                     particle.y = ball_y;
-                    particle.speed = 0.5f + (rand() % 100) / 200.0f;
+                    particle.speed = 0.5f + rng.below(100) / 200.0f;
                     particle.active = true;
                     particle.color = (ball_x <= 2) ? team_b_yellow : team_a_blue;
                     celebration.push_back(particle);
@@ -183,8 +174,8 @@ int main() {
                 // Reset ball after goal
                 ball_x = 16.0f;
                 ball_y = 16.0f;
-                ball_dx = (rand() % 2 == 0) ? 0.8f : -0.8f;
-                ball_dy = (rand() % 2 == 0) ? 0.6f : -0.6f;
+                ball_dx = (rng.below(2) == 0) ? 0.8f : -0.8f;
+                ball_dy = (rng.below(2) == 0) ? 0.6f : -0.6f;
             }
         }
         if (ball_y <= 6 || ball_y >= 26) {
@@ -198,22 +189,22 @@ int main() {
         if (ball_y > 26) ball_y = 26;
         
         // Draw soccer ball
-        DrawCircle(canvas, (int)ball_x, (int)ball_y, 1, ball_white);
+        DrawFilledCircle(canvas, (int)ball_x, (int)ball_y, 1, ball_white);
 
         // Update and draw players
         for (size_t i = 0; i < players.size(); ++i) {
             SoccerElement& player = players[i];
             
             // Simple AI - move toward ball sometimes
-            if (rand() % 100 < 20) {
+            if (rng.below(100) < 20) {
                 if (player.x < ball_x) player.x += player.speed;
                 else if (player.x > ball_x) player.x -= player.speed;
                 if (player.y < ball_y) player.y += player.speed;
                 else if (player.y > ball_y) player.y -= player.speed;
             } else {
                 // Random movement
-                player.x += (rand() % 3 - 1) * player.speed;
-                player.y += (rand() % 3 - 1) * player.speed;
+                player.x += (rng.below(3) - 1) * player.speed;
+                player.y += (rng.below(3) - 1) * player.speed;
             }
             
             // Keep players on field
@@ -240,7 +231,7 @@ int main() {
         if (goal.active) {
             // Draw expanding circle for goal
             int radius = goal.frame / 2;
-            DrawCircle(canvas, goal.x, 16, radius, white);
+            DrawFilledCircle(canvas, goal.x, 16, radius, white);
             goal.frame++;
             if (goal.frame > 20) {
                 goal.active = false;
@@ -250,8 +241,8 @@ int main() {
         // Update and draw celebration particles (using index to avoid iterator issues)
         for (size_t i = 0; i < celebration.size(); ) {
             SoccerElement& particle = celebration[i];
-            particle.x += (rand() % 5 - 2) * particle.speed;
-            particle.y += (rand() % 5 - 2) * particle.speed;
+            particle.x += (rng.below(5) - 2) * particle.speed;
+            particle.y += (rng.below(5) - 2) * particle.speed;
             
             if (particle.x >= 0 && particle.x < 32 && particle.y >= 0 && particle.y < 32) {
                 canvas->SetPixel((int)particle.x, (int)particle.y, 
@@ -265,15 +256,7 @@ int main() {
         }
 
         // Swap canvas and control frame rate
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
+};
 
-    // Clean up on exit
-    canvas->Clear();
-    canvas = matrix->SwapOnVSync(canvas);
-    delete matrix;
-
-    std::cout << "\nWorld Cup display cleared. Exiting gracefully.\n";
-    return 0;
-}
+RGB_SCENE_MAIN(WorldCupSoccerScene)
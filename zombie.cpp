@@ -1,5 +1,11 @@
+// Zombie Apocalypse Scene
+// Compilation: g++ -o zombie zombie.cpp -L. -lrgbscene -lrgbmatrix -std=c++11
+// Plugin:      g++ -shared -fPIC -DRGB_SCENE_PLUGIN -o plugins/zombie.so zombie.cpp -lrgbmatrix -std=c++11
+
 #include "led-matrix.h"
 #include "graphics.h"
+#include "rgbscene.h"
+#include "random.h"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
@@ -16,57 +22,49 @@ struct Zombie {
     int zombie_type;  // 0, 1, 2 for variety
 };
 
-int main() {
-    srand(time(NULL));
-    
-    // Matrix setup
-    RGBMatrix::Options matrix_options;
-    matrix_options.rows = 32;
-    matrix_options.cols = 32;
-    matrix_options.chain_length = 1;
-    matrix_options.parallel = 1;
-    matrix_options.hardware_mapping = "adafruit-hat";
-    RuntimeOptions rt_opts;
-    rt_opts.gpio_slowdown = 2;
-    RGBMatrix *matrix = CreateMatrixFromOptions(matrix_options, rt_opts);
-    if (!matrix) {
-        std::cerr << "Could not initialize RGB matrix." << std::endl;
-        return 1;
-    }
-    FrameCanvas *canvas = matrix->CreateFrameCanvas();
-    
+class ZombieScene : public Scene {
+private:
     // Colors
-    Color sky_apocalypse(40, 20, 10);   // Orange-red apocalyptic sky
-    Color moon_blood(200, 50, 30);      // Blood red moon
-    Color ground(30, 25, 20);           // Dark ground
-    Color building_dark(50, 50, 50);    // Dark building
-    Color building_light(70, 70, 70);   // Light building
-    Color window_lit(200, 180, 100);    // Lit windows
-    Color window_dark(20, 20, 25);      // Dark windows
-    Color zombie_green(100, 140, 80);   // Zombie flesh
-    Color zombie_dark(60, 90, 50);      // Dark zombie
-    Color zombie_clothes_brown(80, 60, 50);  // Brown clothes
-    Color zombie_clothes_blue(50, 60, 80);   // Blue clothes
-    Color zombie_clothes_gray(70, 70, 70);   // Gray clothes
-    Color blood_red(150, 0, 0);         // Blood stains
+    Color sky_apocalypse = Color(40, 20, 10);   // Orange-red apocalyptic sky
+    Color moon_blood = Color(200, 50, 30);      // Blood red moon
+    Color ground = Color(30, 25, 20);           // Dark ground
+    Color building_dark = Color(50, 50, 50);    // Dark building
+    Color building_light = Color(70, 70, 70);   // Light building
+    Color window_lit = Color(200, 180, 100);    // Lit windows
+    Color window_dark = Color(20, 20, 25);      // Dark windows
+    Color zombie_green = Color(100, 140, 80);   // Zombie flesh
+    Color zombie_dark = Color(60, 90, 50);      // Dark zombie
+    Color zombie_clothes_brown = Color(80, 60, 50);  // Brown clothes
+    Color zombie_clothes_blue = Color(50, 60, 80);   // Blue clothes
+    Color zombie_clothes_gray = Color(70, 70, 70);   // Gray clothes
+    Color blood_red = Color(150, 0, 0);         // Blood stains
     
     // Initialize zombies
-    const int num_zombies = 4;
+    static const int num_zombies = 4;
     Zombie zombies[num_zombies];
-    for (int i = 0; i < num_zombies; ++i) {
-        zombies[i].x = rand() % 32;
-        zombies[i].y = 24;  // Ground level
-        zombies[i].speed = 0.05f + (rand() % 5) / 100.0f;  // Very slow shamble
-        zombies[i].arm_frame = rand() % 20;
-        zombies[i].leg_frame = rand() % 30;
-        zombies[i].active = true;
-        zombies[i].zombie_type = rand() % 3;
-    }
     
-    int frame_count = 0;
+    int frame_count;
+    SceneRandom rng;
+    
+public:
+    ZombieScene() : frame_count(0) {}
+    
+    void Init(int w, int h) {
+        rng.seed(Seed(), "zombie");
     
-    // Display continuously
-    while (true) {
+        // Initialize zombies
+        for (int i = 0; i < num_zombies; ++i) {
+            zombies[i].x = rng.below(32);
+            zombies[i].y = 24;  // Ground level
+            zombies[i].speed = 0.05f + rng.below(5) / 100.0f;  // Very slow shamble
+            zombies[i].arm_frame = rng.below(20);
+            zombies[i].leg_frame = rng.below(30);
+            zombies[i].active = true;
+            zombies[i].zombie_type = rng.below(3);
+        }
+    }
+    
+    void Render(Canvas *canvas) {
         // Clear canvas with apocalyptic sky
         canvas->Fill(sky_apocalypse.r, sky_apocalypse.g, sky_apocalypse.b);
         
@@ -151,7 +149,7 @@ int main() {
                 // Wrap around
                 if (zombies[i].x > 32) {
                     zombies[i].x = -3;
-                    zombies[i].zombie_type = rand() % 3;
+                    zombies[i].zombie_type = rng.below(3);
                 }
                 
                 int zx = (int)zombies[i].x;
@@ -229,10 +227,7 @@ int main() {
         }
         
         frame_count++;
-        canvas = matrix->SwapOnVSync(canvas);
-        usleep(50000);  // ~20 fps
     }
-    
-    delete matrix;
-    return 0;
-}
+};
+
+RGB_SCENE_MAIN(ZombieScene)